@@ -0,0 +1,167 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifdef SEPARATE_CHAINING
+#include "hashtable_separate_chaining.h"
+using separate_chaining::HashTable;
+#else
+#include "hashtable_open_addressing.h"
+using open_addressing::HashTable;
+#endif
+
+// Counts the heap allocations made per insert when the keys are copied
+// into the table, moved into it, or constructed in place with emplace, for
+// long std::string keys and for a large struct that owns heap memory.
+// Also compares string_view lookups with and without the transparent hash.
+// Compile with -DSEPARATE_CHAINING to measure the separate chaining table.
+
+static size_t allocations = 0;
+
+void *operator new(std::size_t size) {
+    allocations++;
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+struct Record {
+    std::string name;
+    std::vector<int> values;
+
+    Record() = default;
+
+    Record(const std::string &name, size_t length) : name(name), values(length, (int) length) {}
+};
+
+bool operator==(const Record &lhs, const Record &rhs) {
+    return lhs.name == rhs.name && lhs.values == rhs.values;
+}
+
+template<>
+struct std::hash<Record> {
+    std::size_t operator()(Record const &r) const noexcept {
+        return std::hash<std::string>{}(r.name);
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Reports the allocations and time of the inserts only, the table is sized
+// up front so that no rehash is counted
+template<class Key, class Insert>
+void run(const char *table_name, const char *key_name, const char *mode, std::vector<Key> keys, Insert insert) {
+    HashTable<Key> table(4 * keys.size() + 1);
+
+    size_t before = allocations;
+    auto start = Clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        insert(table, keys[i], i);
+    }
+    auto end = Clock::now();
+    size_t made = allocations - before;
+
+    double n = (double) keys.size();
+    std::cout << table_name << "," << key_name << "," << mode << "," << keys.size() << ","
+              << (double) made / n << ","
+              << std::chrono::duration<double, std::nano>(end - start).count() / n << std::endl;
+    if (table.size() != keys.size()) {
+        std::cout << table_name << " lost values" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 100000;
+#ifdef SEPARATE_CHAINING
+    const char *name = "separate_chaining";
+#else
+    const char *name = "open_addressing";
+#endif
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+    const size_t RECORD_LENGTH = 16;
+
+    std::vector<std::string> strings;
+    std::vector<Record> records;
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        strings.push_back("/api/v1/session/" + std::to_string(i));
+        records.emplace_back(strings.back(), RECORD_LENGTH);
+    }
+
+    std::cout << "table,key,mode,keys,allocations_per_op,ns_per_op" << std::endl;
+
+    run(name, "string", "copy", strings, [](HashTable<std::string> &table, std::string &key, size_t) {
+        table.insert(key);
+    });
+    run(name, "string", "move", strings, [](HashTable<std::string> &table, std::string &key, size_t) {
+        table.insert(std::move(key));
+    });
+    run(name, "string", "emplace", strings, [](HashTable<std::string> &table, std::string &key, size_t) {
+        table.emplace(key.data(), key.size());
+    });
+
+    run(name, "record", "copy", records, [](HashTable<Record> &table, Record &key, size_t) {
+        table.insert(key);
+    });
+    run(name, "record", "move", records, [](HashTable<Record> &table, Record &key, size_t) {
+        table.insert(std::move(key));
+    });
+    run(name, "record", "emplace", records, [&](HashTable<Record> &table, Record &, size_t i) {
+        table.emplace(strings[i], RECORD_LENGTH);
+    });
+
+    // Returning a filled table from a function
+    HashTable<std::string> filled(4 * NUMBER_OF_KEYS + 1);
+    for (const auto &key : strings) {
+        filled.insert(key);
+    }
+    size_t before = allocations;
+    HashTable<std::string> copied(filled);
+    size_t copy_allocations = allocations - before;
+    before = allocations;
+    HashTable<std::string> moved(std::move(filled));
+    size_t move_allocations = allocations - before;
+    // Lookups with views into a parser buffer, converted to std::string
+    // first or passed straight to the transparent hash
+    HashTable<std::string, StringHash> transparent(4 * NUMBER_OF_KEYS + 1);
+    std::string buffer;
+    for (const auto &key : strings) {
+        transparent.insert(key);
+        buffer += key;
+    }
+    std::vector<std::string_view> views;
+    for (size_t i = 0, offset = 0; i < NUMBER_OF_KEYS; offset += strings[i].size(), i++) {
+        views.push_back(std::string_view(buffer).substr(offset, strings[i].size()));
+    }
+    size_t found = 0;
+    for (int transparent_lookup = 0; transparent_lookup < 2; transparent_lookup++) {
+        before = allocations;
+        auto start = Clock::now();
+        for (auto view : views) {
+            found += transparent_lookup ? transparent.contains(view) : transparent.contains(std::string(view));
+        }
+        auto end = Clock::now();
+        std::cout << name << ",string_view," << (transparent_lookup ? "lookup" : "lookup_converted") << ","
+                  << views.size() << "," << (double) (allocations - before) / (double) views.size() << ","
+                  << std::chrono::duration<double, std::nano>(end - start).count() / (double) views.size()
+                  << std::endl;
+    }
+    if (found != 2 * NUMBER_OF_KEYS) {
+        std::cout << name << " returned wrong lookups" << std::endl;
+    }
+
+    std::cout << name << ",string,table_copy," << copied.size() << "," << copy_allocations << ",0" << std::endl;
+    std::cout << name << ",string,table_move," << moved.size() << "," << move_allocations << ",0" << std::endl;
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef SEPARATE_CHAINING
+#include "hashtable_separate_chaining.h"
+using separate_chaining::HashTable;
+#else
+#include "hashtable_open_addressing.h"
+using open_addressing::HashTable;
+#endif
+
+// Compares contains() called in a loop with contains_batch() on a table
+// much larger than the last level cache, probing random keys so that
+// nearly every lookup misses the cache. Half the probes are in the table.
+// Compile with -DSEPARATE_CHAINING to measure the separate chaining table.
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 8000000;
+    const size_t NUMBER_OF_PROBES = 4000000;
+#ifdef SEPARATE_CHAINING
+    const char *name = "separate_chaining";
+#else
+    const char *name = "open_addressing";
+#endif
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+
+    std::vector<long> keys(NUMBER_OF_KEYS);
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        keys[i] = (long) i * 2;
+    }
+    std::vector<long> probes(NUMBER_OF_PROBES);
+    std::mt19937_64 random(1);
+    for (auto &probe : probes) {
+        probe = (long) (random() % (2 * NUMBER_OF_KEYS));
+    }
+
+    HashTable<long> table(2 * NUMBER_OF_KEYS + 1);
+    auto start = Clock::now();
+    table.insert_batch(keys.data(), keys.size());
+    auto inserted = Clock::now();
+
+    size_t found = 0;
+    for (long probe : probes) {
+        found += table.contains(probe);
+    }
+    auto looped = Clock::now();
+    size_t batch_found = table.contains_batch(probes.data(), probes.size());
+    auto batched = Clock::now();
+
+    auto per_key = [&](Clock::time_point from, Clock::time_point to, size_t n) {
+        return std::chrono::duration<double, std::nano>(to - from).count() / (double) n;
+    };
+    double loop_ns = per_key(inserted, looped, NUMBER_OF_PROBES);
+    double batch_ns = per_key(looped, batched, NUMBER_OF_PROBES);
+    std::cout << "table,keys,probes,insert_batch_ns,contains_ns,contains_batch_ns,speedup" << std::endl;
+    std::cout << name << "," << NUMBER_OF_KEYS << "," << NUMBER_OF_PROBES << ","
+              << per_key(start, inserted, NUMBER_OF_KEYS) << "," << loop_ns << "," << batch_ns << ","
+              << loop_ns / batch_ns << std::endl;
+
+    if (found != batch_found || table.size() != NUMBER_OF_KEYS) {
+        std::cout << name << " returned wrong lookups" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "hashtable_separate_chaining.h"
+
+using separate_chaining::HashTable;
+
+// Builds separate chaining tables of doubling sizes, letting them grow from
+// the default number of buckets, and reports the build time per key. A
+// linear build keeps the time per key roughly flat as the sizes double.
+// The largest size is the first argument, 100000000 for the full run.
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char *argv[]) {
+    const size_t FIRST_KEYS = 1000000;
+    const size_t MAX_KEYS = argc > 1 ? std::stoul(argv[1]) : 8000000;
+
+    std::cout << "keys,buckets,build_s,ns_per_key" << std::endl;
+    for (size_t keys = FIRST_KEYS; keys <= MAX_KEYS; keys *= 2) {
+        HashTable<uint64_t, std::hash<uint64_t>, PowerOfTwoCapacity> table;
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < keys; i++) {
+            table.insert(i * 0x9E3779B97F4A7C15ULL);
+        }
+        auto end = Clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << keys << "," << table.bucket_count() << "," << seconds << "," << seconds * 1e9 / (double) keys
+                  << std::endl;
+
+        if (table.size() != keys) {
+            std::cout << "table lost values" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hashtable_concurrent_chaining.h"
+#include "hashtable_separate_chaining.h"
+
+using separate_chaining::HashTable;
+
+// Throughput of a mixed workload, 90% lookups and 10% writes, from 1 up to
+// 64 threads. The lock striped table is compared with the separate chaining
+// table behind one global mutex, which is how the ingestion workers share
+// a table today. Writes alternate between inserts and removes of random
+// keys, so the tables stay about the same size during a run.
+
+using Clock = std::chrono::steady_clock;
+
+// The separate chaining table with every call serialized by one mutex
+class GlobalLockTable {
+    HashTable<int> table;
+    std::mutex lock;
+
+public:
+    explicit GlobalLockTable(size_t buckets) : table(buckets) {
+    }
+
+    bool insert(int value) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.insert(value);
+    }
+
+    size_t remove(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.remove(key);
+    }
+
+    bool contains(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.contains(key);
+    }
+};
+
+template<class Table>
+void run(const char *name, size_t number_of_keys, size_t operations, unsigned threads) {
+    Table table(number_of_keys);
+    for (size_t i = 0; i < number_of_keys; i++) {
+        table.insert((int) (i * 2));
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<size_t> found(threads, 0);
+    auto start = Clock::now();
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::mt19937_64 random(t + 1);
+            std::uniform_int_distribution<int> keys(0, (int) (number_of_keys * 2));
+            size_t hits = 0;
+            for (size_t i = t; i < operations; i += threads) {
+                int key = keys(random);
+                switch (i % 20) {
+                    case 0:
+                        table.insert(key);
+                        break;
+                    case 10:
+                        table.remove(key);
+                        break;
+                    default:
+                        hits += table.contains(key);
+                }
+            }
+            found[t] = hits;
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    size_t hits = 0;
+    for (size_t h : found) {
+        hits += h;
+    }
+    std::cout << name << "," << threads << "," << operations << "," << (double) operations / seconds / 1e6
+              << "," << (double) hits / (double) operations << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t OPERATIONS = argc > 2 ? std::stoul(argv[2]) : 8000000;
+    const unsigned MAX_THREADS = argc > 3 ? std::stoul(argv[3]) : 64;
+
+    std::cout << "hardware threads " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "table,threads,operations,mops_per_s,hit_rate" << std::endl;
+    for (unsigned threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        run<GlobalLockTable>("global_mutex", NUMBER_OF_KEYS, OPERATIONS, threads);
+        run<ConcurrentHashTable<int>>("lock_striped", NUMBER_OF_KEYS, OPERATIONS, threads);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "hashtable_cuckoo.h"
+#include "hashtable_open_addressing.h"
+#include "hashtable_swiss.h"
+
+using open_addressing::HashTable;
+
+// Compares lookups in the cuckoo table, filled to 95% of its cells, with
+// the linear probe and the swiss table at their own maximum load factors.
+// Each table is sized up front so that it does not grow while filled.
+
+using Clock = std::chrono::steady_clock;
+
+template<class Table>
+void run(const char *name, Table &table, const std::vector<std::string> &present,
+         const std::vector<std::string> &missing) {
+    size_t found = 0;
+
+    auto start = Clock::now();
+    for (const auto &key : present) {
+        table.insert(key);
+    }
+    auto inserted = Clock::now();
+    for (const auto &key : present) {
+        found += table.contains(key);
+    }
+    auto hit = Clock::now();
+    for (const auto &key : missing) {
+        found += table.contains(key);
+    }
+    auto miss = Clock::now();
+
+    auto per_key = [&](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::nano>(to - from).count() / (double) present.size();
+    };
+    std::cout << name << "," << present.size() << "," << table.table_size() << "," << table.load_factor() << ","
+              << per_key(start, inserted) << "," << per_key(inserted, hit) << "," << per_key(hit, miss)
+              << std::endl;
+
+    if (found != present.size()) {
+        std::cout << name << " returned wrong lookups" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t NUMBER_OF_CELLS = argc > 1 ? std::stoul(argv[1]) : 1 << 20;
+    const size_t NUMBER_OF_KEYS = NUMBER_OF_CELLS * 95 / 100;
+
+    std::vector<std::string> present, missing;
+    present.reserve(NUMBER_OF_KEYS);
+    missing.reserve(NUMBER_OF_KEYS);
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        present.push_back("/api/v1/session/" + std::to_string(i * 2));
+        missing.push_back("/api/v1/session/" + std::to_string(i * 2 + 1));
+    }
+
+    std::cout << "table,keys,cells,load_factor,insert_ns,hit_ns,miss_ns" << std::endl;
+    {
+        CuckooHashTable<std::string> table(NUMBER_OF_CELLS);
+        run("cuckoo", table, present, missing);
+        std::cout << "cuckoo stashed " << table.stash_size() << " keys" << std::endl;
+    }
+    {
+        HashTable<std::string> table(2 * NUMBER_OF_KEYS + 1);
+        run("linear_probe", table, present, missing);
+    }
+    {
+        SwissHashTable<std::string> table(NUMBER_OF_KEYS + NUMBER_OF_KEYS / 7 + 1);
+        run("swiss", table, present, missing);
+    }
+    return 0;
+}
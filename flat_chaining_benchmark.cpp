@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "hashtable_flat_chaining.h"
+#include "hashtable_pooled_chaining.h"
+#include "hashtable_separate_chaining.h"
+
+using separate_chaining::HashTable;
+
+// Compares the lookups of the three chaining engines at the same number of
+// buckets and the same load factor: std::list buckets, pooled singly linked
+// nodes, and flat buckets with inline slots. The keys are looked up in a
+// shuffled order so that every lookup starts from a cold bucket.
+
+using Clock = std::chrono::steady_clock;
+
+template<class Table>
+void run(const char *name, const std::vector<uint64_t> &present, const std::vector<uint64_t> &missing,
+         const std::vector<uint64_t> &shuffled) {
+    Table table(present.size());
+    size_t found = 0;
+
+    auto start = Clock::now();
+    for (uint64_t key : present) {
+        table.insert(key);
+    }
+    auto inserted = Clock::now();
+    for (uint64_t key : shuffled) {
+        found += table.contains(key);
+    }
+    auto hit = Clock::now();
+    for (uint64_t key : missing) {
+        found += table.contains(key);
+    }
+    auto miss = Clock::now();
+
+    auto per_key = [&](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::nano>(to - from).count() / (double) present.size();
+    };
+    std::cout << name << "," << present.size() << "," << table.bucket_count() << "," << table.load_factor() << ","
+              << per_key(start, inserted) << "," << per_key(inserted, hit) << "," << per_key(hit, miss) << std::endl;
+
+    if (found != present.size()) {
+        std::cout << name << " returned wrong lookups" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : 2000000;
+
+    std::vector<uint64_t> present, missing;
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        present.push_back(2 * i * 0x9E3779B97F4A7C15ULL);
+        missing.push_back((2 * i + 1) * 0x9E3779B97F4A7C15ULL);
+    }
+    std::vector<uint64_t> shuffled = present;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(1));
+
+    std::cout << "table,keys,buckets,load_factor,insert_ns,hit_ns,miss_ns" << std::endl;
+    run<HashTable<uint64_t>>("list_buckets", present, missing, shuffled);
+    run<PooledHashTable<uint64_t>>("pooled_nodes", present, missing, shuffled);
+    run<FlatHashTable<uint64_t>>("flat_buckets", present, missing, shuffled);
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "hashtable_hash.h"
+#include "hashtable_open_addressing.h"
+#include "hashtable_separate_chaining.h"
+
+// Measures the bundled hashes against std::hash. First the speed of each
+// on integers and on strings of several lengths, in bytes hashed per
+// nanosecond. Then how each spreads sequential integers, random integers
+// and strings with a common prefix over the two tables, as the
+// distribution of probe lengths in the open addressing table (for lookups
+// that hit and lookups that miss, the latter capped at MAX_MISS_PROBE
+// cells) and of chain lengths in the separate chaining table. Pass the
+// number of keys as the first argument.
+
+using Clock = std::chrono::steady_clock;
+
+const size_t MAX_MISS_PROBE = 4096;
+
+// Counts lengths in the ranges 0, 1, 2, 3, 4-7, 8-15, 16-63 and 64 up
+struct Histogram {
+    static constexpr size_t RANGES = 8;
+    size_t counts[RANGES] = {};
+    size_t total = 0;
+    size_t sum = 0;
+    size_t max = 0;
+
+    void add(size_t length) {
+        size_t range = length < 4 ? length : length < 8 ? 4 : length < 16 ? 5 : length < 64 ? 6 : 7;
+        counts[range]++;
+        total++;
+        sum += length;
+        max = std::max(max, length);
+    }
+
+    void print(const char *table, const char *hasher, const char *keys, const char *measure) const {
+        static const char *labels[RANGES] = {"0", "1", "2", "3", "4-7", "8-15", "16-63", "64+"};
+        for (size_t range = 0; range < RANGES; range++) {
+            std::cout << table << "," << hasher << "," << keys << "," << measure << "," << labels[range] << ","
+                      << counts[range] << std::endl;
+        }
+        std::cout << table << "," << hasher << "," << keys << "," << measure << ",mean,"
+                  << (double) sum / (double) total << std::endl;
+        std::cout << table << "," << hasher << "," << keys << "," << measure << ",max," << max << std::endl;
+    }
+};
+
+template<class Hash, class IntegerHash>
+void time_hash(const char *hasher) {
+    const size_t TOTAL_BYTES = 1 << 26;
+    const size_t LENGTHS[] = {8, 16, 32, 64, 256, 1024};
+
+    std::mt19937_64 random(1);
+    std::string text(TOTAL_BYTES + 1024, ' ');
+    for (char &c : text) {
+        c = (char) ('a' + random() % 26);
+    }
+
+    size_t sink = 0;
+    for (size_t length : LENGTHS) {
+        auto start = Clock::now();
+        for (size_t offset = 0; offset < TOTAL_BYTES; offset += length) {
+            sink += Hash{}(std::string_view(text.data() + offset, length));
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::cout << hasher << ",string_" << length << "," << TOTAL_BYTES << "," << (double) TOTAL_BYTES / ns
+                  << std::endl;
+    }
+
+    // The integers are read from the text, so that a hash the compiler can
+    // see through is not folded into a closed form
+    auto start = Clock::now();
+    for (size_t offset = 0; offset < TOTAL_BYTES; offset += sizeof(std::uint64_t)) {
+        sink += IntegerHash{}(read64(reinterpret_cast<const unsigned char *>(text.data()) + offset));
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    std::cout << hasher << ",uint64," << TOTAL_BYTES << "," << (double) TOTAL_BYTES / ns << std::endl;
+
+    if (sink == 1) {
+        std::cout << "unlikely sum of hashes" << std::endl;
+    }
+}
+
+template<class Hash, class Key>
+void spread(const char *hasher, const char *key_name, const std::vector<Key> &keys, const std::vector<Key> &missing) {
+    open_addressing::HashTable<Key, Hash> probed;
+    separate_chaining::HashTable<Key, Hash> chained;
+    for (const Key &key : keys) {
+        probed.insert(key);
+        chained.insert(key);
+    }
+
+    size_t cells = probed.table_size();
+    auto home = [&](const Key &key) {
+        return PrimeCapacity::index(Hash{}(key), cells);
+    };
+
+    Histogram hits;
+    for (const Key &key : keys) {
+        hits.add((probed.position(key) + cells - home(key)) % cells);
+    }
+
+    // A miss probes every cell up to the first empty one
+    auto table = probed.get_table();
+    Histogram misses;
+    for (const Key &key : missing) {
+        size_t index = home(key);
+        size_t length = 0;
+        while (table[index].first != decltype(probed)::EntryType::EMPTY && length < MAX_MISS_PROBE) {
+            index = PrimeCapacity::next(index, cells);
+            length++;
+        }
+        misses.add(length);
+    }
+
+    Histogram chains;
+    for (size_t bucket = 0; bucket < chained.bucket_count(); bucket++) {
+        chains.add(chained.bucket_size(bucket));
+    }
+
+    hits.print("open_addressing", hasher, key_name, "hit_probe");
+    misses.print("open_addressing", hasher, key_name, "miss_probe");
+    chains.print("separate_chaining", hasher, key_name, "chain");
+}
+
+template<class Hash, class StringKeyHash>
+void spread_all(const char *hasher, size_t n) {
+    const size_t NUMBER_OF_MISSES = 10000;
+    std::mt19937_64 random(2);
+
+    std::vector<std::uint64_t> sequential(n);
+    for (size_t i = 0; i < n; i++) {
+        sequential[i] = i;
+    }
+    std::vector<std::uint64_t> random_keys(n);
+    for (auto &key : random_keys) {
+        key = random() | 1;
+    }
+    // Even numbers past the sequential keys, never among the odd random ones
+    std::vector<std::uint64_t> missing(NUMBER_OF_MISSES);
+    for (auto &key : missing) {
+        key = (n + random() % (1ULL << 40)) & ~1ULL;
+    }
+
+    std::vector<std::string> strings(n);
+    char buffer[32];
+    for (size_t i = 0; i < n; i++) {
+        std::snprintf(buffer, sizeof(buffer), "user:%012zu", i);
+        strings[i] = buffer;
+    }
+    std::vector<std::string> missing_strings(NUMBER_OF_MISSES);
+    for (size_t i = 0; i < NUMBER_OF_MISSES; i++) {
+        std::snprintf(buffer, sizeof(buffer), "user:%012zu", n + i * 7919);
+        missing_strings[i] = buffer;
+    }
+
+    spread<Hash>(hasher, "sequential_int", sequential, missing);
+    spread<Hash>(hasher, "random_int", random_keys, missing);
+    spread<StringKeyHash>(hasher, "string", strings, missing_strings);
+}
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 500000;
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+
+    std::cout << "hasher,input,bytes,bytes_per_ns" << std::endl;
+    time_hash<StringHash, std::hash<std::uint64_t>>("std_hash");
+    time_hash<WyHash<>, WyHash<>>("wyhash");
+    time_hash<Xxh3Hash<>, Xxh3Hash<>>("xxh3");
+    time_hash<MurmurHash<>, MurmurHash<>>("murmur");
+
+    std::cout << "table,hasher,keys,measure,length,count" << std::endl;
+    spread_all<std::hash<std::uint64_t>, std::hash<std::string>>("std_hash", NUMBER_OF_KEYS);
+    spread_all<WyHash<>, WyHash<>>("wyhash", NUMBER_OF_KEYS);
+    spread_all<Xxh3Hash<>, Xxh3Hash<>>("xxh3", NUMBER_OF_KEYS);
+    spread_all<MurmurHash<>, MurmurHash<>>("murmur", NUMBER_OF_KEYS);
+    return 0;
+}
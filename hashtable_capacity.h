@@ -0,0 +1,80 @@
+#ifndef HASHTABLE_CAPACITY_H
+#define HASHTABLE_CAPACITY_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Capacity policies decide the number of cells (or buckets) a table may
+// have and how a hash value is reduced to an index. A table takes the
+// policy as a template parameter and only calls its static members, which
+// are all constexpr:
+//
+//   round_up(n)       number of cells to use when n is requested explicitly
+//   next_size(n)      number of cells to grow to when at least n are needed
+//   index(h, n)       home index of hash value h in a table of n cells
+//   next(i, n)        index after i on a linear probe of n cells
+
+//-------------------------------------------------------
+// Any number of cells, grown to prime numbers and reduced with the modulo,
+// which spreads even a poor hash over the table.
+//---------------------------------------------------------
+struct PrimeCapacity {
+    static constexpr bool is_prime(std::size_t num) {
+        for (std::size_t i = 2; i * i <= num; i++)
+            if (num % i == 0) // Factor found
+                return false;
+        return true;
+    }
+
+    static constexpr std::size_t round_up(std::size_t cells) {
+        return cells;
+    }
+
+    static constexpr std::size_t next_size(std::size_t cells) {
+        while (!is_prime(cells)) {
+            cells++;
+        }
+        return cells;
+    }
+
+    static constexpr std::size_t index(std::size_t hash_value, std::size_t cells) {
+        return hash_value % cells;
+    }
+
+    static constexpr std::size_t next(std::size_t index, std::size_t cells) {
+        index++;
+        return index == cells ? 0 : index;
+    }
+};
+
+//-------------------------------------------------------
+// Power of two number of cells. The hash value is multiplied by 2^64 / phi
+// and the top bits are taken as the index (Fibonacci hashing), which mixes
+// weak hashes such as the identity std::hash<int> without a division.
+//---------------------------------------------------------
+struct PowerOfTwoCapacity {
+    static constexpr std::size_t round_up(std::size_t cells) {
+        std::size_t rounded = 1;
+        while (rounded < cells) {
+            rounded *= 2;
+        }
+        return rounded;
+    }
+
+    static constexpr std::size_t next_size(std::size_t cells) {
+        return round_up(cells);
+    }
+
+    static constexpr std::size_t index(std::size_t hash_value, std::size_t cells) {
+        std::uint64_t product = (std::uint64_t) hash_value * 0x9E3779B97F4A7C15ULL;
+        // Shifting by 63 - log2(cells) and then by one more keeps a single
+        // cell table from shifting by the full 64 bits
+        return (std::size_t) ((product >> (63 - __builtin_ctzll(cells))) >> 1);
+    }
+
+    static constexpr std::size_t next(std::size_t index, std::size_t cells) {
+        return (index + 1) & (cells - 1);
+    }
+};
+
+#endif  // HASHTABLE_CAPACITY_H
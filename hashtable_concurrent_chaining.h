@@ -0,0 +1,399 @@
+#ifndef HASHTABLE_CONCURRENT_CHAINING_H
+#define HASHTABLE_CONCURRENT_CHAINING_H
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+// Separate chaining that many threads can use at once. The buckets are
+// guarded by a fixed set of reader/writer locks, the stripes: bucket b is
+// guarded by stripe b % STRIPES. The number of buckets is always a multiple
+// of STRIPES, so a value's stripe depends only on its hash and stays the
+// same when the table grows. Lookups take their stripe shared, inserts and
+// removes take it exclusively, so threads only wait for each other when
+// they touch the same stripe.
+//
+// Growing takes every stripe exclusively. Only the thread whose insert
+// crossed the maximum load factor grows the table; threads that were about
+// to grow the same table find it already grown and return right away.
+template<class Key, class Hash=std::hash<Key>>
+class ConcurrentHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+    using bucket_type = std::list<Key>;
+
+    // Number of locks guarding the buckets
+    static constexpr size_type STRIPES = 64;
+
+private:
+    // Each lock on its own cache line so that threads taking neighboring
+    // stripes do not contend for the line
+    struct alignas(64) Stripe {
+        std::shared_mutex lock;
+    };
+
+    // Only changed while every stripe is held exclusively
+    std::vector<bucket_type> table;
+    std::atomic<size_type> number_of_buckets;
+
+    std::atomic<size_type> count;
+    float maximum_load_factor;
+
+    mutable std::array<Stripe, STRIPES> stripes;
+
+    // Constants
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 1.0f;
+
+    std::shared_mutex &stripe_of(size_type hash_value) const;
+
+    void lock_all() const;
+
+    void unlock_all() const;
+
+    void grow(size_type buckets);
+
+    void relink(size_type buckets);
+
+    static size_type round_buckets(size_type buckets);
+
+public:
+    ConcurrentHashTable();
+
+    ConcurrentHashTable(size_type buckets);
+
+    ConcurrentHashTable(const ConcurrentHashTable &other) = delete;
+
+    ConcurrentHashTable &operator=(const ConcurrentHashTable &other) = delete;
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    size_t bucket_count() const;
+
+    void make_empty();
+
+    bool insert(const value_type &value);
+
+    size_t remove(const key_type &key);
+
+    bool contains(const key_type &key) const;
+
+    bool rehash(size_type buckets);
+
+    float load_factor() const;
+
+    float max_load_factor() const;
+
+    void print_table(std::ostream &os = std::cout) const;
+};
+
+//-------------------------------------------------------
+// Name: ConcurrentHashTable
+// PreCondition:
+// PostCondition: makes an empty table with one bucket per stripe.
+//---------------------------------------------------------
+template<class Key, class Hash>
+ConcurrentHashTable<Key, Hash>::ConcurrentHashTable() : ConcurrentHashTable(STRIPES) {
+}
+
+//-------------------------------------------------------
+// Name: ConcurrentHashTable
+// PreCondition:
+// PostCondition: makes an empty table with at least the specified
+// number of buckets, rounded up to a multiple of
+// STRIPES.
+//---------------------------------------------------------
+template<class Key, class Hash>
+ConcurrentHashTable<Key, Hash>::ConcurrentHashTable(size_type buckets) : count(0) {
+    maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    number_of_buckets = round_buckets(buckets);
+    table.resize(number_of_buckets);
+}
+
+//-------------------------------------------------------
+// Name: round_buckets
+// PreCondition:
+// PostCondition: returns the smallest positive multiple of STRIPES
+// that is at least buckets.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename ConcurrentHashTable<Key, Hash>::size_type ConcurrentHashTable<Key, Hash>::round_buckets(size_type buckets) {
+    return buckets <= STRIPES ? STRIPES : (buckets + STRIPES - 1) / STRIPES * STRIPES;
+}
+
+//-------------------------------------------------------
+// Name: stripe_of
+// PreCondition:
+// PostCondition: returns the lock guarding the bucket of the hash.
+//---------------------------------------------------------
+template<class Key, class Hash>
+std::shared_mutex &ConcurrentHashTable<Key, Hash>::stripe_of(size_type hash_value) const {
+    return stripes[hash_value % STRIPES].lock;
+}
+
+//-------------------------------------------------------
+// Name: lock_all
+// PreCondition:  the calling thread holds no stripe
+// PostCondition: takes every stripe exclusively, always in the same
+// order so that two threads doing so cannot deadlock.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void ConcurrentHashTable<Key, Hash>::lock_all() const {
+    for (Stripe &stripe : stripes) {
+        stripe.lock.lock();
+    }
+}
+
+//-------------------------------------------------------
+// Name: unlock_all
+// PreCondition:  the calling thread holds every stripe
+// PostCondition: releases every stripe.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void ConcurrentHashTable<Key, Hash>::unlock_all() const {
+    for (Stripe &stripe : stripes) {
+        stripe.lock.unlock();
+    }
+}
+
+//-------------------------------------------------------
+// Name: is_empty
+// PreCondition:
+// PostCondition: returns true if the table is empty.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool ConcurrentHashTable<Key, Hash>::is_empty() const {
+    return size() == 0;
+}
+
+//-------------------------------------------------------
+// Name: size
+// PreCondition:
+// PostCondition: returns the number of values in the table. While
+// other threads change the table this is only a
+// snapshot.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t ConcurrentHashTable<Key, Hash>::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------
+// Name: bucket_count
+// PreCondition:
+// PostCondition: returns the number of buckets.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t ConcurrentHashTable<Key, Hash>::bucket_count() const {
+    return number_of_buckets.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------
+// Name: make_empty
+// PreCondition:
+// PostCondition: remove all values from the table. Do not change the
+// number of buckets.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void ConcurrentHashTable<Key, Hash>::make_empty() {
+    lock_all();
+    for (bucket_type &bucket : table) {
+        bucket.clear();
+    }
+    count = 0;
+    unlock_all();
+}
+
+//-------------------------------------------------------
+// Name: insert
+// PreCondition:
+// PostCondition: insert the given value into its bucket while holding
+// only its stripe, then grow the table if the maximum
+// load factor is exceeded. Return true if insert was
+// successful (false if item already exists).
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool ConcurrentHashTable<Key, Hash>::insert(const value_type &value) {
+    size_type hash_value = Hash{}(value);
+    size_type buckets;
+    {
+        std::unique_lock<std::shared_mutex> lock(stripe_of(hash_value));
+        buckets = number_of_buckets.load(std::memory_order_relaxed);
+        bucket_type &bucket = table[hash_value % buckets];
+        for (const Key &stored : bucket) {
+            if (stored == value) {
+                return false;
+            }
+        }
+        bucket.push_back(value);
+    }
+
+    size_type values = count.fetch_add(1, std::memory_order_relaxed) + 1;
+    if ((float) values / (float) buckets > maximum_load_factor) {
+        grow(buckets);
+    }
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: grow
+// PreCondition:  the calling thread holds no stripe
+// PostCondition: doubles the number of buckets, unless another thread
+// has already changed it from the given number.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void ConcurrentHashTable<Key, Hash>::grow(size_type buckets) {
+    lock_all();
+    if (number_of_buckets.load(std::memory_order_relaxed) == buckets) {
+        relink(buckets * 2);
+    }
+    unlock_all();
+}
+
+//-------------------------------------------------------
+// Name: relink
+// PreCondition:  the calling thread holds every stripe, buckets is a
+// multiple of STRIPES
+// PostCondition: moves every node into a new set of buckets without
+// copying the values.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void ConcurrentHashTable<Key, Hash>::relink(size_type buckets) {
+    std::vector<bucket_type> new_table(buckets);
+    for (bucket_type &bucket : table) {
+        while (!bucket.empty()) {
+            bucket_type &target = new_table[Hash{}(bucket.front()) % buckets];
+            target.splice(target.end(), bucket, bucket.begin());
+        }
+    }
+    table.swap(new_table);
+    number_of_buckets.store(buckets, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------
+// Name: remove
+// PreCondition:
+// PostCondition: remove the specified value from the table, return
+// number of elements removed (0 or 1).
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t ConcurrentHashTable<Key, Hash>::remove(const key_type &key) {
+    size_type hash_value = Hash{}(key);
+    std::unique_lock<std::shared_mutex> lock(stripe_of(hash_value));
+    bucket_type &bucket = table[hash_value % number_of_buckets.load(std::memory_order_relaxed)];
+    for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+        if (*it == key) {
+            bucket.erase(it);
+            count.fetch_sub(1, std::memory_order_relaxed);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//-------------------------------------------------------
+// Name: contains
+// PreCondition:
+// PostCondition: returns Boolean true if the specified value is in the
+// table. Other readers of the same stripe are not
+// blocked.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool ConcurrentHashTable<Key, Hash>::contains(const key_type &key) const {
+    size_type hash_value = Hash{}(key);
+    std::shared_lock<std::shared_mutex> lock(stripe_of(hash_value));
+    const bucket_type &bucket = table[hash_value % number_of_buckets.load(std::memory_order_relaxed)];
+    for (const Key &stored : bucket) {
+        if (stored == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//-------------------------------------------------------
+// Name: rehash
+// PreCondition:
+// PostCondition: set the number of buckets to at least the specified
+// value, rounded up to a multiple of STRIPES, and move
+// every value into its new bucket. Returns false if the
+// number of buckets is unchanged or would exceed the
+// maximum load factor.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool ConcurrentHashTable<Key, Hash>::rehash(size_type buckets) {
+    buckets = round_buckets(buckets);
+
+    lock_all();
+    bool changed = buckets != number_of_buckets.load(std::memory_order_relaxed)
+                   && (float) size() / (float) buckets <= maximum_load_factor;
+    if (changed) {
+        relink(buckets);
+    }
+    unlock_all();
+    return changed;
+}
+
+//-------------------------------------------------------
+// Name: load_factor
+// PreCondition:
+// PostCondition: returns the current load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float ConcurrentHashTable<Key, Hash>::load_factor() const {
+    return (float) size() / (float) bucket_count();
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor
+// PreCondition:
+// PostCondition: returns the load factor at which the table grows.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float ConcurrentHashTable<Key, Hash>::max_load_factor() const {
+    return maximum_load_factor;
+}
+
+//-------------------------------------------------------
+// Name: print_table
+// PreCondition:
+// PostCondition: pretty print the table, holding every stripe shared
+// so that it prints one consistent state.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void ConcurrentHashTable<Key, Hash>::print_table(std::ostream &os) const {
+    for (Stripe &stripe : stripes) {
+        stripe.lock.lock_shared();
+    }
+
+    if (size() == 0) {
+        os << "<empty>\n";
+    }
+    for (size_type i = 0; i < table.size(); i++) {
+        if (table[i].empty()) {
+            continue;
+        }
+        os << i << ": [";
+        bool first = true;
+        for (const Key &value : table[i]) {
+            os << (first ? "" : ", ") << value;
+            first = false;
+        }
+        os << "]\n";
+    }
+
+    for (Stripe &stripe : stripes) {
+        stripe.lock.unlock_shared();
+    }
+}
+
+#endif  // HASHTABLE_CONCURRENT_CHAINING_H
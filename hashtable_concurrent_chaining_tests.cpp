@@ -0,0 +1,164 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hashtable_concurrent_chaining.h"
+
+void test_integer_1();
+
+void test_concurrent_insert();
+
+void test_concurrent_mixed();
+
+int main() {
+    test_integer_1();
+    test_concurrent_insert();
+    test_concurrent_mixed();
+    return 0;
+}
+
+void test_integer_1() {
+    const int INITIAL_SIZE = 0;
+    const int INITIAL_BUCKETS = 64;
+    const int NUMBER_OF_INPUTS = 3;
+    const int NUMBER_OF_INPUTS_AFTER_REMOVE = 2;
+    const int VALID_REHASH_VALUE = 100;
+    const int ROUNDED_REHASH_VALUE = 128;
+
+    std::cout << "make an empty concurrent hash table with 64 buckets for ints" << std::endl;
+    ConcurrentHashTable<int> table;
+
+    if (table.size() == INITIAL_SIZE && table.is_empty() && table.bucket_count() == INITIAL_BUCKETS) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed " << std::endl;
+    }
+
+    table.insert(5);
+    table.insert(3);
+    table.insert(69);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(3) && table.contains(5) && !table.contains(4)) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed " << std::endl;
+    }
+
+    if (table.remove(3) == 1 && table.remove(3) == 0 && table.size() == NUMBER_OF_INPUTS_AFTER_REMOVE) {
+        std::cout << "[PASSED] remove test " << std::endl;
+    } else {
+        std::cout << "remove test failed " << std::endl;
+    }
+
+    std::stringstream output;
+    table.print_table(output);
+    if (output.str() == "5: [5, 69]\n") {
+        std::cout << "[PASSED] print table test " << std::endl;
+    } else {
+        std::cout << "print table test failed " << std::endl;
+    }
+
+    if (!table.rehash(INITIAL_BUCKETS) && table.rehash(VALID_REHASH_VALUE)
+        && table.bucket_count() == ROUNDED_REHASH_VALUE && table.contains(5) && table.contains(69)) {
+        std::cout << "[PASSED] rehash test " << std::endl;
+    } else {
+        std::cout << "rehash test failed " << std::endl;
+    }
+
+    table.make_empty();
+    output.str("");
+    table.print_table(output);
+    if (table.is_empty() && output.str() == "<empty>\n" && table.bucket_count() == ROUNDED_REHASH_VALUE) {
+        std::cout << "[PASSED] make empty test " << std::endl;
+    } else {
+        std::cout << "make empty test failed " << std::endl;
+    }
+}
+
+void test_concurrent_insert() {
+    const int NUMBER_OF_THREADS = 8;
+    const int INPUTS_PER_THREAD = 20000;
+
+    std::cout << "insert from several threads into a concurrent hash table" << std::endl;
+    ConcurrentHashTable<std::string> table;
+
+    // Every thread also tries to insert the values of the next one, so
+    // half the inserts are duplicates racing with the original
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUMBER_OF_THREADS; t++) {
+        threads.emplace_back([&table, t]() {
+            for (int n = 0; n < INPUTS_PER_THREAD; n++) {
+                table.insert(std::to_string(t * INPUTS_PER_THREAD + n));
+                table.insert(std::to_string((t + 1) % NUMBER_OF_THREADS * INPUTS_PER_THREAD + n));
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    bool all_found = table.size() == NUMBER_OF_THREADS * INPUTS_PER_THREAD
+                     && table.load_factor() <= table.max_load_factor();
+    for (int n = 0; n < NUMBER_OF_THREADS * INPUTS_PER_THREAD; n++) {
+        all_found = all_found && table.contains(std::to_string(n));
+    }
+
+    if (all_found && !table.contains("-1")) {
+        std::cout << "[PASSED] concurrent insert test " << std::endl;
+    } else {
+        std::cout << "concurrent insert test failed " << std::endl;
+    }
+}
+
+void test_concurrent_mixed() {
+    const int NUMBER_OF_WRITERS = 4;
+    const int NUMBER_OF_READERS = 4;
+    const int INPUTS_PER_THREAD = 20000;
+
+    std::cout << "read while other threads insert and remove" << std::endl;
+    ConcurrentHashTable<int> table;
+
+    // Values below zero are never removed, so readers must always find them
+    // while the table grows around them
+    for (int n = 1; n <= INPUTS_PER_THREAD; n++) {
+        table.insert(-n);
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUMBER_OF_WRITERS; t++) {
+        threads.emplace_back([&table, t]() {
+            for (int n = 0; n < INPUTS_PER_THREAD; n++) {
+                table.insert(t * INPUTS_PER_THREAD + n);
+            }
+            for (int n = 0; n < INPUTS_PER_THREAD; n += 2) {
+                table.remove(t * INPUTS_PER_THREAD + n);
+            }
+        });
+    }
+    std::vector<char> missed(NUMBER_OF_READERS, 0);
+    for (int t = 0; t < NUMBER_OF_READERS; t++) {
+        threads.emplace_back([&table, &missed, t]() {
+            for (int n = 1; n <= INPUTS_PER_THREAD; n++) {
+                missed[t] |= !table.contains(-n);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    bool all_found = table.size() == INPUTS_PER_THREAD + NUMBER_OF_WRITERS * INPUTS_PER_THREAD / 2;
+    for (int n = 0; n < NUMBER_OF_WRITERS * INPUTS_PER_THREAD; n++) {
+        all_found = all_found && table.contains(n) == (n % 2 == 1);
+    }
+    for (char miss : missed) {
+        all_found = all_found && !miss;
+    }
+
+    if (all_found) {
+        std::cout << "[PASSED] concurrent mixed test " << std::endl;
+    } else {
+        std::cout << "concurrent mixed test failed " << std::endl;
+    }
+}
@@ -0,0 +1,641 @@
+#ifndef HASHTABLE_CUCKOO_H
+#define HASHTABLE_CUCKOO_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Bucketized cuckoo hashing. Every value lives in one of the four slots of
+// one of its two buckets, so contains() reads at most two buckets (plus a
+// stash of at most four values that is normally empty). An insert into two
+// full buckets searches breadth first for the shortest chain of values that
+// can each move to their other bucket, ending at a free slot, and shifts the
+// chain along. When no such chain exists within a bounded search the value
+// goes into the stash, and a full stash makes the table grow. With 4-way
+// buckets the table runs at 95% occupancy.
+//
+// Values with equal hashes share both buckets, so at most 2 * SLOTS +
+// STASH_SIZE of them fit, and inserting one more throws std::length_error
+// instead of growing.
+template<class Key, class Hash=std::hash<Key>>
+class CuckooHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+    // Slots per bucket and values the stash can hold
+    static constexpr size_type SLOTS = 4;
+    static constexpr size_type STASH_SIZE = 4;
+
+private:
+    struct Bucket {
+        // Bit i is set when slots[i] holds a value
+        unsigned char used = 0;
+        // Top byte of each value's hash, checked before the value itself
+        std::array<unsigned char, SLOTS> tags;
+        std::array<Key, SLOTS> slots;
+    };
+
+    // The two buckets of a value and its tag
+    struct Location {
+        size_type first;
+        size_type second;
+        unsigned char tag;
+    };
+
+    size_type number_of_buckets;
+    float maximum_load_factor;
+    size_type count;
+
+    std::vector<Bucket> table;
+    std::vector<Key> stash;
+
+    // Constants
+    static constexpr size_type DEFAULT_CELL_SIZE = 16;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.95f;
+    // Buckets the breadth first search may visit before giving up
+    static constexpr size_type MAX_SEARCH = 512;
+
+    static size_type mix(size_type hash_value);
+
+    static size_type round_buckets(size_type cells);
+
+    Location locate(const key_type &key) const;
+
+    size_type find_slot(const Bucket &bucket, unsigned char tag, const key_type &key) const;
+
+    bool find(const Location &location, const key_type &key) const;
+
+    static void store(Bucket &bucket, size_type slot, unsigned char tag, Key &&value);
+
+    bool place(Key &value);
+
+    bool place(Key &value, const Location &location);
+
+    bool place_by_search(Key &value, const Location &location);
+
+    size_type same_hash(const key_type &key, const Location &location) const;
+
+    void resize(size_type buckets);
+
+public:
+    CuckooHashTable();
+
+    CuckooHashTable(size_type cells);
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    size_t table_size() const;
+
+    size_t stash_size() const;
+
+    void make_empty();
+
+    bool insert(const value_type &value);
+
+    bool insert(value_type &&value);
+
+    size_t remove(const key_type &key);
+
+    bool contains(const key_type &key) const;
+
+    bool rehash(size_type count);
+
+    float load_factor() const;
+
+    float max_load_factor() const;
+
+    void max_load_factor(float mlf);
+
+    void print_table(std::ostream &os = std::cout) const;
+};
+
+//-------------------------------------------------------
+// Name: CuckooHashTable
+// PreCondition:
+// PostCondition: makes an empty table with 16 cells (4 buckets).
+//---------------------------------------------------------
+template<class Key, class Hash>
+CuckooHashTable<Key, Hash>::CuckooHashTable() : CuckooHashTable(DEFAULT_CELL_SIZE) {
+}
+
+//-------------------------------------------------------
+// Name: CuckooHashTable
+// PreCondition:  cells is greater than zero
+// PostCondition: makes an empty table with at least the specified
+// number of cells, in a power of two number of buckets
+//---------------------------------------------------------
+template<class Key, class Hash>
+CuckooHashTable<Key, Hash>::CuckooHashTable(size_type cells) {
+    number_of_buckets = round_buckets(cells);
+    maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    count = 0;
+    table.resize(number_of_buckets);
+}
+
+//-------------------------------------------------------
+// Name: is_empty
+// PreCondition:
+// PostCondition: returns true if the table is empty.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::is_empty() const {
+    return count == 0;
+}
+
+//-------------------------------------------------------
+// Name: size
+// PreCondition:
+// PostCondition: returns the number of values in the table, including
+// the stash.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t CuckooHashTable<Key, Hash>::size() const {
+    return count;
+}
+
+//-------------------------------------------------------
+// Name: table_size
+// PreCondition:
+// PostCondition: return the number of cells, four per bucket.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t CuckooHashTable<Key, Hash>::table_size() const {
+    return number_of_buckets * SLOTS;
+}
+
+//-------------------------------------------------------
+// Name: stash_size
+// PreCondition:
+// PostCondition: return the number of values that found no bucket.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t CuckooHashTable<Key, Hash>::stash_size() const {
+    return stash.size();
+}
+
+//-------------------------------------------------------
+// Name: make_empty
+// PreCondition:
+// PostCondition: remove all values from the table. Do not change the
+// number of cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void CuckooHashTable<Key, Hash>::make_empty() {
+    table.assign(number_of_buckets, Bucket());
+    stash.clear();
+    count = 0;
+}
+
+//-------------------------------------------------------
+// Name: mix
+// PreCondition:
+// PostCondition: returns the hash with all bits mixed, so that both
+// bucket choices are usable even for identity hashes.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename CuckooHashTable<Key, Hash>::size_type CuckooHashTable<Key, Hash>::mix(size_type hash_value) {
+    std::uint64_t h = hash_value;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return (size_type) h;
+}
+
+//-------------------------------------------------------
+// Name: round_buckets
+// PreCondition:
+// PostCondition: returns the power of two number of buckets (at least
+// two) that holds the given number of cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename CuckooHashTable<Key, Hash>::size_type CuckooHashTable<Key, Hash>::round_buckets(size_type cells) {
+    size_type buckets = 2;
+    while (buckets * SLOTS < cells) {
+        buckets *= 2;
+    }
+    return buckets;
+}
+
+//-------------------------------------------------------
+// Name: locate
+// PreCondition:
+// PostCondition: returns the two buckets the value may live in and its
+// tag. The second hash is the first one mixed again,
+// and always names a different bucket.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename CuckooHashTable<Key, Hash>::Location CuckooHashTable<Key, Hash>::locate(const key_type &key) const {
+    std::uint64_t first_hash = mix(Hash{}(key));
+    size_type first = first_hash & (number_of_buckets - 1);
+    size_type second = mix(first_hash) & (number_of_buckets - 1);
+    if (second == first) {
+        second = first ^ 1;
+    }
+    return {first, second, (unsigned char) (first_hash >> 56)};
+}
+
+//-------------------------------------------------------
+// Name: find_slot
+// PreCondition:
+// PostCondition: returns the slot of the bucket that holds key, or
+// SLOTS if it is not in the bucket. Keys are only
+// compared in slots with a matching tag.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename CuckooHashTable<Key, Hash>::size_type
+CuckooHashTable<Key, Hash>::find_slot(const Bucket &bucket, unsigned char tag, const key_type &key) const {
+    for (size_type i = 0; i < SLOTS; i++) {
+        if ((bucket.used >> i & 1) && bucket.tags[i] == tag && bucket.slots[i] == key) {
+            return i;
+        }
+    }
+    return SLOTS;
+}
+
+//-------------------------------------------------------
+// Name: find
+// PreCondition:  location is the location of key
+// PostCondition: returns true if key is in one of its buckets or the
+// stash.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::find(const Location &location, const key_type &key) const {
+    if (find_slot(table[location.first], location.tag, key) < SLOTS
+        || find_slot(table[location.second], location.tag, key) < SLOTS) {
+        return true;
+    }
+    for (const Key &stashed : stash) {
+        if (stashed == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//-------------------------------------------------------
+// Name: store
+// PreCondition:  slot is free
+// PostCondition: moves the value into the slot of the bucket.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void CuckooHashTable<Key, Hash>::store(Bucket &bucket, size_type slot, unsigned char tag, Key &&value) {
+    bucket.slots[slot] = std::move(value);
+    bucket.tags[slot] = tag;
+    bucket.used |= 1 << slot;
+}
+
+//-------------------------------------------------------
+// Name: insert
+// PreCondition:
+// PostCondition: insert the given value into one of its buckets, moving
+// other values aside or stashing it when both are full,
+// and grow the table if the maximum load factor is
+// exceeded or the stash overflows. Return true if insert
+// was successful (false if item already exists). Throws
+// std::length_error, leaving the value out, if growing
+// cannot make room for it: when 2 * SLOTS + STASH_SIZE
+// values already share its hash, or when the table
+// already has more buckets than values.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::insert(const value_type &value) {
+    Key copy = value;
+    return insert(std::move(copy));
+}
+
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::insert(value_type &&value) {
+    Location location = locate(value);
+    if (find(location, value)) {
+        return false;
+    }
+
+    if ((float) (count + 1) / (float) table_size() > maximum_load_factor) {
+        resize(number_of_buckets * 2);
+        location = locate(value);
+    }
+
+    while (!place(value, location)) {
+        if (stash.size() < STASH_SIZE) {
+            stash.push_back(std::move(value));
+            break;
+        }
+        if (number_of_buckets > count || same_hash(value, location) >= 2 * SLOTS + STASH_SIZE) {
+            throw std::length_error("CuckooHashTable cannot hold another value with this hash");
+        }
+        resize(number_of_buckets * 2);
+        location = locate(value);
+    }
+    count++;
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: same_hash
+// PreCondition:  location is the location of key
+// PostCondition: returns the number of values in the table with the
+// same hash as key. They can only be in its two buckets
+// or the stash.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename CuckooHashTable<Key, Hash>::size_type
+CuckooHashTable<Key, Hash>::same_hash(const key_type &key, const Location &location) const {
+    size_type hash_value = Hash{}(key);
+    size_type same = 0;
+    for (size_type bucket : {location.first, location.second}) {
+        for (size_type i = 0; i < SLOTS; i++) {
+            same += (table[bucket].used >> i & 1) && Hash{}(table[bucket].slots[i]) == hash_value;
+        }
+    }
+    for (const Key &stashed : stash) {
+        same += Hash{}(stashed) == hash_value;
+    }
+    return same;
+}
+
+//-------------------------------------------------------
+// Name: place
+// PreCondition:  value is not in the table
+// PostCondition: move the value into a free slot of one of its buckets,
+// moving other values to their other bucket if needed.
+// Return false, with value untouched, if no free slot
+// was found.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::place(Key &value) {
+    return place(value, locate(value));
+}
+
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::place(Key &value, const Location &location) {
+    for (size_type b : {location.first, location.second}) {
+        Bucket &bucket = table[b];
+        if (bucket.used != (1 << SLOTS) - 1) {
+            store(bucket, __builtin_ctz(~bucket.used), location.tag, std::move(value));
+            return true;
+        }
+    }
+    return place_by_search(value, location);
+}
+
+//-------------------------------------------------------
+// Name: place_by_search
+// PreCondition:  both buckets of value are full
+// PostCondition: search breadth first from the two buckets for a chain
+// of moves that ends in a free slot, then shift the
+// values along the chain and put value in the first
+// bucket of it. Return false if no chain was found
+// within MAX_SEARCH buckets.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::place_by_search(Key &value, const Location &location) {
+    // Each visited bucket, the step it was reached from and the slot of
+    // that step's bucket whose value would move into it
+    struct Step {
+        size_type bucket;
+        size_type parent;
+        size_type slot;
+    };
+    const size_type ROOT = MAX_SEARCH;
+
+    std::vector<Step> steps;
+    steps.reserve(MAX_SEARCH);
+    steps.push_back({location.first, ROOT, 0});
+    steps.push_back({location.second, ROOT, 0});
+
+    for (size_type next = 0; next < steps.size(); next++) {
+        const Bucket &bucket = table[steps[next].bucket];
+        if (bucket.used != (1 << SLOTS) - 1) {
+            // Shift values toward the free slot, starting at its end
+            size_type to = next;
+            size_type free_slot = __builtin_ctz(~bucket.used);
+            while (steps[to].parent != ROOT) {
+                Bucket &source = table[steps[steps[to].parent].bucket];
+                size_type slot = steps[to].slot;
+                store(table[steps[to].bucket], free_slot, source.tags[slot], std::move(source.slots[slot]));
+                free_slot = slot;
+                to = steps[to].parent;
+            }
+            store(table[steps[to].bucket], free_slot, location.tag, std::move(value));
+            return true;
+        }
+
+        for (size_type slot = 0; slot < SLOTS && steps.size() < MAX_SEARCH; slot++) {
+            Location moved = locate(bucket.slots[slot]);
+            size_type other = moved.first == steps[next].bucket ? moved.second : moved.first;
+            steps.push_back({other, next, slot});
+        }
+    }
+    return false;
+}
+
+//-------------------------------------------------------
+// Name: remove
+// PreCondition:
+// PostCondition: remove the specified value from the table, return
+// number of elements removed (0 or 1). A stashed value
+// that fits in the freed bucket moves there.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t CuckooHashTable<Key, Hash>::remove(const key_type &key) {
+    Location location = locate(key);
+    for (size_type b : {location.first, location.second}) {
+        size_type slot = find_slot(table[b], location.tag, key);
+        if (slot < SLOTS) {
+            table[b].used &= ~(1 << slot);
+            count--;
+
+            for (size_type i = 0; i < stash.size(); i++) {
+                if (place(stash[i])) {
+                    stash.erase(stash.begin() + i);
+                    break;
+                }
+            }
+            return 1;
+        }
+    }
+
+    for (size_type i = 0; i < stash.size(); i++) {
+        if (stash[i] == key) {
+            stash.erase(stash.begin() + i);
+            count--;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//-------------------------------------------------------
+// Name: contains
+// PreCondition:
+// PostCondition: returns true if the specified value is in the table,
+// reading its two buckets and the stash.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::contains(const key_type &key) const {
+    return find(locate(key), key);
+}
+
+//-------------------------------------------------------
+// Name: rehash
+// PreCondition:
+// PostCondition: set the number of cells to at least the specified
+// value, rounded up to a power of two number of buckets,
+// and place every value again. Returns false if the
+// number of cells is unchanged or would exceed the
+// maximum load factor.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool CuckooHashTable<Key, Hash>::rehash(size_type count) {
+    size_type buckets = round_buckets(count);
+
+    if (buckets == number_of_buckets) {
+        return false;
+    }
+
+    if ((float) size() / (float) (buckets * SLOTS) > maximum_load_factor) {
+        return false;
+    }
+
+    resize(buckets);
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: resize
+// PreCondition:  buckets is a power of two that can hold the values
+// PostCondition: move every value into a new set of buckets, doubling
+// them again in the rare case that the values do not
+// fit.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void CuckooHashTable<Key, Hash>::resize(size_type buckets) {
+    std::vector<Key> values;
+    values.reserve(count);
+    for (Bucket &bucket : table) {
+        for (size_type i = 0; i < SLOTS; i++) {
+            if (bucket.used >> i & 1) {
+                values.push_back(std::move(bucket.slots[i]));
+            }
+        }
+    }
+    for (Key &stashed : stash) {
+        values.push_back(std::move(stashed));
+    }
+
+    for (;; buckets *= 2) {
+        number_of_buckets = buckets;
+        table.assign(number_of_buckets, Bucket());
+        stash.clear();
+
+        size_type placed = 0;
+        for (; placed < values.size(); placed++) {
+            if (!place(values[placed])) {
+                if (stash.size() == STASH_SIZE) {
+                    break;
+                }
+                stash.push_back(std::move(values[placed]));
+            }
+        }
+        if (placed == values.size()) {
+            return;
+        }
+
+        // Gather the values placed so far and try more buckets
+        std::vector<Key> remaining;
+        remaining.reserve(values.size());
+        for (Bucket &bucket : table) {
+            for (size_type i = 0; i < SLOTS; i++) {
+                if (bucket.used >> i & 1) {
+                    remaining.push_back(std::move(bucket.slots[i]));
+                }
+            }
+        }
+        for (Key &stashed : stash) {
+            remaining.push_back(std::move(stashed));
+        }
+        for (; placed < values.size(); placed++) {
+            remaining.push_back(std::move(values[placed]));
+        }
+        values.swap(remaining);
+    }
+}
+
+//-------------------------------------------------------
+// Name: load_factor
+// PreCondition:
+// PostCondition: returns the current load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float CuckooHashTable<Key, Hash>::load_factor() const {
+    return (float) count / (float) table_size();
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor
+// PreCondition:
+// PostCondition: returns the load factor at which the table grows.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float CuckooHashTable<Key, Hash>::max_load_factor() const {
+    return maximum_load_factor;
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor
+// PreCondition:  0 < mlf < 1
+// PostCondition: sets the load factor at which the table grows, and
+// grows it right away if it is already above it.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void CuckooHashTable<Key, Hash>::max_load_factor(float mlf) {
+    if (mlf <= 0.0f || mlf >= 1.0f) {
+        throw std::invalid_argument("max load factor must be between 0 and 1");
+    }
+    maximum_load_factor = mlf;
+
+    size_type buckets = number_of_buckets;
+    while ((float) count / (float) (buckets * SLOTS) > maximum_load_factor) {
+        buckets *= 2;
+    }
+    if (buckets != number_of_buckets) {
+        resize(buckets);
+    }
+}
+
+//-------------------------------------------------------
+// Name: print_table
+// PreCondition:
+// PostCondition: print the used cells as "index: value", then the
+// stashed values.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void CuckooHashTable<Key, Hash>::print_table(std::ostream &os) const {
+    if (is_empty()) {
+        os << "<empty>\n";
+        return;
+    }
+    for (size_type b = 0; b < number_of_buckets; b++) {
+        for (size_type i = 0; i < SLOTS; i++) {
+            if (table[b].used >> i & 1) {
+                os << b * SLOTS + i << ": " << table[b].slots[i] << std::endl;
+            }
+        }
+    }
+    for (const Key &stashed : stash) {
+        os << "stash: " << stashed << std::endl;
+    }
+}
+
+#endif  // HASHTABLE_CUCKOO_H
@@ -0,0 +1,221 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "hashtable_cuckoo.h"
+
+void test_integer_1();
+
+void test_high_occupancy();
+
+void test_strings();
+
+void test_stash();
+
+int main() {
+    test_integer_1();
+    test_high_occupancy();
+    test_strings();
+    test_stash();
+    return 0;
+}
+
+void test_integer_1() {
+    const int INITIAL_SIZE = 0;
+    const int INITIAL_TABLE_SIZE = 16;
+    const int NUMBER_OF_INPUTS = 3;
+    const int NUMBER_OF_INPUTS_AFTER_REMOVE = 2;
+    const int VALID_REHASH_VALUE = 64;
+    const int INVALID_REHASH_VALUE = INITIAL_TABLE_SIZE;
+
+    std::cout << "make an empty cuckoo hash table with 16 cells for ints" << std::endl;
+    CuckooHashTable<int> table(INITIAL_TABLE_SIZE);
+
+    if (table.size() == INITIAL_SIZE && table.is_empty() && table.table_size() == INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed " << std::endl;
+    }
+
+    table.insert(5);
+    table.insert(3);
+    table.insert(6);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(3) && table.contains(5) && !table.contains(4)) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed " << std::endl;
+    }
+
+    if (table.remove(3) == 1 && table.remove(3) == 0 && table.size() == NUMBER_OF_INPUTS_AFTER_REMOVE
+        && !table.contains(3)) {
+        std::cout << "[PASSED] remove test " << std::endl;
+    } else {
+        std::cout << "remove test failed " << std::endl;
+    }
+
+    if (!table.rehash(INVALID_REHASH_VALUE) && table.rehash(VALID_REHASH_VALUE)
+        && table.table_size() == VALID_REHASH_VALUE && table.contains(5) && table.contains(6)) {
+        std::cout << "[PASSED] rehash test " << std::endl;
+    } else {
+        std::cout << "rehash test failed " << std::endl;
+    }
+
+    table.make_empty();
+    std::stringstream output;
+    table.print_table(output);
+    if (table.is_empty() && output.str() == "<empty>\n" && table.table_size() == VALID_REHASH_VALUE) {
+        std::cout << "[PASSED] make empty test " << std::endl;
+    } else {
+        std::cout << "make empty test failed " << std::endl;
+    }
+}
+
+void test_high_occupancy() {
+    const int TABLE_SIZE = 1 << 16;
+    const float MINIMUM_OCCUPANCY = 0.9f;
+
+    std::cout << "fill a cuckoo hash table past 90% without growing" << std::endl;
+    CuckooHashTable<int> table(TABLE_SIZE);
+
+    int n = 0;
+    while (table.load_factor() < MINIMUM_OCCUPANCY) {
+        table.insert(n++);
+    }
+
+    bool all_found = table.table_size() == TABLE_SIZE;
+    for (int i = 0; i < n; i++) {
+        all_found = all_found && table.contains(i);
+    }
+
+    if (all_found && !table.contains(n) && table.load_factor() >= MINIMUM_OCCUPANCY) {
+        std::cout << "[PASSED] high occupancy test " << std::endl;
+    } else {
+        std::cout << "high occupancy test failed " << std::endl;
+    }
+
+    for (int i = 0; i < n; i += 2) {
+        table.remove(i);
+    }
+    all_found = table.size() == (size_t) n / 2;
+    for (int i = 0; i < n; i++) {
+        all_found = all_found && table.contains(i) == (i % 2 == 1);
+    }
+
+    if (all_found) {
+        std::cout << "[PASSED] remove at high occupancy test " << std::endl;
+    } else {
+        std::cout << "remove at high occupancy test failed " << std::endl;
+    }
+}
+
+void test_strings() {
+    const int NUMBER_OF_INPUTS = 10000;
+
+    std::cout << "make a cuckoo hash table for strings" << std::endl;
+    CuckooHashTable<std::string> table;
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert("/api/v1/session/" + std::to_string(n));
+    }
+
+    bool all_found = table.size() == NUMBER_OF_INPUTS && table.load_factor() <= table.max_load_factor();
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains("/api/v1/session/" + std::to_string(n));
+    }
+
+    if (all_found && !table.contains("/api/v1/session/")) {
+        std::cout << "[PASSED] grow test " << std::endl;
+    } else {
+        std::cout << "grow test failed " << std::endl;
+    }
+}
+
+// Every key hashes to the same two buckets, so only eight fit in them
+struct ConstantHash {
+    size_t operator()(int) const {
+        return 0;
+    }
+};
+
+// Keys hash to one of three values, so their buckets often overlap in a
+// small table
+struct ThreeHashes {
+    size_t operator()(const std::string &key) const {
+        return std::stoul(key) % 3;
+    }
+};
+
+void test_stash() {
+    const int BUCKET_CELLS = 8;
+
+    std::cout << "overflow the buckets of a cuckoo hash table into its stash" << std::endl;
+    CuckooHashTable<int, ConstantHash> table(1024);
+
+    for (int n = 0; n < BUCKET_CELLS + 2; n++) {
+        table.insert(n);
+    }
+
+    bool all_found = table.size() == BUCKET_CELLS + 2 && table.stash_size() == 2 && table.table_size() == 1024;
+    for (int n = 0; n < BUCKET_CELLS + 2; n++) {
+        all_found = all_found && table.contains(n);
+    }
+
+    if (all_found) {
+        std::cout << "[PASSED] stash test " << std::endl;
+    } else {
+        std::cout << "stash test failed " << std::endl;
+    }
+
+    // A removal makes room for a stashed value
+    if (table.remove(0) == 1 && table.stash_size() == 1 && table.contains(BUCKET_CELLS + 1)) {
+        std::cout << "[PASSED] stash refill test " << std::endl;
+    } else {
+        std::cout << "stash refill test failed " << std::endl;
+    }
+
+    // Once both buckets and the stash hold values with the hash, growing
+    // would never make room, so the table refuses the value
+    const int MOST_VALUES = BUCKET_CELLS + 4;
+    CuckooHashTable<int, ConstantHash> crowded;
+    for (int n = 0; n < MOST_VALUES; n++) {
+        crowded.insert(n);
+    }
+    size_t cells = crowded.table_size();
+    bool thrown = false;
+    try {
+        crowded.insert(MOST_VALUES);
+    } catch (const std::length_error &) {
+        thrown = true;
+    }
+    all_found = thrown && crowded.size() == MOST_VALUES && crowded.table_size() == cells &&
+                !crowded.contains(MOST_VALUES);
+    for (int n = 0; n < MOST_VALUES; n++) {
+        all_found = all_found && crowded.contains(n);
+    }
+    if (all_found) {
+        std::cout << "[PASSED] same hash test " << std::endl;
+    } else {
+        std::cout << "same hash test failed " << std::endl;
+    }
+
+    // 27 values do not fit in the 8 buckets asked for, so the rehash moves
+    // them into 16 instead, without losing any
+    const int NUMBER_OF_INPUTS = 27;
+    const int REQUESTED_CELLS = 29;
+    CuckooHashTable<std::string, ThreeHashes> overlapping(1024);
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        overlapping.insert(std::to_string(n));
+    }
+    all_found = overlapping.rehash(REQUESTED_CELLS) && overlapping.table_size() == 64 &&
+                overlapping.size() == NUMBER_OF_INPUTS;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && overlapping.contains(std::to_string(n)) &&
+                    !overlapping.contains(std::to_string(n + NUMBER_OF_INPUTS));
+    }
+    if (all_found) {
+        std::cout << "[PASSED] rehash retry test " << std::endl;
+    } else {
+        std::cout << "rehash retry test failed " << std::endl;
+    }
+}
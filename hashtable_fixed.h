@@ -0,0 +1,235 @@
+#ifndef HASHTABLE_FIXED_H
+#define HASHTABLE_FIXED_H
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include "hashtable_capacity.h"
+#include "hashtable_hash.h"
+#include "hashtable_probe.h"
+
+// Open addressing for a set of at most N keys known up front, such as
+// protocol opcodes or header names. The cells are a std::array inside the
+// table, twice as many as N rounded up to a power of two so the load
+// factor never exceeds 0.5, and nothing is allocated. Every member that
+// does not print is constexpr, so with a constexpr Hash (ConstexprHash by
+// default) a table can be built at compile time and its lookups reduce to
+// hashing the key and comparing a few cells.
+//
+// Values are placed with the Probe policies of the open addressing table,
+// any but QuadraticProbe, which reaches too few cells of a power of two
+// table.
+// The table never grows and values are never removed, so there are no
+// deleted cells and no rehashing.
+template<class Key, std::size_t N, class Hash=ConstexprHash, class Probe=LinearProbe>
+class FixedHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+    static_assert(Probe::template max_load_factor<PowerOfTwoCapacity>() >= 0.5f,
+                  "the probe sequence cannot reach a free cell of a power of two table");
+
+    // Number of cells
+    static constexpr size_type CELLS = PowerOfTwoCapacity::round_up(2 * N > 0 ? 2 * N : 1);
+
+private:
+    std::array<Key, CELLS> table{};
+    std::array<bool, CELLS> used{};
+    size_type count = 0;
+
+    template<class K>
+    constexpr size_type find(const K &key) const;
+
+public:
+    constexpr FixedHashTable() = default;
+
+    constexpr FixedHashTable(std::initializer_list<Key> keys);
+
+    constexpr bool is_empty() const;
+
+    constexpr size_t size() const;
+
+    constexpr size_t capacity() const;
+
+    constexpr size_t table_size() const;
+
+    constexpr bool insert(const value_type &value);
+
+    constexpr bool contains(const key_type &key) const;
+
+    constexpr size_t position(const key_type &key) const;
+
+    // Lookups by any type a transparent Hash accepts, such as a
+    // const char* into a table of std::string_view with ConstexprHash
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    constexpr bool contains(const K &key) const;
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    constexpr size_t position(const K &key) const;
+
+    void print_table(std::ostream &os = std::cout) const;
+};
+
+//-------------------------------------------------------
+// Name: FixedHashTable
+// PreCondition:  there are at most N distinct keys
+// PostCondition: makes a table holding the given keys, duplicates once.
+// Throws std::length_error if there are more than N
+// distinct keys, which fails the build when the table
+// is constexpr.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+constexpr FixedHashTable<Key, N, Hash, Probe>::FixedHashTable(std::initializer_list<Key> keys) {
+    for (const Key &key : keys) {
+        insert(key);
+    }
+}
+
+//-------------------------------------------------------
+// Name: is_empty
+// PreCondition:
+// PostCondition: returns true if the table is empty.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+constexpr bool FixedHashTable<Key, N, Hash, Probe>::is_empty() const {
+    return count == 0;
+}
+
+//-------------------------------------------------------
+// Name: size
+// PreCondition:
+// PostCondition: returns the number of values in the table.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+constexpr size_t FixedHashTable<Key, N, Hash, Probe>::size() const {
+    return count;
+}
+
+//-------------------------------------------------------
+// Name: capacity
+// PreCondition:
+// PostCondition: returns N, the most values the table can hold.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+constexpr size_t FixedHashTable<Key, N, Hash, Probe>::capacity() const {
+    return N;
+}
+
+//-------------------------------------------------------
+// Name: table_size
+// PreCondition:
+// PostCondition: returns the number of cells, CELLS.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+constexpr size_t FixedHashTable<Key, N, Hash, Probe>::table_size() const {
+    return CELLS;
+}
+
+//-------------------------------------------------------
+// Name: find
+// PreCondition:
+// PostCondition: returns the cell holding the key, or the empty cell
+// that ends its probe sequence, or CELLS if the
+// sequence visits no empty cell.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+template<class K>
+constexpr typename FixedHashTable<Key, N, Hash, Probe>::size_type
+FixedHashTable<Key, N, Hash, Probe>::find(const K &key) const {
+    typename Probe::template Sequence<PowerOfTwoCapacity> sequence(Hash{}(key), CELLS);
+    for (size_type i = 0; i < CELLS; i++, sequence.next()) {
+        size_type index = sequence.index();
+        if (!used[index] || table[index] == key) {
+            return index;
+        }
+    }
+    return CELLS;
+}
+
+//-------------------------------------------------------
+// Name: insert
+// PreCondition:
+// PostCondition: insert the given value, return true if it was not in
+// the table yet. Throws std::length_error if the table
+// already holds N values. Until then the table is at
+// most half full, so the probe sequence of every policy
+// it allows reaches a free cell.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+constexpr bool FixedHashTable<Key, N, Hash, Probe>::insert(const value_type &value) {
+    size_type index = find(value);
+    if (index < CELLS && used[index]) {
+        return false;
+    }
+    if (count == N) {
+        throw std::length_error("FixedHashTable is full");
+    }
+
+    table[index] = value;
+    used[index] = true;
+    count++;
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: contains
+// PreCondition:
+// PostCondition: returns Boolean true if the specified value is in the
+// table
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+constexpr bool FixedHashTable<Key, N, Hash, Probe>::contains(const key_type &key) const {
+    size_type index = find(key);
+    return index < CELLS && used[index];
+}
+
+template<class Key, std::size_t N, class Hash, class Probe>
+template<class K, class H, class>
+constexpr bool FixedHashTable<Key, N, Hash, Probe>::contains(const K &key) const {
+    size_type index = find(key);
+    return index < CELLS && used[index];
+}
+
+//-------------------------------------------------------
+// Name: position
+// PreCondition:
+// PostCondition: return the index of the cell that contains the
+// specified value, or CELLS if it is not in the table.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+constexpr size_t FixedHashTable<Key, N, Hash, Probe>::position(const key_type &key) const {
+    size_type index = find(key);
+    return index < CELLS && used[index] ? index : CELLS;
+}
+
+template<class Key, std::size_t N, class Hash, class Probe>
+template<class K, class H, class>
+constexpr size_t FixedHashTable<Key, N, Hash, Probe>::position(const K &key) const {
+    size_type index = find(key);
+    return index < CELLS && used[index] ? index : CELLS;
+}
+
+//-------------------------------------------------------
+// Name: print_table
+// PreCondition:
+// PostCondition: pretty print the table, one used cell per line.
+//---------------------------------------------------------
+template<class Key, std::size_t N, class Hash, class Probe>
+void FixedHashTable<Key, N, Hash, Probe>::print_table(std::ostream &os) const {
+    if (count == 0) {
+        os << "<empty>\n";
+    }
+    for (size_type i = 0; i < CELLS; i++) {
+        if (used[i]) {
+            os << i << ": " << table[i] << "\n";
+        }
+    }
+}
+
+#endif  // HASHTABLE_FIXED_H
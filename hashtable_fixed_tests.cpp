@@ -0,0 +1,156 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "hashtable_fixed.h"
+
+void test_integer_1();
+
+void test_constexpr();
+
+void test_strings();
+
+void test_probe_policies();
+
+int main() {
+    test_integer_1();
+    test_constexpr();
+    test_strings();
+    test_probe_policies();
+    return 0;
+}
+
+void test_integer_1() {
+    const int CAPACITY = 5;
+    const int TABLE_SIZE = 16;
+    const int NUMBER_OF_INPUTS = 4;
+
+    std::cout << "make an empty fixed table for 5 ints" << std::endl;
+    FixedHashTable<int, CAPACITY> table;
+
+    if (table.size() == 0 && table.is_empty() && table.capacity() == CAPACITY &&
+        table.table_size() == TABLE_SIZE) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed" << std::endl;
+    }
+
+    table.insert(3);
+    table.insert(17);
+    table.insert(-4);
+    table.insert(1000);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(17) && table.size() == NUMBER_OF_INPUTS) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed" << std::endl;
+    }
+
+    if (table.contains(3) && table.contains(17) && table.contains(-4) && table.contains(1000) &&
+        !table.contains(4) && table.position(4) == TABLE_SIZE && table.position(17) < TABLE_SIZE) {
+        std::cout << "[PASSED] contains test " << std::endl;
+    } else {
+        std::cout << "contains test failed" << std::endl;
+    }
+
+    table.insert(5);
+    bool thrown = false;
+    try {
+        table.insert(6);
+    } catch (const std::length_error &) {
+        thrown = true;
+    }
+    if (thrown && table.size() == CAPACITY && !table.contains(6) && !table.insert(5)) {
+        std::cout << "[PASSED] full table test " << std::endl;
+    } else {
+        std::cout << "full table test failed" << std::endl;
+    }
+
+    std::ostringstream printed;
+    table.print_table(printed);
+    std::ostringstream empty;
+    FixedHashTable<int, CAPACITY>().print_table(empty);
+    if (printed.str().find(": 1000\n") != std::string::npos && empty.str() == "<empty>\n") {
+        std::cout << "[PASSED] print test " << std::endl;
+    } else {
+        std::cout << "print test failed" << std::endl;
+    }
+}
+
+enum class Opcode {
+    LOAD, STORE, ADD, JUMP, HALT
+};
+
+void test_constexpr() {
+    // Built and queried by the compiler
+    constexpr FixedHashTable<int, 6> primes{2, 3, 5, 7, 11, 13};
+    static_assert(primes.size() == 6, "six primes");
+    static_assert(primes.contains(11) && !primes.contains(9), "primes lookup");
+
+    constexpr FixedHashTable<Opcode, 3> writes{Opcode::STORE, Opcode::JUMP, Opcode::STORE};
+    static_assert(writes.size() == 2, "duplicates are inserted once");
+    static_assert(writes.contains(Opcode::JUMP) && !writes.contains(Opcode::LOAD), "opcode lookup");
+
+    constexpr FixedHashTable<int, 0> none{};
+    static_assert(none.is_empty() && !none.contains(0), "empty table");
+
+    static_assert(ConstexprHash{}(std::string_view("GET")) != ConstexprHash{}(std::string_view("PUT")),
+                  "distinct hashes");
+
+    // The same lookups at run time
+    int found = 0;
+    for (int i = 0; i < 20; i++) {
+        found += primes.contains(i);
+    }
+    if (found == 6 && writes.contains(Opcode::STORE) && !writes.contains(Opcode::HALT)) {
+        std::cout << "[PASSED] constexpr test " << std::endl;
+    } else {
+        std::cout << "constexpr test failed" << std::endl;
+    }
+}
+
+void test_strings() {
+    using namespace std::string_view_literals;
+    static constexpr FixedHashTable<std::string_view, 8> methods{
+            "GET"sv, "HEAD"sv, "POST"sv, "PUT"sv, "DELETE"sv, "CONNECT"sv, "OPTIONS"sv, "TRACE"sv};
+    static_assert(methods.contains("OPTIONS"sv) && !methods.contains("PATCH"sv), "method lookup");
+
+    // Transparent lookups by const char* and std::string
+    std::string patch = "PATCH";
+    std::string del = "DELETE";
+    if (methods.size() == 8 && methods.contains("GET") && !methods.contains("get") &&
+        methods.contains(del) && !methods.contains(patch) && methods.position(del) < methods.table_size() &&
+        methods.position(patch) == methods.table_size()) {
+        std::cout << "[PASSED] string test " << std::endl;
+    } else {
+        std::cout << "string test failed" << std::endl;
+    }
+}
+
+template<class Probe>
+constexpr bool probe_round_trip() {
+    FixedHashTable<int, 64, ConstexprHash, Probe> table;
+    for (int i = 0; i < 64; i++) {
+        table.insert(i * 37);
+    }
+    for (int i = 0; i < 64; i++) {
+        if (!table.contains(i * 37) || table.contains(i * 37 + 1)) {
+            return false;
+        }
+    }
+    return table.size() == 64;
+}
+
+void test_probe_policies() {
+    static_assert(probe_round_trip<LinearProbe>(), "linear probing");
+    static_assert(probe_round_trip<TriangularProbe>(), "triangular probing");
+    static_assert(probe_round_trip<DoubleHashProbe>(), "double hashing");
+
+    if (probe_round_trip<LinearProbe>() && probe_round_trip<TriangularProbe>() &&
+        probe_round_trip<DoubleHashProbe>()) {
+        std::cout << "[PASSED] probe policies test " << std::endl;
+    } else {
+        std::cout << "probe policies test failed" << std::endl;
+    }
+}
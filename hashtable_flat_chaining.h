@@ -0,0 +1,461 @@
+#ifndef HASHTABLE_FLAT_CHAINING_H
+#define HASHTABLE_FLAT_CHAINING_H
+
+#include <array>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "hashtable_capacity.h"
+#include "hashtable_hash.h"
+
+// Separate chaining where every bucket keeps its first values in a small
+// inline array and only spills the rest to an overflow vector. The buckets
+// sit next to each other in one vector, so a lookup reads the bucket and
+// usually finds the value in the same cache line, instead of following one
+// pointer per value down a list. Same interface as the separate chaining
+// HashTable, including bucket_count(), bucket_size() and bucket().
+template<class Key, class Hash=std::hash<Key>, class Capacity=PrimeCapacity, size_t BucketSlots=4>
+class FlatHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+private:
+    struct Bucket {
+        // Values in use, the first BucketSlots of them are in slots
+        size_type size = 0;
+        std::array<Key, BucketSlots> slots;
+        std::vector<Key> overflow;
+
+        Key &at(size_type i) {
+            return i < BucketSlots ? slots[i] : overflow[i - BucketSlots];
+        }
+
+        const Key &at(size_type i) const {
+            return i < BucketSlots ? slots[i] : overflow[i - BucketSlots];
+        }
+    };
+
+    std::vector<Bucket> table;
+    size_type count;
+    float maximum_load_factor;
+
+    // Constants
+    static constexpr size_type DEFAULT_BUCKET_SIZE = 11;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 1.0f;
+
+    template<class Value>
+    bool place(Value &&value);
+
+    template<class Value>
+    static void append(Bucket &bucket, Value &&value);
+
+    template<class K>
+    size_type find(const Bucket &bucket, const K &key) const;
+
+    template<class K>
+    size_t remove_key(const K &key);
+
+    void relink(size_type buckets);
+
+public:
+    FlatHashTable();
+
+    FlatHashTable(size_type buckets);
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    void make_empty();
+
+    bool insert(const value_type &value);
+
+    bool insert(value_type &&value);
+
+    template<class... Args>
+    bool emplace(Args &&... args);
+
+    size_t remove(const key_type &key);
+
+    bool contains(const key_type &key) const;
+
+    // Lookups by any type a transparent Hash accepts
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    size_t remove(const K &key);
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    bool contains(const K &key) const;
+
+    size_t bucket_count() const;
+
+    size_t bucket_size(size_t n) const;
+
+    size_t bucket(const key_type &key) const;
+
+    float load_factor() const;
+
+    float max_load_factor() const;
+
+    void max_load_factor(float mlf);
+
+    bool rehash(size_type count);
+
+    void print_table(std::ostream &os = std::cout) const;
+};
+
+//-------------------------------------------------------
+// Name: FlatHashTable()
+// PreCondition:
+// PostCondition: makes an empty table with 11 buckets, rounded up to a
+// size the capacity policy allows
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+FlatHashTable<Key, Hash, Capacity, BucketSlots>::FlatHashTable() : FlatHashTable(DEFAULT_BUCKET_SIZE) {
+}
+
+//-------------------------------------------------------
+// Name: FlatHashTable(size_type buckets)
+// PreCondition: buckets is greater than zero
+// PostCondition: makes an empty table with the specified number of
+// buckets, rounded up to a size the capacity policy allows
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+FlatHashTable<Key, Hash, Capacity, BucketSlots>::FlatHashTable(size_type buckets) {
+    table.resize(Capacity::round_up(buckets));
+    count = 0;
+    maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+}
+
+//-------------------------------------------------------
+// Name: is_empty()
+// PreCondition:
+// PostCondition: return true if the table holds no values
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+bool FlatHashTable<Key, Hash, Capacity, BucketSlots>::is_empty() const {
+    return count == 0;
+}
+
+//-------------------------------------------------------
+// Name: size()
+// PreCondition:
+// PostCondition: return the number of values in the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+size_t FlatHashTable<Key, Hash, Capacity, BucketSlots>::size() const {
+    return count;
+}
+
+//-------------------------------------------------------
+// Name: make_empty()
+// PreCondition:
+// PostCondition: remove all values, the number of buckets is kept
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+void FlatHashTable<Key, Hash, Capacity, BucketSlots>::make_empty() {
+    size_type buckets = table.size();
+    table.clear();
+    table.resize(buckets);
+    count = 0;
+}
+
+//-------------------------------------------------------
+// Name: insert()
+// PreCondition:
+// PostCondition: insert the given value into the table, rehashing if
+// the maximum load factor is exceeded, return true if
+// insert was successful (false if item already exists)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+bool FlatHashTable<Key, Hash, Capacity, BucketSlots>::insert(const value_type &value) {
+    return place(value);
+}
+
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+bool FlatHashTable<Key, Hash, Capacity, BucketSlots>::insert(value_type &&value) {
+    return place(std::move(value));
+}
+
+//-------------------------------------------------------
+// Name: emplace()
+// PreCondition:
+// PostCondition: construct a value from the given arguments and move it
+// into its bucket, return true if insert was successful
+// (false if item already exists)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+template<class... Args>
+bool FlatHashTable<Key, Hash, Capacity, BucketSlots>::emplace(Args &&... args) {
+    Key value(std::forward<Args>(args)...);
+    return place(std::move(value));
+}
+
+//-------------------------------------------------------
+// Name: place()
+// PreCondition:
+// PostCondition: the insert shared by copies and moves, the value is
+// only forwarded into the bucket once it is known to be
+// new
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+template<class Value>
+bool FlatHashTable<Key, Hash, Capacity, BucketSlots>::place(Value &&value) {
+    Bucket &bucket = table[Capacity::index(Hash{}(value), table.size())];
+    if (find(bucket, value) < bucket.size) {
+        return false;
+    }
+
+    append(bucket, std::forward<Value>(value));
+    count++;
+
+    if (load_factor() > maximum_load_factor) {
+        relink(Capacity::next_size(table.size() * 2));
+    }
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: append()
+// PreCondition:
+// PostCondition: add the value after the last one in the bucket, in the
+// inline slots while there is room
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+template<class Value>
+void FlatHashTable<Key, Hash, Capacity, BucketSlots>::append(Bucket &bucket, Value &&value) {
+    if (bucket.size < BucketSlots) {
+        bucket.slots[bucket.size] = std::forward<Value>(value);
+    } else {
+        bucket.overflow.push_back(std::forward<Value>(value));
+    }
+    bucket.size++;
+}
+
+//-------------------------------------------------------
+// Name: find()
+// PreCondition:
+// PostCondition: return the position of key in the bucket, or the size
+// of the bucket if it is not there
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+template<class K>
+typename FlatHashTable<Key, Hash, Capacity, BucketSlots>::size_type
+FlatHashTable<Key, Hash, Capacity, BucketSlots>::find(const Bucket &bucket, const K &key) const {
+    size_type inline_size = bucket.size < BucketSlots ? bucket.size : BucketSlots;
+    for (size_type i = 0; i < inline_size; i++) {
+        if (bucket.slots[i] == key) {
+            return i;
+        }
+    }
+    for (size_type i = BucketSlots; i < bucket.size; i++) {
+        if (bucket.overflow[i - BucketSlots] == key) {
+            return i;
+        }
+    }
+    return bucket.size;
+}
+
+//-------------------------------------------------------
+// Name: remove()
+// PreCondition:
+// PostCondition: remove the specified value from the table, the last
+// value of the bucket takes its place, return number of
+// elements removed (0 or 1)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+size_t FlatHashTable<Key, Hash, Capacity, BucketSlots>::remove(const key_type &key) {
+    return remove_key(key);
+}
+
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+template<class K, class H, class>
+size_t FlatHashTable<Key, Hash, Capacity, BucketSlots>::remove(const K &key) {
+    return remove_key(key);
+}
+
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+template<class K>
+size_t FlatHashTable<Key, Hash, Capacity, BucketSlots>::remove_key(const K &key) {
+    Bucket &bucket = table[Capacity::index(Hash{}(key), table.size())];
+    size_type i = find(bucket, key);
+    if (i == bucket.size) {
+        return 0;
+    }
+
+    size_type last = bucket.size - 1;
+    if (i != last) {
+        bucket.at(i) = std::move(bucket.at(last));
+    }
+    if (last >= BucketSlots) {
+        bucket.overflow.pop_back();
+    } else {
+        // Leave the slot holding an empty value rather than a moved one
+        bucket.slots[last] = Key();
+    }
+    bucket.size--;
+    count--;
+    return 1;
+}
+
+//-------------------------------------------------------
+// Name: contains()
+// PreCondition:
+// PostCondition: return true if the specified value is in the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+bool FlatHashTable<Key, Hash, Capacity, BucketSlots>::contains(const key_type &key) const {
+    const Bucket &bucket = table[Capacity::index(Hash{}(key), table.size())];
+    return find(bucket, key) < bucket.size;
+}
+
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+template<class K, class H, class>
+bool FlatHashTable<Key, Hash, Capacity, BucketSlots>::contains(const K &key) const {
+    const Bucket &bucket = table[Capacity::index(Hash{}(key), table.size())];
+    return find(bucket, key) < bucket.size;
+}
+
+//-------------------------------------------------------
+// Name: bucket_count()
+// PreCondition:
+// PostCondition: return the number of buckets in the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+size_t FlatHashTable<Key, Hash, Capacity, BucketSlots>::bucket_count() const {
+    return table.size();
+}
+
+//-------------------------------------------------------
+// Name: bucket_size()
+// PreCondition:
+// PostCondition: return the number of values in the nth bucket, inline
+// and spilled, throw std::out_of_range if n is not a
+// bucket
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+size_t FlatHashTable<Key, Hash, Capacity, BucketSlots>::bucket_size(size_t n) const {
+    if (n >= table.size()) throw std::out_of_range("Value is out of range");
+    return table[n].size;
+}
+
+//-------------------------------------------------------
+// Name: bucket()
+// PreCondition:
+// PostCondition: return the index of the bucket that contains the
+// specified value (or would contain it, if it existed)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+size_t FlatHashTable<Key, Hash, Capacity, BucketSlots>::bucket(const key_type &key) const {
+    return Capacity::index(Hash{}(key), table.size());
+}
+
+//-------------------------------------------------------
+// Name: load_factor()
+// PreCondition:
+// PostCondition: return the current load factor of the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+float FlatHashTable<Key, Hash, Capacity, BucketSlots>::load_factor() const {
+    return (float) count / (float) table.size();
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:
+// PostCondition: return the maximum load factor of the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+float FlatHashTable<Key, Hash, Capacity, BucketSlots>::max_load_factor() const {
+    return maximum_load_factor;
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:  mlf is greater than zero
+// PostCondition: set the maximum load factor of the table, throws
+// std::invalid_argument if the input is not greater than
+// zero.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+void FlatHashTable<Key, Hash, Capacity, BucketSlots>::max_load_factor(float mlf) {
+    if (!(mlf > 0.0f)) {
+        throw std::invalid_argument("max load factor must be greater than 0");
+    }
+    maximum_load_factor = mlf;
+}
+
+//-------------------------------------------------------
+// Name: rehash()
+// PreCondition:
+// PostCondition: set the number of buckets to the specified value,
+// rounded up to a size the capacity policy allows, unless
+// that would exceed the maximum load factor. Returns
+// false if the number of buckets is unchanged or would
+// exceed the maximum load factor.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+bool FlatHashTable<Key, Hash, Capacity, BucketSlots>::rehash(size_type count) {
+    count = Capacity::round_up(count);
+
+    if (count == table.size()) {
+        return false;
+    }
+
+    if (((float) size() / count) > maximum_load_factor) {
+        return false;
+    }
+
+    relink(count);
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: relink()
+// PreCondition: buckets can hold all the values
+// PostCondition: move every value once into a new set of buckets
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+void FlatHashTable<Key, Hash, Capacity, BucketSlots>::relink(size_type buckets) {
+    std::vector<Bucket> old_table(buckets);
+    old_table.swap(table);
+
+    for (Bucket &old_bucket : old_table) {
+        for (size_type i = 0; i < old_bucket.size; i++) {
+            Key &value = old_bucket.at(i);
+            append(table[Capacity::index(Hash{}(value), table.size())], std::move(value));
+        }
+    }
+}
+
+//-------------------------------------------------------
+// Name: print_table()
+// PreCondition:
+// PostCondition: print the non empty buckets and their values
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, size_t BucketSlots>
+void FlatHashTable<Key, Hash, Capacity, BucketSlots>::print_table(std::ostream &os) const {
+    if (is_empty()) {
+        os << "<empty>\n";
+        return;
+    }
+
+    for (size_type i = 0; i < table.size(); i++) {
+        const Bucket &bucket = table[i];
+        if (bucket.size == 0) {
+            continue;
+        }
+        os << i << ": [";
+        for (size_type j = 0; j < bucket.size; j++) {
+            os << (j == 0 ? "" : ", ") << bucket.at(j);
+        }
+        os << "]" << std::endl;
+    }
+}
+
+#endif  // HASHTABLE_FLAT_CHAINING_H
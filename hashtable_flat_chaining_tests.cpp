@@ -0,0 +1,208 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "hashtable_flat_chaining.h"
+
+void test_integer_1();
+
+void test_strings();
+
+void test_overflow();
+
+void test_copy_and_move();
+
+int main() {
+    test_integer_1();
+    test_strings();
+    test_overflow();
+    test_copy_and_move();
+    return 0;
+}
+
+void test_integer_1() {
+    const int INITIAL_SIZE = 0;
+    const int INITIAL_TABLE_SIZE = 11;
+    const int NUMBER_OF_INPUTS = 3;
+    const int NUMBER_OF_INPUTS_AFTER_REMOVE = 2;
+    const int VALID_REHASH_VALUE = 50;
+
+    std::cout << "make an empty flat hash table with 11 buckets for ints" << std::endl;
+    FlatHashTable<int> table(INITIAL_TABLE_SIZE);
+
+    if (table.size() == INITIAL_SIZE && table.is_empty() && table.bucket_count() == INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed " << std::endl;
+    }
+
+    table.insert(5);
+    table.insert(3);
+    table.insert(6);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(3) && table.contains(5) && !table.contains(4)) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed " << std::endl;
+    }
+
+    if (table.bucket(3) == 3 && table.bucket_size(3) == 1 && table.bucket_size(4) == 0) {
+        std::cout << "[PASSED] bucket test " << std::endl;
+    } else {
+        std::cout << "bucket test failed " << std::endl;
+    }
+
+    try {
+        table.bucket_size(INITIAL_TABLE_SIZE);
+        std::cout << "bucket size range test failed " << std::endl;
+    } catch (const std::out_of_range &) {
+        std::cout << "[PASSED] bucket size range test " << std::endl;
+    }
+
+    if (table.remove(3) == 1 && table.remove(3) == 0 && table.size() == NUMBER_OF_INPUTS_AFTER_REMOVE) {
+        std::cout << "[PASSED] remove test " << std::endl;
+    } else {
+        std::cout << "remove test failed " << std::endl;
+    }
+
+    std::stringstream output;
+    table.print_table(output);
+    if (output.str() == "5: [5]\n6: [6]\n") {
+        std::cout << "[PASSED] print table test " << std::endl;
+    } else {
+        std::cout << "print table test failed " << std::endl;
+    }
+
+    // Too few buckets for the load factor, then the same number again
+    bool refused = !table.rehash(1) && !table.rehash(table.bucket_count());
+    if (refused && table.rehash(VALID_REHASH_VALUE) && table.bucket_count() == VALID_REHASH_VALUE &&
+        table.contains(5) && table.contains(6)) {
+        std::cout << "[PASSED] rehash test " << std::endl;
+    } else {
+        std::cout << "rehash test failed " << std::endl;
+    }
+
+    try {
+        table.max_load_factor(0.0f);
+        std::cout << "max load factor range test failed " << std::endl;
+    } catch (const std::invalid_argument &) {
+        std::cout << "[PASSED] max load factor range test " << std::endl;
+    }
+
+    table.make_empty();
+    output.str("");
+    table.print_table(output);
+    if (table.is_empty() && output.str() == "<empty>\n"
+        && table.bucket_count() == VALID_REHASH_VALUE) {
+        std::cout << "[PASSED] make empty test " << std::endl;
+    } else {
+        std::cout << "make empty test failed " << std::endl;
+    }
+}
+
+void test_strings() {
+    const int NUMBER_OF_INPUTS = 1000;
+
+    std::cout << "make a flat hash table for strings" << std::endl;
+    FlatHashTable<std::string, StringHash> table;
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert("/api/v1/session/" + std::to_string(n));
+    }
+
+    bool all_found = table.size() == NUMBER_OF_INPUTS && table.load_factor() <= table.max_load_factor();
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains("/api/v1/session/" + std::to_string(n));
+    }
+
+    if (all_found && !table.contains("/api/v1/session/") && table.bucket_count() > NUMBER_OF_INPUTS) {
+        std::cout << "[PASSED] grow test " << std::endl;
+    } else {
+        std::cout << "grow test failed " << std::endl;
+    }
+
+    std::string line = "GET /api/v1/session/7 HTTP/1.1";
+    std::string_view view = std::string_view(line).substr(4, 17);
+    if (table.contains(view) && table.remove(view) == 1 && !table.contains("/api/v1/session/7")
+        && table.emplace(3, 'x') && table.contains("xxx") && !table.emplace("xxx")) {
+        std::cout << "[PASSED] transparent and emplace test " << std::endl;
+    } else {
+        std::cout << "transparent and emplace test failed " << std::endl;
+    }
+}
+
+void test_overflow() {
+    const int NUMBER_OF_BUCKETS = 11;
+    const int NUMBER_OF_INPUTS = 10;
+
+    std::cout << "fill one bucket of a flat hash table past its inline slots" << std::endl;
+    FlatHashTable<int> table(NUMBER_OF_BUCKETS);
+
+    // All multiples of the bucket count land in bucket 0
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n * NUMBER_OF_BUCKETS);
+    }
+
+    bool all_found = table.bucket_size(0) == NUMBER_OF_INPUTS && table.bucket_count() == NUMBER_OF_BUCKETS;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * NUMBER_OF_BUCKETS) && !table.contains(n * NUMBER_OF_BUCKETS + 1);
+    }
+
+    if (all_found && !table.insert(9 * NUMBER_OF_BUCKETS)) {
+        std::cout << "[PASSED] overflow insert test " << std::endl;
+    } else {
+        std::cout << "overflow insert test failed" << std::endl;
+    }
+
+    // Removing from the inline slots pulls values back from the overflow
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        table.remove(n * NUMBER_OF_BUCKETS);
+    }
+
+    all_found = table.bucket_size(0) == NUMBER_OF_INPUTS / 2 && table.size() == NUMBER_OF_INPUTS / 2;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * NUMBER_OF_BUCKETS) == (n % 2 == 1);
+    }
+
+    std::stringstream output;
+    table.print_table(output);
+    if (all_found && output.str() == "0: [99, 11, 55, 33, 77]\n") {
+        std::cout << "[PASSED] overflow remove test " << std::endl;
+    } else {
+        std::cout << "overflow remove test failed" << std::endl;
+    }
+}
+
+void test_copy_and_move() {
+    const int NUMBER_OF_INPUTS = 100;
+
+    std::cout << "copy and move flat hash tables" << std::endl;
+    FlatHashTable<std::string> table;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(std::to_string(n));
+    }
+
+    FlatHashTable<std::string> copy(table);
+    copy.remove("0");
+    bool all_found = copy.size() == NUMBER_OF_INPUTS - 1 && table.contains("0");
+    for (int n = 1; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && copy.contains(std::to_string(n));
+    }
+
+    if (all_found) {
+        std::cout << "[PASSED] copy test " << std::endl;
+    } else {
+        std::cout << "copy test failed " << std::endl;
+    }
+
+    FlatHashTable<std::string> moved(std::move(table));
+    table = copy;
+    copy = std::move(moved);
+    if (copy.size() == NUMBER_OF_INPUTS && copy.contains("0") && table.size() == NUMBER_OF_INPUTS - 1
+        && !table.contains("0") && table.insert("0")) {
+        std::cout << "[PASSED] move test " << std::endl;
+    } else {
+        std::cout << "move test failed " << std::endl;
+    }
+}
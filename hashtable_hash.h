@@ -0,0 +1,284 @@
+#ifndef HASHTABLE_HASH_H
+#define HASHTABLE_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Hash functions for the tables. A hash that declares is_transparent can
+// hash every type it accepts consistently with the key type, and the tables
+// then take those types directly in contains, remove and the other lookups,
+// comparing them against the stored keys with ==.
+
+//-------------------------------------------------------
+// Transparent hash for std::string keys, std::string_view and const char*
+// are hashed without building a std::string first. Equal to
+// std::hash<std::string> for the same characters.
+//---------------------------------------------------------
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const noexcept {
+        return std::hash<std::string_view>{}(s);
+    }
+};
+
+//-------------------------------------------------------
+// Building blocks of the mixers below: unaligned little endian reads, the
+// 64 by 64 bit multiply folded to 64 bits by xoring the halves of the
+// product, and the murmur3 finalizer.
+//---------------------------------------------------------
+inline std::uint64_t read64(const unsigned char *p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t read32(const unsigned char *p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t multiply_fold(std::uint64_t a, std::uint64_t b) {
+    __uint128_t product = (__uint128_t) a * b;
+    return (std::uint64_t) product ^ (std::uint64_t) (product >> 64);
+}
+
+constexpr std::uint64_t fmix64(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+//-------------------------------------------------------
+// Mixers for SeededHash. Each hashes a run of bytes and a single 64 bit
+// integer under a seed, and differs from the others only in speed and in
+// how well it spreads structured keys.
+//---------------------------------------------------------
+
+// After wyhash: every 16 bytes take one folded multiply
+struct WyMixer {
+    static constexpr std::uint64_t P0 = 0xa0761d6478bd642fULL;
+    static constexpr std::uint64_t P1 = 0xe7037ed1a0b428dbULL;
+    static constexpr std::uint64_t P2 = 0x8ebc6af09c88c6e3ULL;
+    static constexpr std::uint64_t P3 = 0x589965cc75374cc3ULL;
+
+    static std::uint64_t bytes(const unsigned char *p, std::size_t len, std::uint64_t seed) {
+        seed ^= multiply_fold(seed ^ P0, P1);
+        std::uint64_t a = 0;
+        std::uint64_t b = 0;
+        if (len <= 16) {
+            if (len >= 4) {
+                std::size_t middle = (len >> 3) << 2;
+                a = (read32(p) << 32) | read32(p + middle);
+                b = (read32(p + len - 4) << 32) | read32(p + len - 4 - middle);
+            } else if (len > 0) {
+                a = ((std::uint64_t) p[0] << 16) | ((std::uint64_t) p[len >> 1] << 8) | p[len - 1];
+            }
+        } else {
+            std::size_t i = len;
+            if (i > 48) {
+                // Three independent lanes keep the multipliers busy
+                std::uint64_t second = seed;
+                std::uint64_t third = seed;
+                do {
+                    seed = multiply_fold(read64(p) ^ P1, read64(p + 8) ^ seed);
+                    second = multiply_fold(read64(p + 16) ^ P2, read64(p + 24) ^ second);
+                    third = multiply_fold(read64(p + 32) ^ P3, read64(p + 40) ^ third);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= second ^ third;
+            }
+            while (i > 16) {
+                seed = multiply_fold(read64(p) ^ P1, read64(p + 8) ^ seed);
+                p += 16;
+                i -= 16;
+            }
+            a = read64(p + i - 16);
+            b = read64(p + i - 8);
+        }
+        __uint128_t product = (__uint128_t) (a ^ P1) * (b ^ seed);
+        return multiply_fold((std::uint64_t) product ^ P0 ^ len, (std::uint64_t) (product >> 64) ^ P1);
+    }
+
+    static std::uint64_t integer(std::uint64_t key, std::uint64_t seed) {
+        return multiply_fold(multiply_fold(key ^ P0, seed ^ P1) ^ P0, P1);
+    }
+};
+
+// After xxh3: short inputs take dedicated paths, longer ones add up one
+// folded multiply per 16 bytes against a secret, then avalanche the sum
+struct Xxh3Mixer {
+    static constexpr std::uint64_t SECRET[4] = {0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL,
+                                                0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL};
+    static constexpr std::uint64_t PRIME = 0x9e3779b185ebca87ULL;
+
+    static std::uint64_t avalanche(std::uint64_t h) {
+        h ^= h >> 37;
+        h *= 0x165667919e3779f9ULL;
+        return h ^ (h >> 32);
+    }
+
+    static std::uint64_t rrmxmx(std::uint64_t h, std::uint64_t len) {
+        h ^= ((h << 49) | (h >> 15)) ^ ((h << 24) | (h >> 40));
+        h *= 0x9fb21c651e98df25ULL;
+        h ^= (h >> 35) + len;
+        h *= 0x9fb21c651e98df25ULL;
+        return h ^ (h >> 28);
+    }
+
+    static std::uint64_t bytes(const unsigned char *p, std::size_t len, std::uint64_t seed) {
+        if (len == 0) {
+            return avalanche(seed ^ SECRET[0]);
+        }
+        if (len <= 3) {
+            std::uint64_t combined = ((std::uint64_t) p[0] << 16) | ((std::uint64_t) p[len >> 1] << 24) | p[len - 1]
+                                     | ((std::uint64_t) len << 8);
+            return fmix64(combined ^ (SECRET[0] + seed));
+        }
+        if (len <= 8) {
+            std::uint64_t input = read32(p + len - 4) | (read32(p) << 32);
+            return rrmxmx(input ^ (SECRET[1] - seed), len);
+        }
+        if (len <= 16) {
+            std::uint64_t low = read64(p) ^ (SECRET[2] + seed);
+            std::uint64_t high = read64(p + len - 8) ^ (SECRET[3] - seed);
+            return avalanche(len + __builtin_bswap64(low) + high + multiply_fold(low, high));
+        }
+
+        std::uint64_t acc = len * PRIME;
+        std::size_t i = 0;
+        for (; i + 16 < len; i += 16) {
+            std::size_t lane = (i >> 4) & 1;
+            acc += multiply_fold(read64(p + i) ^ (SECRET[2 * lane] + seed),
+                                 read64(p + i + 8) ^ (SECRET[2 * lane + 1] - seed));
+        }
+        // The last 16 bytes, overlapping the ones before when len is not a
+        // multiple of 16
+        acc += multiply_fold(read64(p + len - 16) ^ (SECRET[1] + seed), read64(p + len - 8) ^ (SECRET[2] - seed));
+        return avalanche(acc);
+    }
+
+    static std::uint64_t integer(std::uint64_t key, std::uint64_t seed) {
+        return rrmxmx(key ^ ((SECRET[0] ^ SECRET[1]) - seed), 8);
+    }
+};
+
+// MurmurHash64A for bytes, the murmur3 finalizer for integers
+struct MurmurMixer {
+    static constexpr std::uint64_t M = 0xc6a4a7935bd1e995ULL;
+    static constexpr int R = 47;
+
+    static std::uint64_t bytes(const unsigned char *p, std::size_t len, std::uint64_t seed) {
+        std::uint64_t h = seed ^ (len * M);
+        std::size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            std::uint64_t k = read64(p + i);
+            k *= M;
+            k ^= k >> R;
+            k *= M;
+            h ^= k;
+            h *= M;
+        }
+        if (i < len) {
+            std::uint64_t tail = 0;
+            std::memcpy(&tail, p + i, len - i);
+            h ^= tail;
+            h *= M;
+        }
+        h ^= h >> R;
+        h *= M;
+        h ^= h >> R;
+        return h;
+    }
+
+    static std::uint64_t integer(std::uint64_t key, std::uint64_t seed) {
+        return fmix64(key ^ seed);
+    }
+};
+
+//-------------------------------------------------------
+// Hash for integer and string keys built on one of the mixers above. The
+// tables construct their Hash with Hash{}, so the seed they use is the
+// Seed template argument; other code can pass a seed at run time. It is
+// transparent: std::string, std::string_view and const char* hash alike.
+//---------------------------------------------------------
+template<class Mixer, std::uint64_t Seed = 0>
+struct SeededHash {
+    using is_transparent = void;
+
+    std::uint64_t seed = Seed;
+
+    SeededHash() = default;
+
+    explicit SeededHash(std::uint64_t seed) : seed(seed) {}
+
+    std::size_t operator()(std::string_view s) const noexcept {
+        return Mixer::bytes(reinterpret_cast<const unsigned char *>(s.data()), s.size(), seed);
+    }
+
+    template<class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+    std::size_t operator()(T key) const noexcept {
+        return Mixer::integer((std::uint64_t) key, seed);
+    }
+};
+
+template<std::uint64_t Seed = 0>
+using WyHash = SeededHash<WyMixer, Seed>;
+
+template<std::uint64_t Seed = 0>
+using Xxh3Hash = SeededHash<Xxh3Mixer, Seed>;
+
+template<std::uint64_t Seed = 0>
+using MurmurHash = SeededHash<MurmurMixer, Seed>;
+
+//-------------------------------------------------------
+// Hash that also runs at compile time, for tables filled by constexpr code
+// such as FixedHashTable: FNV-1a over the characters of a string finished
+// with the murmur3 finalizer, and the finalizer alone for integers and
+// enumerations. Transparent like StringHash.
+//---------------------------------------------------------
+struct ConstexprHash {
+    using is_transparent = void;
+
+    constexpr std::size_t operator()(std::string_view s) const noexcept {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (char c : s) {
+            h = (h ^ (unsigned char) c) * 0x100000001b3ULL;
+        }
+        return fmix64(h);
+    }
+
+    template<class T, class = typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+    constexpr std::size_t operator()(T key) const noexcept {
+        return fmix64((std::uint64_t) key);
+    }
+};
+
+//-------------------------------------------------------
+// A value stored together with its full hash code, used by the tables when
+// StoreHash is set. Probes compare the hash codes before the values, and
+// rehashing reads the stored code instead of calling the hash again.
+//---------------------------------------------------------
+template<class Key>
+struct HashedValue {
+    std::size_t hash;
+    Key value;
+
+    HashedValue() : hash(0), value() {}
+
+    template<class... Args>
+    explicit HashedValue(std::size_t hash, Args &&... args) : hash(hash), value(std::forward<Args>(args)...) {}
+};
+
+#endif  // HASHTABLE_HASH_H
@@ -0,0 +1,507 @@
+#ifndef HASHTABLE_HOPSCOTCH_H
+#define HASHTABLE_HOPSCOTCH_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Hopscotch hashing. Every value lives within NEIGHBORHOOD cells of its home
+// cell, and each home cell keeps a bitmap of which cells of its neighborhood
+// hold its values, so a lookup reads only the cells whose bit is set. An
+// insert takes the first free cell after the home cell and, while it is
+// too far away, hops it backwards by moving a closer value into it.
+//
+// At most NEIGHBORHOOD values can share a home cell, so inserting one more
+// value with the same hash throws std::length_error instead of growing.
+template<class Key, class Hash=std::hash<Key>>
+class HopscotchHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+    // Cells a value can be away from its home cell, one bit of the bitmap each
+    static constexpr size_type NEIGHBORHOOD = 64;
+
+private:
+    struct Cell {
+        // Bit i is set when the cell i after this one holds a value whose
+        // home is this cell
+        std::uint64_t neighborhood = 0;
+        bool used = false;
+        Key value;
+    };
+
+    size_type number_of_cells;
+    float maximum_load_factor;
+    size_type count;
+
+    std::vector<Cell> table;
+
+    // Constants
+    static constexpr size_type DEFAULT_CELL_SIZE = 11;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.9f;
+
+    size_type home_of(const key_type &key) const;
+
+    size_type offset(size_type home, size_type index) const;
+
+    bool place(Key &value);
+
+    bool neighborhood_full(const key_type &value) const;
+
+    void resize(size_type cells);
+
+    bool is_prime(size_type num) const;
+
+public:
+    HopscotchHashTable();
+
+    HopscotchHashTable(size_type cells);
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    size_t table_size() const;
+
+    void make_empty();
+
+    bool insert(const value_type &value);
+
+    bool insert(value_type &&value);
+
+    size_t remove(const key_type &key);
+
+    bool contains(const key_type &key) const;
+
+    size_t position(const key_type &key) const;
+
+    bool rehash(size_type count);
+
+    float load_factor() const;
+
+    float max_load_factor() const;
+
+    void max_load_factor(float mlf);
+
+    void print_table(std::ostream &os = std::cout) const;
+};
+
+//-------------------------------------------------------
+// Name: HopscotchHashTable
+// PreCondition:
+// PostCondition: makes an empty table with 11 cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+HopscotchHashTable<Key, Hash>::HopscotchHashTable() : HopscotchHashTable(DEFAULT_CELL_SIZE) {
+}
+
+//-------------------------------------------------------
+// Name: HopscotchHashTable
+// PreCondition:  cells is greater than zero
+// PostCondition: makes an empty table with the specified number of
+// cells
+//---------------------------------------------------------
+template<class Key, class Hash>
+HopscotchHashTable<Key, Hash>::HopscotchHashTable(size_type cells) {
+    number_of_cells = cells;
+    maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    count = 0;
+    table.resize(number_of_cells);
+}
+
+//-------------------------------------------------------
+// Name: is_empty
+// PreCondition:
+// PostCondition: returns true if the table is empty.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool HopscotchHashTable<Key, Hash>::is_empty() const {
+    return count == 0;
+}
+
+//-------------------------------------------------------
+// Name: size
+// PreCondition:
+// PostCondition: returns the number of active values in the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t HopscotchHashTable<Key, Hash>::size() const {
+    return count;
+}
+
+//-------------------------------------------------------
+// Name: table_size
+// PreCondition:
+// PostCondition: return the number of cells in the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t HopscotchHashTable<Key, Hash>::table_size() const {
+    return number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: make_empty
+// PreCondition:
+// PostCondition: remove all values from the table. Do not change the
+// number of cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void HopscotchHashTable<Key, Hash>::make_empty() {
+    table.assign(number_of_cells, Cell());
+    count = 0;
+}
+
+//-------------------------------------------------------
+// Name: home_of
+// PreCondition:
+// PostCondition: returns the home cell of the value.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename HopscotchHashTable<Key, Hash>::size_type HopscotchHashTable<Key, Hash>::home_of(const key_type &key) const {
+    return Hash{}(key) % number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: offset
+// PreCondition:  home and index are valid cells
+// PostCondition: returns how many cells index is after home, wrapping
+// around the end of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename HopscotchHashTable<Key, Hash>::size_type
+HopscotchHashTable<Key, Hash>::offset(size_type home, size_type index) const {
+    return index >= home ? index - home : index + number_of_cells - home;
+}
+
+//-------------------------------------------------------
+// Name: insert
+// PreCondition:
+// PostCondition: insert the given value into the neighborhood of its
+// home cell, rehashing if the maximum load factor is
+// exceeded or no free cell can be moved close enough,
+// return true if insert was successful (false if item
+// already exists). Throws std::length_error, leaving
+// the value out, if growing cannot make room for it:
+// when NEIGHBORHOOD values with its hash fill its
+// neighborhood, or when the table already has
+// NEIGHBORHOOD cells per value.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool HopscotchHashTable<Key, Hash>::insert(const value_type &value) {
+    Key copy = value;
+    return insert(std::move(copy));
+}
+
+template<class Key, class Hash>
+bool HopscotchHashTable<Key, Hash>::insert(value_type &&value) {
+    if (contains(value)) {
+        return false;
+    }
+
+    if ((float) (count + 1) / (float) number_of_cells > maximum_load_factor) {
+        resize(number_of_cells * 2);
+    }
+    while (!place(value)) {
+        if (number_of_cells / NEIGHBORHOOD > count || neighborhood_full(value)) {
+            throw std::length_error("HopscotchHashTable neighborhood cannot hold another value with this hash");
+        }
+        resize(number_of_cells * 2);
+    }
+    count++;
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: neighborhood_full
+// PreCondition:
+// PostCondition: returns true if every cell of the neighborhood of the
+// home cell of value holds a value with the same hash,
+// which no table size can separate.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool HopscotchHashTable<Key, Hash>::neighborhood_full(const key_type &value) const {
+    size_type home = home_of(value);
+    if (table[home].neighborhood != ~std::uint64_t{0}) {
+        return false;
+    }
+
+    size_type hash_value = Hash{}(value);
+    for (size_type i = 0; i < NEIGHBORHOOD; i++) {
+        if (Hash{}(table[(home + i) % number_of_cells].value) != hash_value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: place
+// PreCondition:  value is not in the table and the table is not full
+// PostCondition: move the value into a cell of its neighborhood,
+// hopping the nearest free cell backwards until it is
+// in the neighborhood. Return false, with value
+// untouched, if the free cell cannot get close enough.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool HopscotchHashTable<Key, Hash>::place(Key &value) {
+    size_type home = home_of(value);
+
+    size_type free = home;
+    size_type distance = 0;
+    while (table[free].used) {
+        if (++distance == number_of_cells) {
+            return false;
+        }
+        free = free + 1 == number_of_cells ? 0 : free + 1;
+    }
+
+    while (distance >= NEIGHBORHOOD) {
+        // Move the value furthest from free whose own neighborhood still
+        // reaches it, starting with the homes furthest back
+        bool moved = false;
+        for (size_type back = NEIGHBORHOOD - 1; back > 0 && !moved; back--) {
+            size_type candidate = free >= back ? free - back : free + number_of_cells - back;
+            std::uint64_t before_free = table[candidate].neighborhood & ((std::uint64_t{1} << back) - 1);
+            if (before_free == 0) {
+                continue;
+            }
+
+            size_type hop = __builtin_ctzll(before_free);
+            size_type from = (candidate + hop) % number_of_cells;
+            table[free].value = std::move(table[from].value);
+            table[free].used = true;
+            table[candidate].neighborhood |= std::uint64_t{1} << back;
+            table[candidate].neighborhood &= ~(std::uint64_t{1} << hop);
+            table[from].used = false;
+
+            distance -= back - hop;
+            free = from;
+            moved = true;
+        }
+        if (!moved) {
+            return false;
+        }
+    }
+
+    table[free].value = std::move(value);
+    table[free].used = true;
+    table[home].neighborhood |= std::uint64_t{1} << distance;
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: is_prime()
+// PreCondition: num should be positive
+// PostCondition: returns the number is prime or not.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool HopscotchHashTable<Key, Hash>::is_prime(size_type num) const {
+    for (size_type i = 2; i * i <= num; i++)
+        if (num % i == 0) // Factor found
+            return false;
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: load_factor()
+// PreCondition:
+// PostCondition: return the current load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float HopscotchHashTable<Key, Hash>::load_factor() const {
+    return (float) size() / (float) table_size();
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:
+// PostCondition: return the current maximum load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float HopscotchHashTable<Key, Hash>::max_load_factor() const {
+    return maximum_load_factor;
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:
+// PostCondition: set the maximum load factor of the table, forces a
+// rehash if the new maximum is less than the current
+// load factor, throws std::invalid_argument if the
+// input is not between zero and one.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void HopscotchHashTable<Key, Hash>::max_load_factor(float mlf) {
+    if (!(mlf > 0.0f && mlf < 1.0f)) throw std::invalid_argument("Maximum load factor must be between 0 and 1");
+    maximum_load_factor = mlf;
+
+    if (load_factor() > maximum_load_factor) {
+        resize((size_type) ((float) size() / maximum_load_factor) + 1);
+    }
+}
+
+//-------------------------------------------------------
+// Name: remove
+// PreCondition:
+// PostCondition: remove the specified value from the table, return
+// number of elements removed (0 or 1). The cell is
+// simply freed, no deleted markers are needed.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t HopscotchHashTable<Key, Hash>::remove(const key_type &key) {
+    size_type index = position(key);
+    if (index >= number_of_cells) {
+        return 0;
+    }
+
+    size_type home = home_of(key);
+    table[home].neighborhood &= ~(std::uint64_t{1} << offset(home, index));
+    table[index].used = false;
+    count--;
+    return 1;
+}
+
+//-------------------------------------------------------
+// Name: contains
+// PreCondition:
+// PostCondition: returns Boolean true if the specified value is in the
+// table
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool HopscotchHashTable<Key, Hash>::contains(const key_type &key) const {
+    return position(key) < number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: rehash()
+// PreCondition:
+// PostCondition: set the number of cells to the specified value and
+// rehash the table if the total number of cells has
+// changed. Returns false without rehashing if the new
+// number of cells would exceed the maximum load factor.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool HopscotchHashTable<Key, Hash>::rehash(size_type table_size) {
+    //If the count is same, no need to rehash
+    if (table_size == number_of_cells) {
+        return false;
+    }
+
+    // Check for the load factor
+    if (((float) size() / (float) table_size) > maximum_load_factor) {
+        return false;
+    }
+
+    resize(table_size);
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: resize
+// PreCondition:  the values fit in cells under the maximum load factor
+// PostCondition: move every value into a new table of the given number
+// of cells, grown to the next prime. In the rare case
+// that a neighborhood overflows, the table is grown
+// again and the values placed once more.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void HopscotchHashTable<Key, Hash>::resize(size_type cells) {
+    std::vector<Key> values;
+    values.reserve(count);
+    for (Cell &cell : table) {
+        if (cell.used) {
+            values.push_back(std::move(cell.value));
+        }
+    }
+
+    while (!is_prime(cells)) {
+        cells++;
+    }
+
+    for (;;) {
+        number_of_cells = cells;
+        table.assign(number_of_cells, Cell());
+
+        size_type placed = 0;
+        while (placed < values.size() && place(values[placed])) {
+            placed++;
+        }
+        if (placed == values.size()) {
+            return;
+        }
+
+        // Gather the values placed so far and try a larger table
+        std::vector<Key> remaining;
+        remaining.reserve(values.size());
+        for (Cell &cell : table) {
+            if (cell.used) {
+                remaining.push_back(std::move(cell.value));
+            }
+        }
+        for (; placed < values.size(); placed++) {
+            remaining.push_back(std::move(values[placed]));
+        }
+        values.swap(remaining);
+
+        cells = number_of_cells * 2;
+        while (!is_prime(cells)) {
+            cells++;
+        }
+    }
+}
+
+//-------------------------------------------------------
+// Name: position
+// PreCondition:
+// PostCondition: return the index of the cell that contains the
+// specified value, or an invalid index if it is not in
+// the table. Only the cells marked in the bitmap of
+// the home cell are compared.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t HopscotchHashTable<Key, Hash>::position(const key_type &key) const {
+    size_type home = home_of(key);
+
+    for (std::uint64_t bits = table[home].neighborhood; bits != 0; bits &= bits - 1) {
+        size_type index = home + __builtin_ctzll(bits);
+        if (index >= number_of_cells) {
+            index -= number_of_cells;
+        }
+        if (table[index].value == key) {
+            return index;
+        }
+    }
+
+    // returning an invalid position
+    return number_of_cells + 1;
+}
+
+//-------------------------------------------------------
+// Name: print_table
+// PreCondition:
+// PostCondition: pretty print the table, the empty table should
+// print “<empty>\n”.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void HopscotchHashTable<Key, Hash>::print_table(std::ostream &os) const {
+    if (is_empty()) {
+        os << "<empty>\n";
+        return;
+    }
+    for (size_type i = 0; i < number_of_cells; i++) {
+        auto &cell = table[i];
+        if (cell.used) {
+            os << i << ": ";
+            os << cell.value;
+            os << std::endl;
+        }
+    }
+}
+
+#endif  // HASHTABLE_HOPSCOTCH_H
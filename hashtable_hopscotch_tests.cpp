@@ -0,0 +1,226 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "hashtable_hopscotch.h"
+
+void test_integer_1();
+
+void test_hop();
+
+void test_high_load();
+
+void test_same_hash();
+
+void test_strings();
+
+int main() {
+    test_integer_1();
+    test_hop();
+    test_high_load();
+    test_same_hash();
+    test_strings();
+    return 0;
+}
+
+void test_integer_1() {
+    const int INITIAL_SIZE = 0;
+    const int INITIAL_TABLE_SIZE = 11;
+    const int NUMBER_OF_INPUTS = 4;
+    const int NUMBER_OF_INPUTS_AFTER_REMOVE = 3;
+    const int INVALID_REHASH_VALUE = 1;
+    const int VALID_REHASH_VALUE = 53;
+
+    std::cout << "make an empty hopscotch table with 11 cells for ints" << std::endl;
+    HopscotchHashTable<int> table(INITIAL_TABLE_SIZE);
+
+    if (table.size() == INITIAL_SIZE && table.table_size() == INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed" << std::endl;
+    }
+
+    // 0, 11 and 22 share home cell 0, 1 already took the cell after it
+    table.insert(1);
+    table.insert(0);
+    table.insert(11);
+    table.insert(22);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(11)) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed" << std::endl;
+    }
+
+    if (table.position(1) == 1 && table.position(0) == 0 && table.position(11) == 2 &&
+        table.position(22) == 3) {
+        std::cout << "[PASSED] neighborhood test " << std::endl;
+    } else {
+        std::cout << "neighborhood test failed" << std::endl;
+    }
+
+    if (!table.contains(33) && table.position(33) > INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] contains non exist test " << std::endl;
+    } else {
+        std::cout << "contains non exist test failed" << std::endl;
+    }
+
+    table.remove(11);
+    if (table.size() == NUMBER_OF_INPUTS_AFTER_REMOVE && !table.contains(11) && table.position(22) == 3 &&
+        table.insert(33) && table.position(33) == 2) {
+        std::cout << "[PASSED] remove test " << std::endl;
+    } else {
+        std::cout << "remove test failed" << std::endl;
+    }
+
+    if (!table.rehash(INITIAL_TABLE_SIZE) && !table.rehash(INVALID_REHASH_VALUE) &&
+        table.rehash(VALID_REHASH_VALUE) && table.contains(0) && table.contains(22) && table.contains(1)) {
+        std::cout << "[PASSED] rehash test " << std::endl;
+    } else {
+        std::cout << "rehash test failed" << std::endl;
+    }
+
+    table.make_empty();
+    if (table.is_empty() && !table.contains(0)) {
+        std::cout << "[PASSED] make empty test " << std::endl;
+    } else {
+        std::cout << "make empty test failed" << std::endl;
+    }
+}
+
+void test_hop() {
+    const int TABLE_SIZE = 101;
+    const int FILLED_CELLS = 73;
+
+    std::cout << "hop a free cell back into the neighborhood of a hopscotch table" << std::endl;
+    HopscotchHashTable<int> table(TABLE_SIZE);
+
+    // Every value sits in its home cell, so the first free cell after
+    // cell 0 is 73, further away than the neighborhood reaches
+    for (int n = 0; n < FILLED_CELLS; n++) {
+        table.insert(n);
+    }
+    table.insert(TABLE_SIZE);
+
+    // 10 is the first value whose own neighborhood reaches cell 73, so it
+    // moves there and leaves its cell to 101
+    if (table.table_size() == TABLE_SIZE && table.position(TABLE_SIZE) == 10 && table.position(10) == 73 &&
+        table.position(9) == 9 && table.position(11) == 11) {
+        std::cout << "[PASSED] hop test " << std::endl;
+    } else {
+        std::cout << "hop test failed" << std::endl;
+    }
+}
+
+void test_high_load() {
+    const int NUMBER_OF_INPUTS = 100000;
+
+    std::cout << "fill a hopscotch table up to a load factor of 0.95" << std::endl;
+    HopscotchHashTable<int> table;
+    table.max_load_factor(0.95f);
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n * 7919);
+    }
+
+    bool all_found = true;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * 7919) && !table.contains(n * 7919 + 1);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS && table.load_factor() <= table.max_load_factor() &&
+        table.load_factor() > 0.4f) {
+        std::cout << "[PASSED] high load insert test " << std::endl;
+    } else {
+        std::cout << "high load insert test failed" << std::endl;
+    }
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        table.remove(n * 7919);
+    }
+
+    all_found = true;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * 7919) == (n % 2 == 1);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS / 2) {
+        std::cout << "[PASSED] high load remove test " << std::endl;
+    } else {
+        std::cout << "high load remove test failed" << std::endl;
+    }
+
+    try {
+        table.max_load_factor(1.5f);
+        std::cout << "invalid max load factor test failed" << std::endl;
+    } catch (std::invalid_argument &) {
+        std::cout << "[PASSED] invalid max load factor test " << std::endl;
+    }
+
+    table.max_load_factor(0.2f);
+    if (table.load_factor() <= 0.2f && table.contains(7919)) {
+        std::cout << "[PASSED] lower max load factor test " << std::endl;
+    } else {
+        std::cout << "lower max load factor test failed" << std::endl;
+    }
+}
+
+struct SameHash {
+    size_t operator()(int) const {
+        return 7;
+    }
+};
+
+void test_same_hash() {
+    const int NEIGHBORHOOD = 64;
+
+    std::cout << "insert more values with one hash than a neighborhood holds" << std::endl;
+    HopscotchHashTable<int, SameHash> table;
+    for (int n = 0; n < NEIGHBORHOOD; n++) {
+        table.insert(n);
+    }
+
+    // Growing would never separate them, so the table refuses the value
+    // and keeps the ones it has
+    bool thrown = false;
+    size_t cells = table.table_size();
+    try {
+        table.insert(NEIGHBORHOOD);
+    } catch (const std::length_error &) {
+        thrown = true;
+    }
+    bool all_found = table.size() == NEIGHBORHOOD && !table.contains(NEIGHBORHOOD);
+    for (int n = 0; n < NEIGHBORHOOD; n++) {
+        all_found = all_found && table.contains(n);
+    }
+
+    if (thrown && all_found && table.table_size() == cells) {
+        std::cout << "[PASSED] same hash test " << std::endl;
+    } else {
+        std::cout << "same hash test failed" << std::endl;
+    }
+}
+
+void test_strings() {
+    std::cout << "make an empty hopscotch table for strings" << std::endl;
+    HopscotchHashTable<std::string> table;
+    table.insert("Closer to the Heart");
+    table.insert("The Blacksmith and the Artist");
+    table.insert("Closer to the Heart");
+
+    std::stringstream ss;
+    table.print_table(ss);
+    if (table.size() == 2 && ss.str().find("The Blacksmith and the Artist") != std::string::npos) {
+        std::cout << "[PASSED] print table test " << std::endl;
+    } else {
+        std::cout << "print table test failed" << std::endl;
+    }
+
+    table.make_empty();
+    std::stringstream empty;
+    table.print_table(empty);
+    if (empty.str() == "<empty>\n") {
+        std::cout << "[PASSED] print empty table test " << std::endl;
+    } else {
+        std::cout << "print empty table test failed" << std::endl;
+    }
+}
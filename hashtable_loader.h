@@ -0,0 +1,415 @@
+#ifndef HASHTABLE_LOADER_H
+#define HASHTABLE_LOADER_H
+
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Fills a table, open addressing or separate chaining, from newline
+// separated keys in a file or on a pipe such as stdin. Regular files are
+// mapped and other input is read in large chunks, lines are cut out of the
+// chunks as string views and parsed into a batch of keys that is reused,
+// so no line costs an allocation of its own, and every full batch is
+// handed to insert_batch. A line is a std::string key as it is, without a
+// trailing '\r', or a decimal integer key. Empty lines are skipped.
+
+struct LoadOptions {
+    // Grow the table once, before the first insert, for the number of
+    // keys a regular file holds, estimated from its length and the lines
+    // near its start
+    bool presize = true;
+
+    // Keys handed to insert_batch at a time
+    std::size_t batch_size = 4096;
+
+    // Parse and hash the next batch on a thread of its own while the
+    // calling thread inserts the current one
+    bool hash_thread = false;
+};
+
+struct LoadStats {
+    // Non-empty lines read
+    std::size_t lines = 0;
+    // Keys that were not in the table yet
+    std::size_t inserted = 0;
+    // Lines that are not a key of the table's type
+    std::size_t rejected = 0;
+    std::size_t bytes = 0;
+    double seconds = 0;
+
+    double keys_per_second() const {
+        return seconds > 0 ? (double) lines / seconds : 0;
+    }
+};
+
+//-------------------------------------------------------
+// Turns a line into a key. Strings are assigned into the key, which keeps
+// its buffer from one batch to the next
+//---------------------------------------------------------
+template<class Key, class = void>
+struct KeyParser {
+    static bool parse(std::string_view line, Key &key) {
+        key.assign(line.data(), line.size());
+        return true;
+    }
+};
+
+template<class Key>
+struct KeyParser<Key, typename std::enable_if<std::is_integral<Key>::value>::type> {
+    static bool parse(std::string_view line, Key &key) {
+        auto result = std::from_chars(line.data(), line.data() + line.size(), key);
+        return result.ec == std::errc() && result.ptr == line.data() + line.size();
+    }
+};
+
+//-------------------------------------------------------
+// Name: for_each_line
+// PreCondition:
+// PostCondition: calls line(view) for every non-empty line of text, in
+// order, without the newline and any '\r' before it.
+//---------------------------------------------------------
+template<class Line>
+void for_each_line(std::string_view text, Line line) {
+    const char *p = text.data();
+    const char *end = p + text.size();
+    while (p < end) {
+        auto newline = static_cast<const char *>(std::memchr(p, '\n', (std::size_t) (end - p)));
+        const char *stop = newline != nullptr ? newline : end;
+        const char *last = stop > p && stop[-1] == '\r' ? stop - 1 : stop;
+        if (last > p) {
+            line(std::string_view(p, (std::size_t) (last - p)));
+        }
+        p = stop + 1;
+    }
+}
+
+//-------------------------------------------------------
+// Name: read_chunks
+// PreCondition:  fd is open for reading
+// PostCondition: calls chunk(text) for consecutive pieces of the input
+// that end just after a newline, the last one possibly
+// without, until chunk returns false. A piece is only
+// valid during its call.
+// Regular files are mapped whole, from their start,
+// and anything else is read into a buffer that grows
+// for lines longer than it.
+// Throws std::runtime_error if reading fails.
+//---------------------------------------------------------
+template<class Chunk>
+void read_chunks(int fd, Chunk chunk) {
+    const std::size_t CHUNK_BYTES = 1 << 20;
+
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        std::size_t length = (std::size_t) info.st_size;
+        void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            // Unmaps the file however chunk returns
+            struct Unmap {
+                void *mapping;
+                std::size_t length;
+
+                ~Unmap() {
+                    ::munmap(mapping, length);
+                }
+            } unmap{mapping, length};
+            ::madvise(mapping, length, MADV_SEQUENTIAL);
+
+            std::string_view text(static_cast<const char *>(mapping), length);
+            while (!text.empty()) {
+                std::size_t cut = text.size();
+                if (cut > CHUNK_BYTES) {
+                    std::size_t newline = text.find('\n', CHUNK_BYTES);
+                    cut = newline == std::string_view::npos ? text.size() : newline + 1;
+                }
+                if (!chunk(text.substr(0, cut))) {
+                    return;
+                }
+                text.remove_prefix(cut);
+            }
+            return;
+        }
+    }
+
+    std::vector<char> buffer(CHUNK_BYTES);
+    std::size_t kept = 0;
+    while (true) {
+        ssize_t n = ::read(fd, buffer.data() + kept, buffer.size() - kept);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("cannot read the keys");
+        }
+        if (n == 0) {
+            break;
+        }
+
+        std::size_t filled = kept + (std::size_t) n;
+        std::string_view text(buffer.data(), filled);
+        std::size_t newline = text.rfind('\n');
+        if (newline == std::string_view::npos) {
+            // A line longer than the buffer
+            kept = filled;
+            if (kept == buffer.size()) {
+                buffer.resize(2 * buffer.size());
+            }
+            continue;
+        }
+        if (!chunk(text.substr(0, newline + 1))) {
+            return;
+        }
+        kept = filled - newline - 1;
+        std::memmove(buffer.data(), buffer.data() + newline + 1, kept);
+    }
+    if (kept > 0) {
+        chunk(std::string_view(buffer.data(), kept));
+    }
+}
+
+//-------------------------------------------------------
+// Name: estimate_lines
+// PreCondition:  fd is open for reading
+// PostCondition: returns the number of lines a regular file holds,
+// estimated from its length and the lines of its first
+// SAMPLE_BYTES, or 0 for any other input. Leaves the
+// file offset where it was.
+//---------------------------------------------------------
+inline std::size_t estimate_lines(int fd) {
+    const std::size_t SAMPLE_BYTES = 1 << 16;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+        return 0;
+    }
+    std::vector<char> sample(SAMPLE_BYTES);
+    ssize_t n = ::pread(fd, sample.data(), sample.size(), 0);
+    if (n <= 0) {
+        return 0;
+    }
+    std::size_t newlines = 0;
+    for (ssize_t i = 0; i < n; i++) {
+        newlines += sample[i] == '\n';
+    }
+    if (newlines == 0) {
+        return 1;
+    }
+    return (std::size_t) ((double) info.st_size * (double) newlines / (double) n) + 1;
+}
+
+// One batch of parsed keys and, when they are hashed ahead, their hashes
+template<class Key>
+struct KeyBatch {
+    std::vector<Key> keys;
+    std::vector<std::size_t> hashes;
+    std::size_t n = 0;
+};
+
+//-------------------------------------------------------
+// Passes batches from the thread that parses and hashes them to the thread
+// that inserts them. There are BATCHES batches, so one can be filled while
+// another is inserted. The filling thread pushes nullptr after the last
+// batch, and the inserting thread closes the queue when it stops early.
+//---------------------------------------------------------
+template<class Key>
+class BatchQueue {
+public:
+    explicit BatchQueue(std::size_t batch_size) : batches(BATCHES) {
+        for (auto &batch : batches) {
+            batch.keys.resize(batch_size);
+            batch.hashes.resize(batch_size);
+            empty.push_back(&batch);
+        }
+    }
+
+    // A batch to fill, or nullptr once the queue is closed
+    KeyBatch<Key> *take_empty() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return closed || !empty.empty(); });
+        if (closed) {
+            return nullptr;
+        }
+        KeyBatch<Key> *batch = empty.back();
+        empty.pop_back();
+        return batch;
+    }
+
+    void push_full(KeyBatch<Key> *batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        full.push_back(batch);
+        changed.notify_all();
+    }
+
+    // The next filled batch, nullptr after the last one
+    KeyBatch<Key> *take_full() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return !full.empty(); });
+        KeyBatch<Key> *batch = full.front();
+        full.pop_front();
+        return batch;
+    }
+
+    void give_back(KeyBatch<Key> *batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        empty.push_back(batch);
+        changed.notify_all();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        changed.notify_all();
+    }
+
+private:
+    static constexpr std::size_t BATCHES = 3;
+
+    std::vector<KeyBatch<Key>> batches;
+    std::vector<KeyBatch<Key> *> empty;
+    std::deque<KeyBatch<Key> *> full;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+//-------------------------------------------------------
+// Name: load_keys
+// PreCondition:  fd is open for reading, Table is one of the tables
+// with a std::string or integer value_type
+// PostCondition: inserts the key of every line read from fd, as set
+// out by the options, and returns what was read and how
+// long it took. Throws std::runtime_error if reading
+// fails.
+//---------------------------------------------------------
+template<class Table>
+LoadStats load_keys(Table &table, int fd, const LoadOptions &options = LoadOptions()) {
+    using Key = typename Table::value_type;
+    using Hash = typename Table::hash;
+    using Clock = std::chrono::steady_clock;
+
+    auto start = Clock::now();
+    LoadStats stats;
+    const std::size_t batch_size = options.batch_size > 0 ? options.batch_size : 1;
+    if (options.presize) {
+        table.reserve(table.size() + estimate_lines(fd));
+    }
+
+    // Reads the input and parses its keys into batches, handing each full
+    // batch to flush, until flush returns no batch to fill next
+    auto parse_all = [&](LoadStats &counted, KeyBatch<Key> *batch, auto flush) {
+        read_chunks(fd, [&](std::string_view text) {
+            counted.bytes += text.size();
+            for_each_line(text, [&](std::string_view line) {
+                if (batch == nullptr) {
+                    return;
+                }
+                counted.lines++;
+                if (!KeyParser<Key>::parse(line, batch->keys[batch->n])) {
+                    counted.rejected++;
+                    return;
+                }
+                if (++batch->n == batch_size) {
+                    batch = flush(batch);
+                }
+            });
+            return batch != nullptr;
+        });
+        if (batch != nullptr && batch->n > 0) {
+            flush(batch);
+        }
+    };
+
+    if (!options.hash_thread) {
+        KeyBatch<Key> batch;
+        batch.keys.resize(batch_size);
+        parse_all(stats, &batch, [&](KeyBatch<Key> *full) {
+            stats.inserted += table.insert_batch(full->keys.data(), full->n);
+            full->n = 0;
+            return full;
+        });
+    } else {
+        BatchQueue<Key> queue(batch_size);
+        LoadStats parsed;
+        std::exception_ptr failure;
+        std::thread parser([&] {
+            try {
+                parse_all(parsed, queue.take_empty(), [&](KeyBatch<Key> *full) {
+                    for (std::size_t i = 0; i < full->n; i++) {
+                        full->hashes[i] = Hash{}(full->keys[i]);
+                    }
+                    queue.push_full(full);
+                    return queue.take_empty();
+                });
+            } catch (...) {
+                failure = std::current_exception();
+            }
+            queue.push_full(nullptr);
+        });
+
+        try {
+            while (KeyBatch<Key> *batch = queue.take_full()) {
+                stats.inserted += table.insert_batch(batch->keys.data(), batch->hashes.data(), batch->n);
+                batch->n = 0;
+                queue.give_back(batch);
+            }
+        } catch (...) {
+            queue.close();
+            parser.join();
+            throw;
+        }
+        parser.join();
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        stats.lines = parsed.lines;
+        stats.rejected = parsed.rejected;
+        stats.bytes = parsed.bytes;
+    }
+
+    stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return stats;
+}
+
+//-------------------------------------------------------
+// Name: load_keys
+// PreCondition:
+// PostCondition: the same for the file at path, or stdin when path is
+// "-". Throws std::runtime_error if the file cannot be
+// opened.
+//---------------------------------------------------------
+template<class Table>
+LoadStats load_keys(Table &table, const std::string &path, const LoadOptions &options = LoadOptions()) {
+    if (path == "-") {
+        return load_keys(table, STDIN_FILENO, options);
+    }
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    try {
+        LoadStats stats = load_keys(table, fd, options);
+        ::close(fd);
+        return stats;
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+#endif  // HASHTABLE_LOADER_H
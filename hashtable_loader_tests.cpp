@@ -0,0 +1,233 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "hashtable_loader.h"
+#include "hashtable_open_addressing.h"
+#include "hashtable_separate_chaining.h"
+
+using std::cout, std::endl;
+
+const std::string PATH = "hashtable_loader_keys.tmp";
+
+void test_lines();
+
+void test_file();
+
+void test_hash_thread();
+
+void test_pipe();
+
+void test_reserve();
+
+int main() {
+    test_lines();
+    test_file();
+    test_hash_thread();
+    test_pipe();
+    test_reserve();
+    return 0;
+}
+
+void test_lines() {
+    cout << "split text into lines" << endl;
+    std::vector<std::string> lines;
+    for_each_line("alpha\r\nbeta\n\n\ngamma\r\n\r\ndelta", [&](std::string_view line) {
+        lines.emplace_back(line);
+    });
+
+    if (lines == std::vector<std::string>{"alpha", "beta", "gamma", "delta"}) {
+        cout << "[PASSED] line split test " << endl;
+    } else {
+        cout << "line split test failed" << endl;
+    }
+
+    int parsed = 0;
+    bool valid = KeyParser<int>::parse("-42", parsed) && parsed == -42 && !KeyParser<int>::parse("4x", parsed) &&
+                 !KeyParser<int>::parse("99999999999", parsed);
+    std::string key = "a much longer key that leaves room";
+    bool assigned = KeyParser<std::string>::parse("short", key) && key == "short";
+    if (valid && assigned) {
+        cout << "[PASSED] key parse test " << endl;
+    } else {
+        cout << "key parse test failed" << endl;
+    }
+}
+
+void test_file() {
+    const int NUMBER_OF_KEYS = 20000;
+
+    cout << "load a file of keys into both tables" << endl;
+    {
+        std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+        for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+            out << n * 3 << "\n";
+        }
+        // A duplicate, a line that is not an integer and one without a
+        // newline at the end
+        out << "0\nnot a number\n" << NUMBER_OF_KEYS * 3;
+    }
+
+    open_addressing::HashTable<int> probed;
+    separate_chaining::HashTable<int> chained;
+    LoadOptions options;
+    options.batch_size = 100;
+    LoadStats probed_stats = load_keys(probed, PATH, options);
+    LoadStats chained_stats = load_keys(chained, PATH, options);
+
+    bool counted = probed_stats.lines == NUMBER_OF_KEYS + 3 && probed_stats.inserted == NUMBER_OF_KEYS + 1 &&
+                   probed_stats.rejected == 1 && probed_stats.seconds > 0 && probed_stats.keys_per_second() > 0 &&
+                   chained_stats.inserted == NUMBER_OF_KEYS + 1 && chained_stats.rejected == 1;
+    bool found = probed.size() == NUMBER_OF_KEYS + 1 && chained.size() == NUMBER_OF_KEYS + 1;
+    for (int n = 0; n <= NUMBER_OF_KEYS && found; n++) {
+        found = probed.contains(n * 3) && chained.contains(n * 3) && !probed.contains(n * 3 + 1);
+    }
+    if (counted && found) {
+        cout << "[PASSED] file load test " << endl;
+    } else {
+        cout << "file load test failed" << endl;
+    }
+
+    // Presizing leaves the table big enough for every key
+    open_addressing::HashTable<int> presized;
+    size_t before = presized.table_size();
+    load_keys(presized, PATH);
+    open_addressing::HashTable<int> unsized;
+    options.presize = false;
+    load_keys(unsized, PATH, options);
+    if (presized.table_size() > before && presized.size() == NUMBER_OF_KEYS + 1 &&
+        unsized.size() == NUMBER_OF_KEYS + 1) {
+        cout << "[PASSED] presize test " << endl;
+    } else {
+        cout << "presize test failed" << endl;
+    }
+
+    bool thrown = false;
+    try {
+        load_keys(probed, PATH + ".missing");
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    std::remove(PATH.c_str());
+    if (thrown) {
+        cout << "[PASSED] missing file test " << endl;
+    } else {
+        cout << "missing file test failed" << endl;
+    }
+}
+
+void test_hash_thread() {
+    const int NUMBER_OF_KEYS = 30000;
+
+    cout << "load strings with hashing on a second thread" << endl;
+    {
+        std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+        for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+            out << "key:" << n << "\r\n";
+        }
+    }
+
+    LoadOptions options;
+    options.hash_thread = true;
+    options.batch_size = 64;
+    open_addressing::HashTable<std::string, StringHash> probed;
+    separate_chaining::HashTable<std::string, StringHash> chained;
+    LoadStats probed_stats = load_keys(probed, PATH, options);
+    LoadStats chained_stats = load_keys(chained, PATH, options);
+    std::remove(PATH.c_str());
+
+    bool found = probed.size() == NUMBER_OF_KEYS && chained.size() == NUMBER_OF_KEYS &&
+                 probed_stats.inserted == NUMBER_OF_KEYS && chained_stats.lines == NUMBER_OF_KEYS;
+    for (int n = 0; n < NUMBER_OF_KEYS && found; n++) {
+        std::string key = "key:" + std::to_string(n);
+        found = probed.contains(key) && chained.contains(key) && !probed.contains(key + "\r");
+    }
+    if (found) {
+        cout << "[PASSED] hash thread test " << endl;
+    } else {
+        cout << "hash thread test failed" << endl;
+    }
+}
+
+void test_pipe() {
+    const int NUMBER_OF_KEYS = 50000;
+    const size_t LONG_KEY = 3 << 20;
+
+    cout << "load keys from a pipe, one longer than the read buffer" << endl;
+    int fds[2];
+    if (pipe(fds) != 0) {
+        cout << "pipe test failed" << endl;
+        return;
+    }
+    std::thread writer([&] {
+        std::string text;
+        for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+            text += std::to_string(n) + "\n";
+        }
+        text += std::string(LONG_KEY, 'x') + "\n";
+        for (int n = NUMBER_OF_KEYS; n < 2 * NUMBER_OF_KEYS; n++) {
+            text += std::to_string(n) + "\n";
+        }
+        for (size_t written = 0; written < text.size();) {
+            ssize_t n = write(fds[1], text.data() + written, text.size() - written);
+            if (n <= 0) {
+                break;
+            }
+            written += (size_t) n;
+        }
+        close(fds[1]);
+    });
+
+    LoadOptions options;
+    options.hash_thread = true;
+    separate_chaining::HashTable<std::string> table;
+    LoadStats stats = load_keys(table, fds[0], options);
+    writer.join();
+    close(fds[0]);
+
+    bool found = stats.inserted == 2 * NUMBER_OF_KEYS + 1 && table.contains(std::string(LONG_KEY, 'x'));
+    for (int n = 0; n < 2 * NUMBER_OF_KEYS && found; n++) {
+        found = table.contains(std::to_string(n));
+    }
+    if (found) {
+        cout << "[PASSED] pipe test " << endl;
+    } else {
+        cout << "pipe test failed" << endl;
+    }
+}
+
+void test_reserve() {
+    const size_t NUMBER_OF_KEYS = 1000;
+
+    cout << "reserve room and insert hashed batches" << endl;
+    open_addressing::HashTable<long> probed;
+    separate_chaining::HashTable<long> chained;
+    probed.reserve(NUMBER_OF_KEYS);
+    chained.reserve(NUMBER_OF_KEYS);
+    size_t cells = probed.table_size();
+    size_t buckets = chained.bucket_count();
+
+    std::vector<long> keys(NUMBER_OF_KEYS);
+    std::vector<size_t> hashes(NUMBER_OF_KEYS);
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        keys[i] = (long) (i % (NUMBER_OF_KEYS / 2)) * 11;
+        hashes[i] = std::hash<long>{}(keys[i]);
+    }
+    size_t probed_new = probed.insert_batch(keys.data(), hashes.data(), NUMBER_OF_KEYS);
+    size_t chained_new = chained.insert_batch(keys.data(), hashes.data(), NUMBER_OF_KEYS);
+
+    // Reserving less than the table holds changes nothing
+    probed.reserve(1);
+    chained.reserve(1);
+    if (probed_new == NUMBER_OF_KEYS / 2 && chained_new == NUMBER_OF_KEYS / 2 && probed.contains(11) &&
+        chained.contains(11) && !probed.contains(12) && cells >= 2 * NUMBER_OF_KEYS &&
+        probed.table_size() == cells && chained.bucket_count() == buckets) {
+        cout << "[PASSED] reserve test " << endl;
+    } else {
+        cout << "reserve test failed" << endl;
+    }
+}
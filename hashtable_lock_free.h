@@ -0,0 +1,681 @@
+#ifndef HASHTABLE_LOCK_FREE_H
+#define HASHTABLE_LOCK_FREE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include "hashtable_capacity.h"
+
+// Open addressing for integral keys that any number of threads can use at
+// once without locks. Every cell holds an atomic key and an atomic state.
+// A key is claimed for a cell with a compare and swap from EMPTY_KEY and
+// then never changes, so every key has exactly one cell per table; insert
+// and remove then only flip the state of that cell between ABSENT and
+// PRESENT. contains() never writes to the cells and never waits for other
+// threads: it reads at most every cell of each table it visits.
+//
+// Removed keys keep their cell, so claimed cells only go away when the
+// table is copied into a new one. That copy is cooperative: the thread
+// that finds too many cells claimed publishes a new table, and every
+// thread that meets it helps, taking chunks of cells to move. Each moved
+// cell is frozen first, by setting the MOVED bit of its state or claiming
+// an empty cell with FROZEN_KEY, so no update to it is lost. Updates only
+// go to the new table once every chunk is done, while contains() may
+// answer from a frozen cell until then.
+//
+// So only contains() is lock-free. insert() and remove() block during a
+// copy: a thread that finds no chunk left to take waits for the threads
+// still moving theirs, and if one of those is stopped, every writer waits
+// with it. Outside of copies writers never wait.
+//
+// A table that is no longer current is retired, not freed, since threads
+// that loaded it before may still be reading it. Retired tables are freed
+// by epochs: every member counts itself among the users of the epoch it
+// started in, the epoch only advances once no user of the one before it
+// is left, and a table retired in epoch e is freed from epoch e + 2 on,
+// when every thread that could have loaded it has returned. The users are
+// counted in USER_SLOTS counters on cache lines of their own, a thread
+// always using the same one, so that threads calling contains() do not
+// write to a line shared with each other. Whichever member returns last
+// frees the retired tables, so a contains() that follows a copy may free
+// them too.
+//
+// The two largest values of Key are reserved as EMPTY_KEY and FROZEN_KEY.
+template<class Key, class Hash=std::hash<Key>>
+class LockFreeHashTable {
+    static_assert(std::is_integral<Key>::value, "LockFreeHashTable needs an integral key");
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+    // Reserved keys, of a cell never claimed and of one frozen while empty
+    static constexpr Key EMPTY_KEY = std::numeric_limits<Key>::max();
+    static constexpr Key FROZEN_KEY = std::numeric_limits<Key>::max() - 1;
+
+private:
+    // State of a claimed cell, MOVED is set once it has been frozen
+    enum State : unsigned char {
+        ABSENT = 0, PRESENT = 1, MOVED = 2
+    };
+
+    struct Cell {
+        std::atomic<Key> key{EMPTY_KEY};
+        std::atomic<unsigned char> state{ABSENT};
+    };
+
+    struct Table {
+        size_type number_of_cells;
+        std::unique_ptr<Cell[]> cells;
+
+        // Cells with a key, including removed ones
+        std::atomic<size_type> claimed{0};
+
+        // The table being copied into, and the progress of the copy
+        std::atomic<Table *> next{nullptr};
+        std::atomic<size_type> next_chunk{0};
+        std::atomic<size_type> chunks_done{0};
+
+        // Once retired, the epoch it was retired in and the table retired
+        // before it
+        size_type retired_epoch = 0;
+        Table *retired_next = nullptr;
+
+        explicit Table(size_type cells) : number_of_cells(cells), cells(new Cell[cells]) {
+        }
+
+        size_type chunks() const {
+            return (number_of_cells + MIGRATION_CHUNK - 1) / MIGRATION_CHUNK;
+        }
+
+        bool migrated() const {
+            return chunks_done.load(std::memory_order_acquire) == chunks();
+        }
+    };
+
+    std::atomic<Table *> current;
+    std::atomic<size_type> count;
+
+    // Threads running a member, counted by the parity of the epoch they
+    // started in. Each slot on its own cache line so that threads counted
+    // in different slots do not contend for the line
+    struct alignas(64) Users {
+        std::atomic<size_type> count[2]{{0}, {0}};
+    };
+
+    // Number of slots the users are spread over
+    static constexpr size_type USER_SLOTS = 64;
+
+    // The epoch, the users of it and the tables no longer current
+    mutable std::atomic<size_type> epoch{0};
+    mutable std::array<Users, USER_SLOTS> users;
+    mutable std::atomic<Table *> retired{nullptr};
+    mutable std::atomic<size_type> retired_count{0};
+
+    // Counts the calling thread among the users for as long as it lives
+    class Use {
+    public:
+        explicit Use(const LockFreeHashTable &owner) : owner(owner), parity(owner.enter()) {
+        }
+
+        ~Use() {
+            owner.leave(parity);
+        }
+
+    private:
+        const LockFreeHashTable &owner;
+        size_type parity;
+    };
+
+    // Constants
+    static constexpr size_type DEFAULT_CELL_SIZE = 16;
+    static constexpr float MAX_CLAIMED_FACTOR = 0.5f;
+    static constexpr size_type MIGRATION_CHUNK = 1024;
+
+    static void check_key(const key_type &key);
+
+    Cell *find(Table *table, const key_type &key) const;
+
+    Cell *claim(Table *table, const key_type &key);
+
+    void start_migration(Table *table);
+
+    void help_migrate(Table *table);
+
+    void migrate_chunk(Table *table, size_type chunk);
+
+    void retire(Table *table);
+
+    std::atomic<size_type> &users_of_thread(size_type parity) const;
+
+    size_type users_of(size_type parity) const;
+
+    size_type enter() const;
+
+    void leave(size_type parity) const;
+
+public:
+    LockFreeHashTable();
+
+    LockFreeHashTable(size_type cells);
+
+    LockFreeHashTable(const LockFreeHashTable &other) = delete;
+
+    LockFreeHashTable &operator=(const LockFreeHashTable &other) = delete;
+
+    ~LockFreeHashTable();
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    size_t table_size() const;
+
+    bool insert(const value_type &value);
+
+    size_t remove(const key_type &key);
+
+    bool contains(const key_type &key) const;
+
+    float load_factor() const;
+
+    size_t retired_tables() const;
+};
+
+//-------------------------------------------------------
+// Name: LockFreeHashTable
+// PreCondition:
+// PostCondition: makes an empty table with 16 cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+LockFreeHashTable<Key, Hash>::LockFreeHashTable() : LockFreeHashTable(DEFAULT_CELL_SIZE) {
+}
+
+//-------------------------------------------------------
+// Name: LockFreeHashTable
+// PreCondition:  cells is greater than zero
+// PostCondition: makes an empty table with at least the specified
+// number of cells, rounded up to a power of two.
+//---------------------------------------------------------
+template<class Key, class Hash>
+LockFreeHashTable<Key, Hash>::LockFreeHashTable(size_type cells) : count(0) {
+    current = new Table(PowerOfTwoCapacity::round_up(cells));
+}
+
+//-------------------------------------------------------
+// Name: ~LockFreeHashTable
+// PreCondition:  no other thread uses the table
+// PostCondition: frees the current table, any newer one being copied
+// into and the retired ones.
+//---------------------------------------------------------
+template<class Key, class Hash>
+LockFreeHashTable<Key, Hash>::~LockFreeHashTable() {
+    for (Table *table = retired.load(); table != nullptr;) {
+        Table *older = table->retired_next;
+        delete table;
+        table = older;
+    }
+    for (Table *table = current.load(); table != nullptr;) {
+        Table *next = table->next.load();
+        delete table;
+        table = next;
+    }
+}
+
+//-------------------------------------------------------
+// Name: is_empty
+// PreCondition:
+// PostCondition: returns true if the table is empty.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool LockFreeHashTable<Key, Hash>::is_empty() const {
+    return size() == 0;
+}
+
+//-------------------------------------------------------
+// Name: size
+// PreCondition:
+// PostCondition: returns the number of values in the table. While
+// other threads change the table this is only a
+// snapshot.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t LockFreeHashTable<Key, Hash>::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------
+// Name: table_size
+// PreCondition:
+// PostCondition: return the number of cells in the current table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t LockFreeHashTable<Key, Hash>::table_size() const {
+    Use use(*this);
+    return current.load()->number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: load_factor
+// PreCondition:
+// PostCondition: returns the current load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float LockFreeHashTable<Key, Hash>::load_factor() const {
+    return (float) size() / (float) table_size();
+}
+
+//-------------------------------------------------------
+// Name: check_key
+// PreCondition:
+// PostCondition: throws std::invalid_argument if key is one of the
+// reserved keys.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void LockFreeHashTable<Key, Hash>::check_key(const key_type &key) {
+    if (key == EMPTY_KEY || key == FROZEN_KEY) {
+        throw std::invalid_argument("the two largest keys are reserved");
+    }
+}
+
+//-------------------------------------------------------
+// Name: find
+// PreCondition:
+// PostCondition: returns the cell of table claimed for key, or nullptr
+// if the probe reached an empty cell, a cell frozen while
+// empty or went round the whole table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename LockFreeHashTable<Key, Hash>::Cell *
+LockFreeHashTable<Key, Hash>::find(Table *table, const key_type &key) const {
+    size_type cells = table->number_of_cells;
+    size_type index = PowerOfTwoCapacity::index(Hash{}(key), cells);
+    for (size_type probes = 0; probes < cells; probes++) {
+        Key stored = table->cells[index].key.load(std::memory_order_acquire);
+        if (stored == key) {
+            return &table->cells[index];
+        }
+        if (stored == EMPTY_KEY || stored == FROZEN_KEY) {
+            return nullptr;
+        }
+        index = PowerOfTwoCapacity::next(index, cells);
+    }
+    return nullptr;
+}
+
+//-------------------------------------------------------
+// Name: claim
+// PreCondition:
+// PostCondition: returns the cell of table claimed for key, claiming
+// the first empty cell of its probe if there is none.
+// Returns nullptr if the probe reached a frozen cell or
+// went round the whole table, in which case the table
+// is being or needs to be copied.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename LockFreeHashTable<Key, Hash>::Cell *
+LockFreeHashTable<Key, Hash>::claim(Table *table, const key_type &key) {
+    size_type cells = table->number_of_cells;
+    size_type index = PowerOfTwoCapacity::index(Hash{}(key), cells);
+    for (size_type probes = 0; probes < cells; probes++) {
+        Cell &cell = table->cells[index];
+        Key stored = cell.key.load(std::memory_order_acquire);
+        if (stored == EMPTY_KEY) {
+            // On failure stored is reloaded with the key that won the cell
+            if (cell.key.compare_exchange_strong(stored, key, std::memory_order_acq_rel)) {
+                size_type claimed = table->claimed.fetch_add(1, std::memory_order_relaxed) + 1;
+                if ((float) claimed > (float) cells * MAX_CLAIMED_FACTOR) {
+                    start_migration(table);
+                }
+                return &cell;
+            }
+        }
+        if (stored == key) {
+            return &cell;
+        }
+        if (stored == FROZEN_KEY) {
+            return nullptr;
+        }
+        index = PowerOfTwoCapacity::next(index, cells);
+    }
+    start_migration(table);
+    return nullptr;
+}
+
+//-------------------------------------------------------
+// Name: insert
+// PreCondition:  value is not a reserved key
+// PostCondition: insert the given value into the table, helping with
+// any copy into a new table that is under way. Return
+// true if insert was successful (false if item already
+// exists).
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool LockFreeHashTable<Key, Hash>::insert(const value_type &value) {
+    check_key(value);
+    Use use(*this);
+    for (;;) {
+        Table *table = current.load();
+        if (table->next.load(std::memory_order_acquire) != nullptr) {
+            help_migrate(table);
+            continue;
+        }
+
+        Cell *cell = claim(table, value);
+        if (cell != nullptr) {
+            unsigned char state = ABSENT;
+            if (cell->state.compare_exchange_strong(state, PRESENT, std::memory_order_acq_rel)) {
+                count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (state == PRESENT) {
+                return false;
+            }
+        }
+        // The cell was frozen, so retry in the new table
+        help_migrate(table);
+    }
+}
+
+//-------------------------------------------------------
+// Name: remove
+// PreCondition:  key is not a reserved key
+// PostCondition: remove the specified value from the table, return
+// number of elements removed (0 or 1). The cell keeps
+// its key until the next copy.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t LockFreeHashTable<Key, Hash>::remove(const key_type &key) {
+    check_key(key);
+    Use use(*this);
+    for (;;) {
+        Table *table = current.load();
+        if (table->next.load(std::memory_order_acquire) != nullptr) {
+            help_migrate(table);
+            continue;
+        }
+
+        Cell *cell = find(table, key);
+        if (cell == nullptr) {
+            // A probe ending at a frozen cell says nothing about the table
+            // that replaces this one
+            if (table->next.load(std::memory_order_acquire) == nullptr) {
+                return 0;
+            }
+            continue;
+        }
+
+        unsigned char state = PRESENT;
+        if (cell->state.compare_exchange_strong(state, ABSENT, std::memory_order_acq_rel)) {
+            count.fetch_sub(1, std::memory_order_relaxed);
+            return 1;
+        }
+        if (state == ABSENT) {
+            return 0;
+        }
+        help_migrate(table);
+    }
+}
+
+//-------------------------------------------------------
+// Name: contains
+// PreCondition:
+// PostCondition: returns Boolean true if the specified value is in the
+// table. Never writes to the cells and never waits for
+// other threads: it only counts itself in the users
+// slot of its thread, and frees retired tables if it
+// returns last after a copy. A frozen cell is the
+// answer as long as the copy it belongs to is not
+// finished, since no update reaches the new table
+// before that.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool LockFreeHashTable<Key, Hash>::contains(const key_type &key) const {
+    if (key == EMPTY_KEY || key == FROZEN_KEY) {
+        return false;
+    }
+
+    Use use(*this);
+    Table *table = current.load();
+    for (;;) {
+        Cell *cell = find(table, key);
+        bool present = cell != nullptr && (cell->state.load(std::memory_order_acquire) & PRESENT);
+
+        Table *next = table->next.load(std::memory_order_acquire);
+        if (next == nullptr || !table->migrated()) {
+            return present;
+        }
+        table = next;
+    }
+}
+
+//-------------------------------------------------------
+// Name: start_migration
+// PreCondition:
+// PostCondition: publishes a new table for table to be copied into,
+// unless another thread already has. The new table has
+// four cells per value so it starts a quarter full.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void LockFreeHashTable<Key, Hash>::start_migration(Table *table) {
+    if (table->next.load(std::memory_order_acquire) != nullptr) {
+        return;
+    }
+
+    size_type cells = PowerOfTwoCapacity::round_up(4 * count.load(std::memory_order_relaxed) + DEFAULT_CELL_SIZE);
+    if (cells < table->number_of_cells) {
+        cells = table->number_of_cells;
+    }
+
+    Table *next = new Table(cells);
+    Table *expected = nullptr;
+    if (!table->next.compare_exchange_strong(expected, next, std::memory_order_acq_rel)) {
+        delete next;
+    }
+}
+
+//-------------------------------------------------------
+// Name: help_migrate
+// PreCondition:  a new table has been published for table
+// PostCondition: copies chunks of table until none are left, waits
+// for the other helpers to finish theirs and makes the
+// new table current, retiring table. The wait is what
+// makes writers block during a copy.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void LockFreeHashTable<Key, Hash>::help_migrate(Table *table) {
+    Table *next = table->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        start_migration(table);
+        next = table->next.load(std::memory_order_acquire);
+    }
+
+    size_type chunks = table->chunks();
+    for (size_type chunk = table->next_chunk.fetch_add(1, std::memory_order_relaxed); chunk < chunks;
+         chunk = table->next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+        migrate_chunk(table, chunk);
+        table->chunks_done.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    while (!table->migrated()) {
+        std::this_thread::yield();
+    }
+
+    Table *expected = table;
+    if (current.compare_exchange_strong(expected, next)) {
+        retire(table);
+    }
+}
+
+//-------------------------------------------------------
+// Name: migrate_chunk
+// PreCondition:  the chunk is taken by the calling thread only
+// PostCondition: freezes every cell of the chunk and copies the keys
+// that were present into the new table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void LockFreeHashTable<Key, Hash>::migrate_chunk(Table *table, size_type chunk) {
+    Table *next = table->next.load(std::memory_order_acquire);
+    size_type end = std::min((chunk + 1) * MIGRATION_CHUNK, table->number_of_cells);
+
+    for (size_type i = chunk * MIGRATION_CHUNK; i < end; i++) {
+        Cell &cell = table->cells[i];
+
+        Key key = EMPTY_KEY;
+        if (cell.key.compare_exchange_strong(key, FROZEN_KEY, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        unsigned char state = cell.state.fetch_or(MOVED, std::memory_order_acq_rel);
+        if (state == PRESENT) {
+            // Keys are unique and only this thread copies this one, so the
+            // new cell can be claimed and filled without contention
+            Cell *target = claim(next, key);
+            target->state.store(PRESENT, std::memory_order_release);
+        }
+    }
+}
+
+//-------------------------------------------------------
+// Name: retire
+// PreCondition:  table has just stopped being current
+// PostCondition: adds table to the retired tables, to be freed two
+// epochs from now.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void LockFreeHashTable<Key, Hash>::retire(Table *table) {
+    table->retired_epoch = epoch.load();
+    retired_count.fetch_add(1, std::memory_order_relaxed);
+    table->retired_next = retired.load();
+    while (!retired.compare_exchange_weak(table->retired_next, table)) {
+    }
+}
+
+//-------------------------------------------------------
+// Name: users_of_thread
+// PreCondition:
+// PostCondition: returns the counter of users of the given parity in
+// the slot of the calling thread. Threads are given the
+// slots in turn when they first call it, so up to
+// USER_SLOTS threads each count in a slot of their own.
+//---------------------------------------------------------
+template<class Key, class Hash>
+std::atomic<typename LockFreeHashTable<Key, Hash>::size_type> &
+LockFreeHashTable<Key, Hash>::users_of_thread(size_type parity) const {
+    static std::atomic<size_type> threads{0};
+    thread_local size_type slot = threads.fetch_add(1, std::memory_order_relaxed) % USER_SLOTS;
+    return users[slot].count[parity];
+}
+
+//-------------------------------------------------------
+// Name: users_of
+// PreCondition:
+// PostCondition: returns the number of users counted under the given
+// parity, over every slot.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename LockFreeHashTable<Key, Hash>::size_type LockFreeHashTable<Key, Hash>::users_of(size_type parity) const {
+    size_type total = 0;
+    for (const Users &slot : users) {
+        total += slot.count[parity].load();
+    }
+    return total;
+}
+
+//-------------------------------------------------------
+// Name: enter
+// PreCondition:
+// PostCondition: counts the calling thread among the users of the
+// current epoch and returns the parity it is counted
+// under. The count is only kept if the epoch did not
+// advance meanwhile, so a thread is never counted under
+// an epoch that has already been waited for.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename LockFreeHashTable<Key, Hash>::size_type LockFreeHashTable<Key, Hash>::enter() const {
+    for (;;) {
+        size_type started = epoch.load();
+        std::atomic<size_type> &counted = users_of_thread(started & 1);
+        counted.fetch_add(1);
+        if (epoch.load() == started) {
+            return started & 1;
+        }
+        counted.fetch_sub(1);
+    }
+}
+
+//-------------------------------------------------------
+// Name: leave
+// PreCondition:  the calling thread was counted under parity by enter
+// PostCondition: stops counting it. If tables are retired, advances
+// the epoch past any epoch with no users left, at most
+// twice, and frees the retired tables that are two
+// epochs old. If tables are left and no thread is
+// counted, tries again, since a thread that left
+// meanwhile may have found none.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void LockFreeHashTable<Key, Hash>::leave(size_type parity) const {
+    users_of_thread(parity).fetch_sub(1);
+
+    while (retired.load() != nullptr) {
+        for (int step = 0; step < 2; step++) {
+            size_type now = epoch.load();
+            if (users_of((now + 1) & 1) != 0 || !epoch.compare_exchange_strong(now, now + 1)) {
+                break;
+            }
+        }
+
+        size_type now = epoch.load();
+        Table *taken = retired.exchange(nullptr);
+        Table *kept = nullptr;
+        Table *last_kept = nullptr;
+        while (taken != nullptr) {
+            Table *older = taken->retired_next;
+            if (taken->retired_epoch + 2 <= now) {
+                delete taken;
+                retired_count.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+                taken->retired_next = kept;
+                kept = taken;
+                if (last_kept == nullptr) {
+                    last_kept = taken;
+                }
+            }
+            taken = older;
+        }
+        if (kept == nullptr) {
+            return;
+        }
+
+        last_kept->retired_next = retired.load();
+        while (!retired.compare_exchange_weak(last_kept->retired_next, kept)) {
+        }
+        if (users_of(0) + users_of(1) != 0) {
+            return;
+        }
+    }
+}
+
+//-------------------------------------------------------
+// Name: retired_tables
+// PreCondition:
+// PostCondition: returns the number of replaced tables not freed yet,
+// which is zero whenever no other thread uses the table.
+// While threads keep using it, a few epochs' worth.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t LockFreeHashTable<Key, Hash>::retired_tables() const {
+    return retired_count.load(std::memory_order_relaxed);
+}
+
+#endif  // HASHTABLE_LOCK_FREE_H
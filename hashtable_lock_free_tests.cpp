@@ -0,0 +1,271 @@
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "hashtable_lock_free.h"
+
+void test_integer_1();
+
+void test_racing_inserts();
+
+void test_owned_keys();
+
+void test_readers_during_growth();
+
+void test_churn();
+
+int main() {
+    test_integer_1();
+    test_racing_inserts();
+    test_owned_keys();
+    test_readers_during_growth();
+    test_churn();
+    return 0;
+}
+
+void test_integer_1() {
+    const int INITIAL_SIZE = 0;
+    const int INITIAL_TABLE_SIZE = 16;
+    const int NUMBER_OF_INPUTS = 3;
+    const int NUMBER_OF_INPUTS_AFTER_REMOVE = 2;
+    const int GROWN_INPUTS = 1000;
+
+    std::cout << "make an empty lock free hash table with 16 cells for ints" << std::endl;
+    LockFreeHashTable<int> table;
+
+    if (table.size() == INITIAL_SIZE && table.is_empty() && table.table_size() == INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed " << std::endl;
+    }
+
+    table.insert(5);
+    table.insert(3);
+    table.insert(-6);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(3) && table.contains(5) && table.contains(-6)
+        && !table.contains(4)) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed " << std::endl;
+    }
+
+    // A removed key keeps its cell and can be inserted again
+    if (table.remove(3) == 1 && table.remove(3) == 0 && table.size() == NUMBER_OF_INPUTS_AFTER_REMOVE
+        && !table.contains(3) && table.insert(3) && table.contains(3) && table.remove(3) == 1) {
+        std::cout << "[PASSED] remove test " << std::endl;
+    } else {
+        std::cout << "remove test failed " << std::endl;
+    }
+
+    for (int n = 0; n < GROWN_INPUTS; n++) {
+        table.insert(n * 7);
+    }
+    bool all_found = table.table_size() >= 2 * GROWN_INPUTS && table.contains(-6);
+    for (int n = 0; n < GROWN_INPUTS; n++) {
+        all_found = all_found && table.contains(n * 7) && !table.contains(n * 7 + 1);
+    }
+
+    if (all_found) {
+        std::cout << "[PASSED] grow test " << std::endl;
+    } else {
+        std::cout << "grow test failed " << std::endl;
+    }
+
+    try {
+        table.insert(LockFreeHashTable<int>::EMPTY_KEY);
+        std::cout << "reserved key test failed " << std::endl;
+    } catch (const std::invalid_argument &) {
+        std::cout << "[PASSED] reserved key test " << std::endl;
+    }
+}
+
+void test_racing_inserts() {
+    const int NUMBER_OF_THREADS = 8;
+    const int NUMBER_OF_INPUTS = 50000;
+
+    std::cout << "insert and remove the same keys from every thread" << std::endl;
+    LockFreeHashTable<long> table;
+
+    // Every key must be inserted, and later removed, by exactly one thread
+    std::atomic<long> inserted{0};
+    std::atomic<long> removed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUMBER_OF_THREADS; t++) {
+        threads.emplace_back([&]() {
+            long wins = 0;
+            for (long n = 0; n < NUMBER_OF_INPUTS; n++) {
+                wins += table.insert(n);
+            }
+            inserted += wins;
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    bool size_after_insert = table.size() == NUMBER_OF_INPUTS;
+
+    threads.clear();
+    for (int t = 0; t < NUMBER_OF_THREADS; t++) {
+        threads.emplace_back([&]() {
+            long wins = 0;
+            for (long n = 0; n < NUMBER_OF_INPUTS; n++) {
+                wins += table.remove(n);
+            }
+            removed += wins;
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    if (size_after_insert && inserted == NUMBER_OF_INPUTS && removed == NUMBER_OF_INPUTS && table.is_empty()) {
+        std::cout << "[PASSED] racing inserts test " << std::endl;
+    } else {
+        std::cout << "racing inserts test failed " << inserted << " " << removed << std::endl;
+    }
+}
+
+void test_owned_keys() {
+    const int NUMBER_OF_THREADS = 8;
+    const int KEYS_PER_THREAD = 2000;
+    const int ROUNDS = 20;
+
+    std::cout << "check every result against a per thread model while the table grows" << std::endl;
+    LockFreeHashTable<int> table;
+
+    // Each thread owns its keys, so the results of its operations must be
+    // exactly those of a sequential set, whatever the other threads do
+    std::vector<char> failed(NUMBER_OF_THREADS, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUMBER_OF_THREADS; t++) {
+        threads.emplace_back([&table, &failed, t]() {
+            std::vector<char> model(KEYS_PER_THREAD, 0);
+            unsigned random = t + 1;
+            for (int i = 0; i < ROUNDS * KEYS_PER_THREAD; i++) {
+                random = random * 1103515245 + 12345;
+                int n = (random >> 8) % KEYS_PER_THREAD;
+                int key = n * NUMBER_OF_THREADS + t;
+                switch (random >> 28 & 3) {
+                    case 0:
+                    case 1:
+                        failed[t] |= table.insert(key) != !model[n];
+                        model[n] = 1;
+                        break;
+                    case 2:
+                        failed[t] |= table.remove(key) != (size_t) model[n];
+                        model[n] = 0;
+                        break;
+                    default:
+                        failed[t] |= table.contains(key) != (bool) model[n];
+                }
+            }
+            for (int n = 0; n < KEYS_PER_THREAD; n++) {
+                failed[t] |= table.contains(n * NUMBER_OF_THREADS + t) != (bool) model[n];
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    bool all_correct = true;
+    for (char fail : failed) {
+        all_correct = all_correct && !fail;
+    }
+
+    if (all_correct) {
+        std::cout << "[PASSED] owned keys test " << std::endl;
+    } else {
+        std::cout << "owned keys test failed " << std::endl;
+    }
+}
+
+void test_readers_during_growth() {
+    const int NUMBER_OF_WRITERS = 4;
+    const int NUMBER_OF_READERS = 4;
+    const int NUMBER_OF_INPUTS = 50000;
+    const int STABLE_KEYS = 1000;
+
+    std::cout << "read keys that never change while writers grow the table" << std::endl;
+    LockFreeHashTable<int> table;
+    for (int n = 1; n <= STABLE_KEYS; n++) {
+        table.insert(-n);
+    }
+
+    std::atomic<bool> writing{true};
+    std::atomic<int> misses{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < NUMBER_OF_READERS; t++) {
+        readers.emplace_back([&]() {
+            while (writing) {
+                for (int n = 1; n <= STABLE_KEYS; n++) {
+                    misses += !table.contains(-n);
+                    misses += table.contains(-n - STABLE_KEYS);
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < NUMBER_OF_WRITERS; t++) {
+        writers.emplace_back([&table, t]() {
+            for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+                table.insert(n * NUMBER_OF_WRITERS + t);
+            }
+        });
+    }
+    for (std::thread &writer : writers) {
+        writer.join();
+    }
+    writing = false;
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+
+    if (misses == 0 && table.size() == STABLE_KEYS + NUMBER_OF_WRITERS * NUMBER_OF_INPUTS) {
+        std::cout << "[PASSED] readers during growth test " << std::endl;
+    } else {
+        std::cout << "readers during growth test failed " << misses << std::endl;
+    }
+}
+
+void test_churn() {
+    const int NUMBER_OF_THREADS = 4;
+    const int NUMBER_OF_INPUTS = 300000;
+    const int LIVE_KEYS = 64;
+    const size_t MAX_RETIRED = 512;
+
+    std::cout << "insert and remove ever new keys, replacing the table many times" << std::endl;
+    LockFreeHashTable<int> table;
+    std::atomic<size_t> most_retired{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUMBER_OF_THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+                table.insert(n * NUMBER_OF_THREADS + t);
+                if (n >= LIVE_KEYS) {
+                    table.remove((n - LIVE_KEYS) * NUMBER_OF_THREADS + t);
+                }
+                size_t retired = table.retired_tables();
+                if (retired > most_retired) {
+                    most_retired = retired;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    // Each key claims a cell of its own, so the table was replaced about
+    // 1500 times. Old tables only wait for threads stopped in the middle
+    // of a member, so far fewer of them are ever held at once
+    if (table.size() == NUMBER_OF_THREADS * LIVE_KEYS && table.table_size() <= 4 * 1024 &&
+        table.retired_tables() == 0 && most_retired <= MAX_RETIRED) {
+        std::cout << "[PASSED] churn test " << std::endl;
+    } else {
+        std::cout << "churn test failed " << most_retired << std::endl;
+    }
+}
@@ -1,9 +1,31 @@
 #ifndef HASHTABLE_OPEN_ADDRESSING_H
 #define HASHTABLE_OPEN_ADDRESSING_H
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hashtable_capacity.h"
+#include "hashtable_hash.h"
+#include "hashtable_parallel.h"
+#include "hashtable_probe.h"
+
+// In a namespace of its own so that a program can use this table and the
+// separate chaining one side by side
+namespace open_addressing {
 
 template<typename Key>
 struct S {
@@ -16,14 +38,75 @@ bool operator==(const S<Key> &lhs, const S<Key> &rhs) {
 }
 
 template<typename Key>
-struct std::hash<S<Key>> {
-    std::size_t operator()(S<Key> const &s) const noexcept {
-        std::size_t h = std::hash<std::string>{}(s.key);
-        return h;
+bool operator==(const S<Key> &lhs, std::string_view rhs) {
+    return lhs.key == rhs;
+}
+
+}  // namespace open_addressing
+
+// Transparent, so a table of S<Key> can be searched by the key alone
+template<typename Key>
+struct std::hash<open_addressing::S<Key>> {
+    using is_transparent = void;
+
+    std::size_t operator()(open_addressing::S<Key> const &s) const noexcept {
+        return std::hash<Key>{}(s.key);
+    }
+
+    std::size_t operator()(std::string_view key) const noexcept {
+        return std::hash<std::string_view>{}(key);
+    }
+};
+
+namespace open_addressing {
+
+// Start of a file written by HashTable::save, followed directly by the
+// cells exactly as they are laid out in memory. Everything open_mapped
+// needs to tell whether the cells fit the table type reading them is here
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    // SNAPSHOT_BYTE_ORDER as written by the saving machine
+    std::uint32_t byte_order;
+    std::uint64_t key_size;
+    std::uint64_t cell_size;
+    std::uint64_t store_hash;
+    std::uint64_t cells;
+    std::uint64_t count;
+    // The seed member of the Hash, 0 for a hash without one
+    std::uint64_t hash_seed;
+    // A cell holding a value and the hash of that value, which tells a
+    // different hash or probe sequence apart. check_cell is cells when
+    // the table is empty
+    std::uint64_t check_cell;
+    std::uint64_t check_hash;
+};
+
+const char SNAPSHOT_MAGIC[8] = {'O', 'A', 'H', 'T', 'S', 'N', 'A', 'P'};
+const std::uint32_t SNAPSHOT_VERSION = 2;
+const std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+// The seed of a hash such as SeededHash, 0 for hashes without one
+template<class Hash, class = void>
+struct HashSeed {
+    static std::uint64_t of(const Hash &) {
+        return 0;
+    }
+};
+
+template<class Hash>
+struct HashSeed<Hash, std::void_t<decltype(std::declval<const Hash &>().seed)>> {
+    static std::uint64_t of(const Hash &hash) {
+        return (std::uint64_t) hash.seed;
     }
 };
 
-template<class Key, class Hash=std::hash<Key>>
+template<class Key, class Hash=std::hash<Key>, class Capacity=PrimeCapacity, bool StoreHash=false,
+        class Probe=LinearProbe>
+class MappedHashTable;
+
+template<class Key, class Hash=std::hash<Key>, class Capacity=PrimeCapacity, bool StoreHash=false,
+        class Probe=LinearProbe>
 class HashTable {
 public:
     // Member Types - do not modify
@@ -33,27 +116,59 @@ public:
     using size_type = size_t;
     // you can write your code below this
 
+    static_assert(Probe::template max_load_factor<Capacity>() > 0.0f,
+                  "the probe sequence cannot be used with this capacity policy");
+
+    // State of a cell, DELETED marks a removed value so that probe
+    // sequences running through the cell stay intact. Scoped, with EMPTY
+    // as zero, so that a cell state is never read as an occupancy flag
+    enum class EntryType {
+        EMPTY, ACTIVE, DELETED
+    };
+
+    // What a cell holds, the value alone or, with StoreHash, the value
+    // together with its hash code
+    using stored_type = typename std::conditional<StoreHash, HashedValue<Key>, Key>::type;
+    using cell_type = std::pair<EntryType, stored_type>;
+
 private:
     size_type number_of_cells;
     float maximum_load_factor;
     size_type count;
+    size_type deleted_count;
 
     // The pointer to the hash table
-    std::vector<std::pair<bool, Key>> table;
+    std::vector<cell_type> table;
+
+    // Cells being emptied by an incremental rehash, the cells before
+    // migrated_cells have already been moved into table
+    std::vector<cell_type> old_table;
+    size_type migrated_cells;
+    bool incremental;
 
     // Constants
     const size_type DEFAULT_CELL_SIZE = 11;
     const float DEFAULT_MAX_LOAD_FACTOR = 0.5f;
+    const size_type MIGRATION_STEP = 16;
+
+    // Keys hashed and prefetched together by the batch operations
+    static constexpr size_type BATCH_SIZE = 16;
 
 public:
     HashTable();
 
     HashTable(const HashTable &other);
 
+    HashTable(HashTable &&other);
+
     ~HashTable();
 
     HashTable &operator=(const HashTable &other);
 
+    HashTable &operator=(HashTable &&other);
+
+    void swap(HashTable &other);
+
     HashTable(size_type cells);
 
     bool is_empty() const;
@@ -66,45 +181,165 @@ public:
 
     bool insert(const value_type &value);
 
+    bool insert(value_type &&value);
+
+    template<class... Args>
+    bool emplace(Args &&... args);
+
     size_t remove(const key_type &key);
 
     bool contains(const key_type &key);
 
     size_t position(const key_type &key) const;
 
+    // Lookups by any type a transparent Hash accepts, such as a
+    // std::string_view into a table of std::string with StringHash
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    size_t remove(const K &key);
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    bool contains(const K &key);
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    size_t position(const K &key) const;
+
     bool rehash(size_type count);
 
+    // Rehash with the values moved by num_threads threads, or one per
+    // hardware thread when it is zero
+    bool rehash(size_type count, size_type num_threads);
+
+    // Make room for the given number of values, so that inserting them
+    // into an empty table never rehashes
+    void reserve(size_type values);
+
     float load_factor() const;
 
+    float max_load_factor() const;
+
+    void max_load_factor(float mlf);
+
     bool is_prime(size_type num);
 
-    std::vector<std::pair<bool, Key>> get_table();
+    std::vector<cell_type> get_table();
 
     void print_table(std::ostream &os = std::cout) const;
 
-    // Optional
-    // HashTable(HashTable&& other);
-    // HashTable& operator=(HashTable&& other);
-    // bool insert(value_type&& value);
+    bool incremental_rehash() const;
+
+    void incremental_rehash(bool enabled);
+
+    size_t migration_debt() const;
+
+    // Operations on many independent keys. Each group of keys is hashed
+    // and has its home cells prefetched before the first one is probed,
+    // so the cache misses of the group overlap
+    size_t insert_batch(const value_type *values, size_type n);
+
+    // The same with hashes[i] the hash of values[i], computed ahead by the
+    // caller, for example on another thread
+    size_t insert_batch(const value_type *values, const size_type *hashes, size_type n);
+
+    size_t contains_batch(const key_type *keys, size_type n);
+
+    size_t contains_batch(const key_type *keys, size_type n, std::vector<bool> &found);
+
+    size_t remove_batch(const key_type *keys, size_type n);
+
+    // Replace the values with the keys of a random access range. The
+    // table is sized once for all of them and filled by num_threads
+    // threads, or one per hardware thread when it is zero
+    template<class Iterator>
+    void build(Iterator first, Iterator last, size_type num_threads = 0);
+
+    // Write the cells to a file that open_mapped serves lookups from in
+    // place, for trivially copyable keys
+    void save(const std::string &path);
+
+    static MappedHashTable<Key, Hash, Capacity, StoreHash, Probe> open_mapped(const std::string &path);
+
+private:
+    friend class MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>;
+
+    template<class Value>
+    bool place(Value &&value);
+
+    template<class Value>
+    bool place_hashed(size_type hash_value, Value &&value);
+
+    template<class K>
+    size_t remove_key(const K &key);
+
+    template<class K>
+    size_t remove_hashed(size_type hash_value, const K &key);
+
+    template<class K>
+    bool contains_key(const K &key);
+
+    template<class K>
+    bool contains_hashed(size_type hash_value, const K &key);
+
+    template<class Operation>
+    size_t for_each_prefetched(const key_type *keys, size_type n, Operation operation);
+
+    template<class K>
+    size_t position_of(const K &key) const;
+
+    template<class K>
+    size_type find(const std::vector<cell_type> &cells, size_type hash_value, const K &key) const;
+
+    template<class K>
+    static size_type find(const cell_type *cells, size_type number, size_type hash_value, const K &key);
+
+    template<class Visit>
+    static size_type probe(size_type hash_value, size_type cells, Visit visit);
+
+    static const Key &value_of(const stored_type &stored);
+
+    static size_type hash_of(const stored_type &stored);
+
+    template<class K>
+    static bool matches(const stored_type &stored, size_type hash_value, const K &key);
+
+    template<class Value>
+    static void store(stored_type &stored, size_type hash_value, Value &&value);
+
+    void resize(size_type cells);
+
+    void resize(size_type cells, size_type threads);
+
+    template<bool Unique, class ValueAt>
+    size_type fill_by_region(size_type threads, const std::vector<size_type> &hashes,
+                             const std::vector<std::uint16_t> &regions, ValueAt value_at, size_type &missed);
+
+    void regrow(std::vector<cell_type> &first, std::vector<cell_type> &second, size_type cells);
+
+    void start_migration(size_type cells);
+
+    void migrate(size_type cells);
 };
 
 //-------------------------------------------------------
 // Name: HashTable
 // PreCondition:  the radius is greater than zero
-// PostCondition: makes an empty table with 11 cells.
+// PostCondition: makes an empty table with 11 cells, rounded up to a
+// size the capacity policy allows.
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash>::HashTable() {
-    number_of_cells = DEFAULT_CELL_SIZE;
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::HashTable() {
+    number_of_cells = Probe::template round_up<Capacity>(DEFAULT_CELL_SIZE);
     maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
     count = 0;
-    table.reserve(DEFAULT_CELL_SIZE);
+    deleted_count = 0;
+    migrated_cells = 0;
+    incremental = false;
+    table.reserve(number_of_cells);
     for (size_type i = 0; i < number_of_cells; i++) {
         table.emplace_back();
     }
     for (size_type i = 0; i < number_of_cells; i++) {
         auto &slot = table[i];
-        slot.first = false;
+        slot.first = EntryType::EMPTY;
     }
 }
 
@@ -113,25 +348,21 @@ HashTable<Key, Hash>::HashTable() {
 // PreCondition:  the radius is greater than zero
 // PostCondition: constructs a copy of the given table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash>::HashTable(const HashTable &other) {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::HashTable(const HashTable &other) {
     // Clear the content
 
     number_of_cells = other.number_of_cells;
 
-    // No need to import as the maximum load factor is fixed to 0.5f
-    maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
-
-    // Create a new table
-    table.reserve(number_of_cells);
+    maximum_load_factor = other.maximum_load_factor;
 
-    // copy values
-    for (size_type i = 0; i < number_of_cells; i++) {
-        auto &slot = table[i];
-        if (slot.first) {
-            table[i] = other.table[i];
-        }
-    }
+    // copy values, including the deleted markers and any rehash in progress
+    count = other.count;
+    deleted_count = other.deleted_count;
+    table = other.table;
+    old_table = other.old_table;
+    migrated_cells = other.migrated_cells;
+    incremental = other.incremental;
 }
 
 //-------------------------------------------------------
@@ -139,36 +370,74 @@ HashTable<Key, Hash>::HashTable(const HashTable &other) {
 // PreCondition:
 // PostCondition: assigns a copy of the given table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash> &HashTable<Key, Hash>::operator=(const HashTable &other) { // clear , new, copy
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+HashTable<Key, Hash, Capacity, StoreHash, Probe> &HashTable<Key, Hash, Capacity, StoreHash, Probe>::operator=(const HashTable &other) { // clear , new, copy
     // Clear the content
 
     number_of_cells = other.number_of_cells;
 
-    // No need to import as the maximum load factor is fixed to 0.5f
-    maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    maximum_load_factor = other.maximum_load_factor;
 
-    // Create a new table
-    table.reserve(number_of_cells);
+    // copy values, including the deleted markers and any rehash in progress
+    count = other.count;
+    deleted_count = other.deleted_count;
+    table = other.table;
+    old_table = other.old_table;
+    migrated_cells = other.migrated_cells;
+    incremental = other.incremental;
 
-    // copy values
-    for (size_type i = 0; i < number_of_cells; i++) {
-        auto &slot = table[i];
-        if (slot.first) {
-            table[i] = other.table[i];
-        }
-    }
+    return *this;
+}
 
+//-------------------------------------------------------
+// Name: HashTable
+// PreCondition:
+// PostCondition: takes over the cells of the given table, which is
+// left empty with the default number of cells.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::HashTable(HashTable &&other) : HashTable() {
+    swap(other);
+}
+
+//-------------------------------------------------------
+// Move operator
+// PreCondition:
+// PostCondition: takes over the cells of the given table, which is
+// left holding the previous cells of this table.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+HashTable<Key, Hash, Capacity, StoreHash, Probe> &
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::operator=(HashTable &&other) {
+    swap(other);
     return *this;
 }
 
+//-------------------------------------------------------
+// Name: swap
+// PreCondition:
+// PostCondition: exchanges the contents of the two tables without
+// copying any value.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::swap(HashTable &other) {
+    std::swap(number_of_cells, other.number_of_cells);
+    std::swap(maximum_load_factor, other.maximum_load_factor);
+    std::swap(count, other.count);
+    std::swap(deleted_count, other.deleted_count);
+    table.swap(other.table);
+    old_table.swap(other.old_table);
+    std::swap(migrated_cells, other.migrated_cells);
+    std::swap(incremental, other.incremental);
+}
+
 //-------------------------------------------------------
 // Name: ~HashTable
 // PreCondition:  the radius is greater than zero
 // PostCondition: destructs this table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash>::~HashTable() {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::~HashTable() {
     // Nothing to do here
 }
 
@@ -176,20 +445,23 @@ HashTable<Key, Hash>::~HashTable() {
 // Name: HashTable
 // PreCondition:  the radius is greater than zero
 // PostCondition: makes an empty table with the specified number of
-// cells
+// cells, rounded up to a size the capacity policy allows
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash>::HashTable(size_type cells) {
-    number_of_cells = cells;
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::HashTable(size_type cells) {
+    number_of_cells = Probe::template round_up<Capacity>(cells);
     maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
     count = 0;
+    deleted_count = 0;
+    migrated_cells = 0;
+    incremental = false;
     table.reserve(number_of_cells);
     for (size_type i = 0; i < number_of_cells; i++) {
         table.emplace_back();
     }
     for (size_type i = 0; i < number_of_cells; i++) {
         auto &slot = table[i];
-        slot.first = false;
+        slot.first = EntryType::EMPTY;
     }
 }
 
@@ -198,17 +470,9 @@ HashTable<Key, Hash>::HashTable(size_type cells) {
 // PreCondition:  the radius is greater than zero
 // PostCondition: returns true if the table is empty.
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::is_empty() const {
-    for (size_type i = 0; i < number_of_cells; i++) {
-        auto &slot = table[i];
-        if (slot.first) {
-            return false;
-        }
-    }
-
-    return true;
-
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::is_empty() const {
+    return count == 0;
 }
 
 //-------------------------------------------------------
@@ -216,8 +480,8 @@ bool HashTable<Key, Hash>::is_empty() const {
 // PreCondition:  the radius is greater than zero
 // PostCondition: returns the number of active values in the table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::size() const {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::size() const {
     return count;
 }
 
@@ -226,8 +490,8 @@ size_t HashTable<Key, Hash>::size() const {
 // PreCondition:  the radius is greater than zero
 // PostCondition: return the number of cells in the table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::table_size() const {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::table_size() const {
     return number_of_cells;
 }
 
@@ -237,64 +501,143 @@ size_t HashTable<Key, Hash>::table_size() const {
 // PostCondition: remove all values from the table. Do not change the
 // number of cells.
 //---------------------------------------------------------
-template<class Key, class Hash>
-void HashTable<Key, Hash>::make_empty() {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::make_empty() {
     for (size_type i = 0; i < number_of_cells; i++) {
         auto &slot = table[i];
-        slot.first = false;
+        slot.first = EntryType::EMPTY;
     }
     count = 0;
+    deleted_count = 0;
+
+    std::vector<cell_type>().swap(old_table);
+    migrated_cells = 0;
 }
 
 //-------------------------------------------------------
 // Name: insert
 // PreCondition:  the radius is greater than zero
 // PostCondition: insert the given value reference into the table,
+// reusing the first deleted cell on the probe sequence,
 // rehashing if the maximum load factor is exceeded,
 // return true if insert was successful (false if item
-// already exists).
+// already exists). With incremental rehashing the new
+// cells are only filled a few at a time by the
+// following operations.
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::insert(const value_type &value) {
-    // get the hash value
-    size_type hash_value = Hash{}(value);
-    size_type index = hash_value % number_of_cells;
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::insert(const value_type &value) {
+    return place(value);
+}
 
-    // Check whether the values is available
-    if (contains(value)) {
-        return false;
-    }
+//-------------------------------------------------------
+// Name: insert
+// PreCondition:
+// PostCondition: same as inserting a reference, but the value is moved
+// into its cell instead of copied.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::insert(value_type &&value) {
+    return place(std::move(value));
+}
 
-    bool ret = true;
-    for (size_type i = 0; i < number_of_cells; i++) {
+//-------------------------------------------------------
+// Name: emplace
+// PreCondition:
+// PostCondition: construct a value from the given arguments and move it
+// into the table, return true if insert was successful
+// (false if item already exists). The value is needed
+// for its hash before a cell can be chosen, so it is
+// built once and moved once.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class... Args>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::emplace(Args &&... args) {
+    Key value(std::forward<Args>(args)...);
+    return place(std::move(value));
+}
 
+//-------------------------------------------------------
+// Name: place
+// PreCondition:
+// PostCondition: the insert shared by copies and moves, the value is
+// only forwarded into its cell once it is known to be
+// new.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class Value>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::place(Value &&value) {
+    return place_hashed(Hash{}(value), std::forward<Value>(value));
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class Value>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::place_hashed(size_type hash_value, Value &&value) {
+    // Values not migrated yet are only found in the old cells
+    if (!old_table.empty()) {
+        migrate(MIGRATION_STEP);
+        if (!old_table.empty() && find(old_table, hash_value, value) < old_table.size()) {
+            return false;
+        }
+    }
+
+    // The value can only be placed once the whole probe sequence up to an
+    // empty cell has been checked for a duplicate
+    size_type free_index = number_of_cells;
+    bool duplicate = false;
+    probe(hash_value, number_of_cells, [&](size_type index) {
         auto &slot = table[index];
+        if (slot.first != EntryType::ACTIVE) {
+            if (free_index == number_of_cells) {
+                free_index = index;
+            }
+            return slot.first == EntryType::EMPTY;
+        }
+        return duplicate = matches(slot.second, hash_value, value);
+    });
+    if (duplicate) {
+        return false;
+    }
 
-        // If the slot has no value we can insert  the value
-        if (!slot.first) {
-            slot.first = true;
-            slot.second = value;
-            count++;
+    // Only a probe sequence that skips cells can miss every free cell
+    if (free_index == number_of_cells) {
+        rehash(Capacity::next_size(number_of_cells * 2));
+        return place_hashed(hash_value, std::forward<Value>(value));
+    }
 
-            if (load_factor() > maximum_load_factor) {
-                size_type cell_number = number_of_cells * 4;
-                while (!is_prime(cell_number)) {
-                    cell_number++;
-                }
+    auto &slot = table[free_index];
+    if (slot.first == EntryType::DELETED) {
+        deleted_count--;
+    }
+    slot.first = EntryType::ACTIVE;
+    store(slot.second, hash_value, std::forward<Value>(value));
+    count++;
 
-                count = 0;
-                ret = rehash(cell_number);
-            }
-            return ret;
+    bool ret = true;
+    if (load_factor() > maximum_load_factor) {
+        size_type cell_number = Capacity::next_size(number_of_cells * 4);
 
+        if (incremental) {
+            start_migration(cell_number);
         } else {
-            hash_value++;
-            index = (hash_value) % number_of_cells;
+            ret = rehash(cell_number);
+        }
+    } else if (old_table.empty() && (float) (count + deleted_count) / (float) number_of_cells > maximum_load_factor) {
+        // Too many deleted cells are lengthening the probe sequences. While
+        // the values alone fill at most 25/32 of the room the maximum load
+        // factor allows, rebuild the table at the same size, which leaves
+        // the other 7/32 to fill with deleted cells before the next
+        // rebuild. Otherwise grow, since a rebuild of a nearly full table
+        // would be due again after a few removes.
+        if ((float) count * 32 <= maximum_load_factor * (float) number_of_cells * 25) {
+            resize(number_of_cells);
+        } else if (incremental) {
+            start_migration(Capacity::next_size(number_of_cells * 2));
+        } else {
+            rehash(Capacity::next_size(number_of_cells * 2));
         }
-
     }
-
-    return false;
+    return ret;
 }
 
 //-------------------------------------------------------
@@ -302,12 +645,9 @@ bool HashTable<Key, Hash>::insert(const value_type &value) {
 // PreCondition: num should be positive
 // PostCondition: returns the number is prime or not.
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::is_prime(size_type num) {
-    for (size_type i = 2; i * i <= num; i++)
-        if (num % i == 0) // Factor found
-            return false;
-    return true;
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::is_prime(size_type num) {
+    return PrimeCapacity::is_prime(num);
 }
 
 //-------------------------------------------------------
@@ -315,30 +655,133 @@ bool HashTable<Key, Hash>::is_prime(size_type num) {
 // PreCondition:
 // PostCondition: return the current load factor of the table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-float HashTable<Key, Hash>::load_factor() const {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+float HashTable<Key, Hash, Capacity, StoreHash, Probe>::load_factor() const {
     return (float) size() / (float) table_size();
 }
 
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:
+// PostCondition: return the current maximum load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+float HashTable<Key, Hash, Capacity, StoreHash, Probe>::max_load_factor() const {
+    return maximum_load_factor;
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:
+// PostCondition: set the maximum load factor of the table, forces a
+// rehash if the new maximum is less than the current
+// load factor, throws std::invalid_argument if the
+// input is not between zero and one, or above the
+// highest load factor at which every probe sequence
+// still reaches a free cell.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::max_load_factor(float mlf) {
+    if (!(mlf > 0.0f && mlf < 1.0f)) throw std::invalid_argument("Maximum load factor must be between 0 and 1");
+    if (mlf > Probe::template max_load_factor<Capacity>()) {
+        throw std::invalid_argument("Maximum load factor is above what the probe sequence supports");
+    }
+    maximum_load_factor = mlf;
+
+    if (load_factor() > maximum_load_factor) {
+        rehash(Capacity::next_size((size_type) ((float) size() / maximum_load_factor) + 1));
+    }
+}
+
 //-------------------------------------------------------
 // Name: remove
 // PreCondition:  the radius is greater than zero
 // PostCondition: remove the specified value from the table, return
 // number of elements removed (0 or 1). Use lazy
-// deletion.
+// deletion, the cell is marked as deleted so that the
+// values probed past it can still be found.
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::remove(const key_type &key) {
-    if (contains(key)) {
-        size_type index = position(key);
-        auto &slot = table[index];
-        slot.first = false;
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::remove(const key_type &key) {
+    return remove_key(key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K, class H, class>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::remove(const K &key) {
+    return remove_key(key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::remove_key(const K &key) {
+    return remove_hashed(Hash{}(key), key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::remove_hashed(size_type hash_value, const K &key) {
+    if (!old_table.empty()) {
+        migrate(MIGRATION_STEP);
+    }
+
+    size_type index = find(table, hash_value, key);
+    if (index < number_of_cells) {
+        table[index].first = EntryType::DELETED;
         count--;
+        deleted_count++;
         return 1;
-    } else {
-        return 0;
     }
 
+    // The old cells are dropped as a whole once migrated, so their
+    // deleted cells are not counted
+    if (!old_table.empty()) {
+        index = find(old_table, hash_value, key);
+        if (index < old_table.size()) {
+            old_table[index].first = EntryType::DELETED;
+            count--;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------
+// Name: resize()
+// PreCondition:  cells can hold all the values
+// PostCondition: move every value once into a new set of cells, which
+// also drops all the deleted cells. The values are known
+// to be unique so each one only needs an empty cell. If
+// a probe sequence reaches none, the table grows to
+// twice the cells instead.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::resize(size_type cells) {
+    std::vector<cell_type> old_cells(cells);
+    for (auto &slot : old_cells) {
+        slot.first = EntryType::EMPTY;
+    }
+    old_cells.swap(table);
+    number_of_cells = cells;
+    deleted_count = 0;
+
+    for (auto &old_slot : old_cells) {
+        if (old_slot.first != EntryType::ACTIVE) {
+            continue;
+        }
+
+        size_type index = probe(hash_of(old_slot.second), number_of_cells, [&](size_type i) {
+            return table[i].first == EntryType::EMPTY;
+        });
+        if (index == number_of_cells) {
+            regrow(table, old_cells, Capacity::next_size(number_of_cells * 2));
+            return;
+        }
+        table[index].first = EntryType::ACTIVE;
+        table[index].second = std::move(old_slot.second);
+        old_slot.first = EntryType::DELETED;
+    }
 }
 
 //-------------------------------------------------------
@@ -347,29 +790,319 @@ size_t HashTable<Key, Hash>::remove(const key_type &key) {
 // PostCondition: returns Boolean true if the specified value is in the
 // table
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::contains(const key_type &key) {
-    size_type hash_value = Hash{}(key);
-    size_type index = hash_value % number_of_cells;
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::contains(const key_type &key) {
+    return contains_key(key);
+}
 
-    for (size_type i = 0; i < number_of_cells; i++) {
-        auto &slot = table[index];
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K, class H, class>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::contains(const K &key) {
+    return contains_key(key);
+}
 
-        // If the slot has no value
-        if (!slot.first) {
-            return false;
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::contains_key(const K &key) {
+    return contains_hashed(Hash{}(key), key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::contains_hashed(size_type hash_value, const K &key) {
+    if (!old_table.empty()) {
+        migrate(MIGRATION_STEP);
+    }
+
+    if (find(table, hash_value, key) < number_of_cells) {
+        return true;
+    }
+    return !old_table.empty() && find(old_table, hash_value, key) < old_table.size();
+}
+
+//-------------------------------------------------------
+// Name: insert_batch
+// PreCondition:  values points to n values
+// PostCondition: insert every value as insert() does, return the
+// number of values that were new.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::insert_batch(const value_type *values, size_type n) {
+    return for_each_prefetched(values, n, [&](size_type hash_value, size_type i) {
+        return place_hashed(hash_value, values[i]);
+    });
+}
+
+//-------------------------------------------------------
+// Name: insert_batch
+// PreCondition:  values and hashes point to n values and their hashes
+// PostCondition: insert every value as insert() does without hashing
+// it again, return the number of values that were new.
+// The home cells of each group of BATCH_SIZE values are
+// prefetched before the first one is placed.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::insert_batch(const value_type *values,
+                                                                      const size_type *hashes, size_type n) {
+    size_t total = 0;
+    for (size_type first = 0; first < n; first += BATCH_SIZE) {
+        size_type group = std::min(BATCH_SIZE, n - first);
+        for (size_type i = 0; i < group; i++) {
+            __builtin_prefetch(&table[Capacity::index(hashes[first + i], number_of_cells)]);
         }
+        for (size_type i = 0; i < group; i++) {
+            total += place_hashed(hashes[first + i], values[first + i]);
+        }
+    }
+    return total;
+}
 
+//-------------------------------------------------------
+// Name: contains_batch
+// PreCondition:  keys points to n keys
+// PostCondition: return the number of keys in the table. The second
+// form also sets found[i] to whether keys[i] is in the
+// table.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::contains_batch(const key_type *keys, size_type n) {
+    return for_each_prefetched(keys, n, [&](size_type hash_value, size_type i) {
+        return contains_hashed(hash_value, keys[i]);
+    });
+}
 
-        if (slot.second == key) {
-            return true;
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::contains_batch(const key_type *keys, size_type n,
+                                                                        std::vector<bool> &found) {
+    found.assign(n, false);
+    return for_each_prefetched(keys, n, [&](size_type hash_value, size_type i) {
+        return found[i] = contains_hashed(hash_value, keys[i]);
+    });
+}
+
+//-------------------------------------------------------
+// Name: remove_batch
+// PreCondition:  keys points to n keys
+// PostCondition: remove every key as remove() does, return the number
+// of values removed.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::remove_batch(const key_type *keys, size_type n) {
+    return for_each_prefetched(keys, n, [&](size_type hash_value, size_type i) {
+        return remove_hashed(hash_value, keys[i]);
+    });
+}
+
+//-------------------------------------------------------
+// Name: for_each_prefetched
+// PreCondition:  keys points to n keys
+// PostCondition: calls operation(hash, i) for every key in order and
+// returns the sum of the results. Before the first key
+// of each group of BATCH_SIZE is passed on, the whole
+// group is hashed and the home cells are prefetched.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class Operation>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::for_each_prefetched(const key_type *keys, size_type n,
+                                                                             Operation operation) {
+    size_type hashes[BATCH_SIZE];
+    size_t total = 0;
+    for (size_type first = 0; first < n; first += BATCH_SIZE) {
+        size_type group = std::min(BATCH_SIZE, n - first);
+        for (size_type i = 0; i < group; i++) {
+            hashes[i] = Hash{}(keys[first + i]);
+            __builtin_prefetch(&table[Capacity::index(hashes[i], number_of_cells)]);
+        }
+        for (size_type i = 0; i < group; i++) {
+            total += operation(hashes[i], first + i);
+        }
+    }
+    return total;
+}
+
+//-------------------------------------------------------
+// Name: build
+// PreCondition:  [first, last) is a random access range of keys
+// PostCondition: the table holds exactly the distinct keys of the
+// range, in enough cells for the maximum load factor.
+// The keys are hashed in parallel and then placed by
+// fill_by_region.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class Iterator>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::build(Iterator first, Iterator last, size_type num_threads) {
+    size_type n = last - first;
+    size_type threads = thread_count(num_threads);
+    size_type cells = Capacity::next_size((size_type) ((float) n / maximum_load_factor) + 1);
+
+    // Drop the values and any rehash in progress
+    old_table.clear();
+    migrated_cells = 0;
+
+    std::vector<size_type> hashes(n);
+    parallel_for(threads, n, [&](size_type, size_type begin, size_type end) {
+        for (size_type i = begin; i < end; i++) {
+            hashes[i] = Hash{}(first[i]);
+        }
+    });
+
+    // Starts over with twice the cells if a probe sequence reaches no
+    // empty cell
+    std::vector<std::uint16_t> regions(n);
+    size_type missed = 0;
+    while (true) {
+        table.assign(cells, cell_type(EntryType::EMPTY, stored_type()));
+        number_of_cells = cells;
+        deleted_count = 0;
+        parallel_for(threads, n, [&](size_type, size_type begin, size_type end) {
+            for (size_type i = begin; i < end; i++) {
+                regions[i] = (std::uint16_t) (Capacity::index(hashes[i], cells) * threads / cells);
+            }
+        });
+        count = fill_by_region<false>(threads, hashes, regions, [&](size_type i) -> decltype(auto) {
+            return first[i];
+        }, missed);
+        if (missed == 0) {
+            break;
+        }
+        cells = Capacity::next_size(cells * 2);
+    }
+}
+
+//-------------------------------------------------------
+// Name: resize()
+// PreCondition:  cells can hold all the values, threads is greater
+// than zero
+// PostCondition: move every value once into a new set of cells, as
+// the sequential resize() does, using the given number
+// of threads. Each thread hashes one contiguous chunk of
+// the old cells, then fill_by_region moves them. Grows
+// as the sequential resize() does.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::resize(size_type cells, size_type threads) {
+    std::vector<cell_type> old_cells(cells, cell_type(EntryType::EMPTY, stored_type()));
+    old_cells.swap(table);
+    number_of_cells = cells;
+    deleted_count = 0;
+
+    // Empty and deleted cells are given the region past the last thread,
+    // which fill_by_region skips
+    size_type n = old_cells.size();
+    std::vector<size_type> hashes(n);
+    std::vector<std::uint16_t> regions(n);
+    parallel_for(threads, n, [&](size_type, size_type begin, size_type end) {
+        for (size_type i = begin; i < end; i++) {
+            if (old_cells[i].first != EntryType::ACTIVE) {
+                regions[i] = (std::uint16_t) threads;
+                continue;
+            }
+            hashes[i] = hash_of(old_cells[i].second);
+            regions[i] = (std::uint16_t) (Capacity::index(hashes[i], cells) * threads / cells);
+        }
+    });
+    // A moved value's old cell is marked deleted, so only the values left
+    // behind are still active there
+    size_type missed = 0;
+    fill_by_region<true>(threads, hashes, regions, [&](size_type i) -> Key && {
+        old_cells[i].first = EntryType::DELETED;
+        if constexpr (StoreHash) {
+            return std::move(old_cells[i].second.value);
         } else {
-            hash_value++;
-            index = (hash_value) % number_of_cells;
+            return std::move(old_cells[i].second);
         }
+    }, missed);
+    if (missed > 0) {
+        regrow(table, old_cells, Capacity::next_size(number_of_cells * 2));
     }
+}
 
-    return false;
+//-------------------------------------------------------
+// Name: fill_by_region()
+// PreCondition:  the cells are all empty, hashes[i] is the hash of
+// value_at(i) and regions[i] the thread owning its home
+// cell, or threads for a value to skip. Thread t owns
+// the cells from ceil(t * cells / threads) up to the
+// start of the next thread's cells
+// PostCondition: places the values and returns how many were placed.
+// Each thread probes only its own cells, taking its
+// values in index order, so no locks are needed. The
+// values whose probe leaves their thread's cells, few
+// with linear probing, are placed afterwards, again in
+// index order, so the layout depends only on the values
+// and the number of threads. Unless Unique, a value
+// equal to one already placed is skipped. Values whose
+// probe sequence reaches no empty cell are left where
+// they are and counted in missed.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<bool Unique, class ValueAt>
+typename HashTable<Key, Hash, Capacity, StoreHash, Probe>::size_type
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::fill_by_region(size_type threads,
+                                                                 const std::vector<size_type> &hashes,
+                                                                 const std::vector<std::uint16_t> &regions,
+                                                                 ValueAt value_at, size_type &missed) {
+    std::vector<size_type> order, offsets;
+    partition_by_region(threads, hashes.size(), threads + 1, regions, order, offsets);
+
+    // Follows the probe sequence until it fills an empty cell or finds
+    // the value, stopping early when it leaves the cells from begin up to
+    // end. Returns 1 when it filled a cell, 0 when the value was there and
+    // -1 when it stopped early or reached no empty cell
+    auto place_within = [&](size_type i, size_type begin, size_type end) {
+        int result = -1;
+        probe(hashes[i], number_of_cells, [&](size_type index) {
+            cell_type &slot = table[index];
+            if (index < begin || index >= end) {
+                result = -1;
+                return true;
+            }
+            if (slot.first == EntryType::EMPTY) {
+                slot.first = EntryType::ACTIVE;
+                store(slot.second, hashes[i], value_at(i));
+                result = 1;
+                return true;
+            }
+            if constexpr (!Unique) {
+                if (matches(slot.second, hashes[i], value_at(i))) {
+                    result = 0;
+                    return true;
+                }
+            }
+            return false;
+        });
+        return result;
+    };
+
+    std::vector<std::vector<size_type>> overflow(threads);
+    std::vector<size_type> placed(threads, 0);
+    parallel_for(threads, threads, [&](size_type t, size_type, size_type) {
+        size_type begin = (t * number_of_cells + threads - 1) / threads;
+        size_type end = ((t + 1) * number_of_cells + threads - 1) / threads;
+        for (size_type k = offsets[t]; k < offsets[t + 1]; k++) {
+            int result = place_within(order[k], begin, end);
+            if (result < 0) {
+                overflow[t].push_back(order[k]);
+            } else {
+                placed[t] += result;
+            }
+        }
+    });
+
+    size_type total = 0;
+    missed = 0;
+    for (size_type t = 0; t < threads; t++) {
+        total += placed[t];
+        for (size_type i : overflow[t]) {
+            int result = place_within(i, 0, number_of_cells);
+            if (result < 0) {
+                missed++;
+            } else {
+                total += result;
+            }
+        }
+    }
+    return total;
 }
 
 //-------------------------------------------------------
@@ -380,10 +1113,29 @@ bool HashTable<Key, Hash>::contains(const key_type &key) {
 // changed. If the new number of buckets would cause the
 // load factor to exceed the maximum load factor, then
 // the new number of buckets is at least size() /
-// max_load_factor().
+// max_load_factor(). The number of buckets is first
+// rounded up to a size the capacity policy allows.
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::rehash(size_type table_size) {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::rehash(size_type table_size) {
+    return rehash(table_size, 1);
+}
+
+//-------------------------------------------------------
+// Name: rehash()
+// PreCondition:
+// PostCondition: rehash as above, moving the values with the given
+// number of threads, or one per hardware thread when it
+// is zero. The resulting layout depends only on the
+// values and the number of threads.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::rehash(size_type table_size, size_type num_threads) {
+    table_size = Probe::template round_up<Capacity>(table_size);
+
+    // An explicit rehash finishes any incremental one first
+    migrate(old_table.size());
+
     //If the count is same, no need to rehash
     if (table_size == number_of_cells) {
         return false;
@@ -394,69 +1146,129 @@ bool HashTable<Key, Hash>::rehash(size_type table_size) {
         return false;
     }
 
-    count = 0;
-    HashTable<Key> *newHashTable = new HashTable<Key>(table_size);
-
-    for (size_type index = 0; index < number_of_cells; index++) {
-        auto &slot = table[index];
-        if (slot.first) {
-            newHashTable->insert(slot.second);
-        }
-    }
-
-    table.resize(table_size);
-    number_of_cells = table_size;
-
-    for (size_type i = 0; i < table_size; i++) {
-        auto &slot = table[i];
-        slot.first = false;
-    }
-
-    for (size_type index = 0; index < table_size; index++) {
-        auto slot = (newHashTable->get_table())[index];
-        if (slot.first) {
-            insert(slot.second);
-        }
+    size_type threads = thread_count(num_threads);
+    if (threads == 1) {
+        resize(table_size);
+    } else {
+        resize(table_size, threads);
     }
-
-    delete newHashTable;
     return true;
+}
 
+//-------------------------------------------------------
+// Name: reserve()
+// PreCondition:
+// PostCondition: grow the table to enough cells for the given number
+// of values at the maximum load factor. Never shrinks
+// the table.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::reserve(size_type values) {
+    size_type cells = (size_type) ((double) values / maximum_load_factor) + 1;
+    if (cells > number_of_cells) {
+        rehash(cells);
+    }
 }
 
 //-------------------------------------------------------
 // Name: position
 // PreCondition:  the radius is greater than zero
 // PostCondition: return the index of the cell that would contain the
-// specified value. This method handles collision
-// resolution.
+// specified value, the same index get_table() holds it
+// at. While an incremental rehash is in progress a value
+// that has not been moved yet reports an invalid index,
+// since its old cell is not one of the table's cells.
+// incremental_rehash(false) moves every value first.
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::position(const key_type &key) const {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::position(const key_type &key) const {
+    return position_of(key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K, class H, class>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::position(const K &key) const {
+    return position_of(key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::position_of(const K &key) const {
     size_type hash_value = Hash{}(key);
-    size_type index = hash_value % number_of_cells;
+    size_type index = find(table, hash_value, key);
+    if (index < number_of_cells) {
+        return index;
+    }
 
-    for (size_type i = 0; i < number_of_cells; i++) {
-        auto &slot = table[index];
+    // returning an invalid position
+    return number_of_cells + 1;
+}
+
+//-------------------------------------------------------
+// Name: find
+// PreCondition:  cells is not empty, hash_value is the hash of key
+// PostCondition: return the index of the cell in cells that contains
+// the specified value, or cells.size() if it is not
+// there. This method handles collision resolution.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+typename HashTable<Key, Hash, Capacity, StoreHash, Probe>::size_type
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::find(const std::vector<cell_type> &cells, size_type hash_value,
+                                                       const K &key) const {
+    return find(cells.data(), cells.size(), hash_value, key);
+}
 
-        if (!slot.first) {
-            return number_of_cells + 1;
+//-------------------------------------------------------
+// Name: find
+// PreCondition:  number is greater than zero, hash_value is the hash
+// of key
+// PostCondition: the same for the given number of cells starting at
+// cells, which may also be cells mapped from a snapshot.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+typename HashTable<Key, Hash, Capacity, StoreHash, Probe>::size_type
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::find(const cell_type *cells, size_type number,
+                                                       size_type hash_value, const K &key) {
+    bool found = false;
+    size_type index = probe(hash_value, number, [&](size_type i) {
+        auto &slot = cells[i];
+        // A cell that has never had a value ends the sequence
+        if (slot.first == EntryType::EMPTY) {
+            return true;
         }
+        return found = slot.first == EntryType::ACTIVE && matches(slot.second, hash_value, key);
+    });
+    return found ? index : number;
+}
 
-        if (slot.second == key) {
-            return index;
-        } else {
-            hash_value++;
-            index = (hash_value) % number_of_cells;
+//-------------------------------------------------------
+// Name: probe
+// PreCondition:  cells is greater than zero
+// PostCondition: calls visit(index) for the cells of the probe sequence
+// of the hash value in a table of the given number of
+// cells, in the order of the Probe policy, until visit
+// returns true or as many cells as the table has were
+// visited. Returns the index visit stopped at, or cells.
+// Every probe of the table goes through here.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class Visit>
+typename HashTable<Key, Hash, Capacity, StoreHash, Probe>::size_type
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::probe(size_type hash_value, size_type cells, Visit visit) {
+    typename Probe::template Sequence<Capacity> sequence(hash_value, cells);
+    for (size_type i = 0; i < cells; i++, sequence.next()) {
+        if (visit(sequence.index())) {
+            return sequence.index();
         }
     }
-
-    // returning an invalid position
-    return number_of_cells + 1;
+    return cells;
 }
 
-template<class Key, class Hash>
-std::vector<std::pair<bool, Key>> HashTable<Key, Hash>::get_table() {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+std::vector<typename HashTable<Key, Hash, Capacity, StoreHash, Probe>::cell_type> HashTable<Key, Hash, Capacity, StoreHash, Probe>::get_table() {
+    migrate(old_table.size());
     return table;
 }
 
@@ -467,21 +1279,547 @@ std::vector<std::pair<bool, Key>> HashTable<Key, Hash>::get_table() {
 //produce reasonable output, the empty table should
 //print “<empty>\n”.
 //---------------------------------------------------------
-template<class Key, class Hash>
-void HashTable<Key, Hash>::print_table(std::ostream &os) const {
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::print_table(std::ostream &os) const {
     if (is_empty()) {
-        std::cout << "<empty>\n";
+        os << "<empty>\n";
         return;
     }
     for (size_type i = 0; i < number_of_cells; i++) {
         auto &slot = table[i];
-        if (slot.first) {
+        if (slot.first == EntryType::ACTIVE) {
             os << i << ": ";
-            os << slot.second;
+            os << value_of(slot.second);
+            os << std::endl;
+        }
+
+    }
+    for (size_type i = migrated_cells; i < old_table.size(); i++) {
+        auto &slot = old_table[i];
+        if (slot.first == EntryType::ACTIVE) {
+            os << "old " << i << ": ";
+            os << value_of(slot.second);
             os << std::endl;
         }
+    }
+}
+
+//-------------------------------------------------------
+// Name: incremental_rehash()
+// PreCondition:
+// PostCondition: return true if growing the table moves the values a
+// few cells at a time instead of all at once.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::incremental_rehash() const {
+    return incremental;
+}
+
+//-------------------------------------------------------
+// Name: incremental_rehash()
+// PreCondition:
+// PostCondition: turn incremental rehashing on or off, turning it off
+// finishes a rehash that is in progress.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::incremental_rehash(bool enabled) {
+    incremental = enabled;
+    if (!incremental) {
+        migrate(old_table.size());
+    }
+}
+
+//-------------------------------------------------------
+// Name: migration_debt()
+// PreCondition:
+// PostCondition: return the number of insert, remove or contains calls
+// left before an incremental rehash has moved every
+// value, 0 if none is in progress.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t HashTable<Key, Hash, Capacity, StoreHash, Probe>::migration_debt() const {
+    return (old_table.size() - migrated_cells + MIGRATION_STEP - 1) / MIGRATION_STEP;
+}
+
+//-------------------------------------------------------
+// Name: regrow()
+// PreCondition:  the values of the table are the active cells of
+// first and second, which may be the table's own cells
+// PostCondition: ends any incremental rehash and moves every value
+// into the given number of cells, as resize() does.
+// Used when a probe sequence reached no free cell.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::regrow(std::vector<cell_type> &first,
+                                                              std::vector<cell_type> &second, size_type cells) {
+    std::vector<cell_type> values;
+    values.reserve(count);
+    for (std::vector<cell_type> *from : {&first, &second}) {
+        for (auto &slot : *from) {
+            if (slot.first == EntryType::ACTIVE) {
+                values.emplace_back(EntryType::ACTIVE, std::move(slot.second));
+            }
+        }
+    }
+    std::vector<cell_type>().swap(old_table);
+    migrated_cells = 0;
+    table.swap(values);
+    number_of_cells = table.size();
+    resize(cells);
+}
+
+//-------------------------------------------------------
+// Name: start_migration()
+// PreCondition:  cells can hold all the values
+// PostCondition: finish any incremental rehash in progress, then make
+// the current cells the old cells and start over with
+// the given number of empty cells.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::start_migration(size_type cells) {
+    migrate(old_table.size());
+
+    old_table.swap(table);
+    table.assign(cells, cell_type());
+    for (auto &slot : table) {
+        slot.first = EntryType::EMPTY;
+    }
+    number_of_cells = cells;
+    deleted_count = 0;
+    migrated_cells = 0;
+}
+
+//-------------------------------------------------------
+// Name: migrate()
+// PreCondition:
+// PostCondition: move the values of up to the given number of old
+// cells into the table. Moved cells are marked deleted
+// so that probes through the old cells stay intact, and
+// the old cells are released once all are moved.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::migrate(size_type cells) {
+    if (old_table.empty()) {
+        return;
+    }
+
+    for (size_type moved = 0; moved < cells && migrated_cells < old_table.size(); moved++, migrated_cells++) {
+        auto &old_slot = old_table[migrated_cells];
+        if (old_slot.first != EntryType::ACTIVE) {
+            continue;
+        }
+
+        // The value is not in the table yet, so any free cell will do
+        size_type index = probe(hash_of(old_slot.second), number_of_cells, [&](size_type i) {
+            return table[i].first != EntryType::ACTIVE;
+        });
+        if (index == number_of_cells) {
+            regrow(table, old_table, Capacity::next_size(number_of_cells * 2));
+            return;
+        }
+        if (table[index].first == EntryType::DELETED) {
+            deleted_count--;
+        }
+        table[index].first = EntryType::ACTIVE;
+        table[index].second = std::move(old_slot.second);
+        old_slot.first = EntryType::DELETED;
+    }
+
+    if (migrated_cells == old_table.size()) {
+        std::vector<cell_type>().swap(old_table);
+        migrated_cells = 0;
+    }
+}
+
+//-------------------------------------------------------
+// Name: value_of
+// PreCondition:
+// PostCondition: return the value held in a cell.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+const Key &HashTable<Key, Hash, Capacity, StoreHash, Probe>::value_of(const stored_type &stored) {
+    if constexpr (StoreHash) {
+        return stored.value;
+    } else {
+        return stored;
+    }
+}
+
+//-------------------------------------------------------
+// Name: hash_of
+// PreCondition:
+// PostCondition: return the hash of the value held in a cell, read
+// from the cell when it is stored there.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+typename HashTable<Key, Hash, Capacity, StoreHash, Probe>::size_type
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::hash_of(const stored_type &stored) {
+    if constexpr (StoreHash) {
+        return stored.hash;
+    } else {
+        return Hash{}(stored);
+    }
+}
+
+//-------------------------------------------------------
+// Name: matches
+// PreCondition:  hash_value is the hash of key
+// PostCondition: return true if the cell holds key, the values are
+// only compared when the stored hash is equal.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+bool HashTable<Key, Hash, Capacity, StoreHash, Probe>::matches(const stored_type &stored, size_type hash_value,
+                                                               const K &key) {
+    if constexpr (StoreHash) {
+        return stored.hash == hash_value && stored.value == key;
+    } else {
+        return stored == key;
+    }
+}
+
+//-------------------------------------------------------
+// Name: store
+// PreCondition:  hash_value is the hash of value
+// PostCondition: place the value, and its hash with StoreHash, in a
+// cell.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class Value>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::store(stored_type &stored, size_type hash_value, Value &&value) {
+    if constexpr (StoreHash) {
+        stored.hash = hash_value;
+        stored.value = std::forward<Value>(value);
+    } else {
+        stored = std::forward<Value>(value);
+    }
+}
+
+//-------------------------------------------------------
+// Name: save
+// PreCondition:  Key is trivially copyable
+// PostCondition: finish any incremental rehash in progress and write a
+// SnapshotHeader and the cells to the file at path,
+// replacing it once the whole snapshot is written.
+// Throws std::runtime_error if the file cannot be
+// written.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+void HashTable<Key, Hash, Capacity, StoreHash, Probe>::save(const std::string &path) {
+    static_assert(std::is_trivially_copyable<Key>::value, "a snapshot holds the keys as raw bytes");
+    static_assert(sizeof(SnapshotHeader) % alignof(cell_type) == 0, "the cells must be aligned in the file");
+    migrate(old_table.size());
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.key_size = sizeof(Key);
+    header.cell_size = sizeof(cell_type);
+    header.store_hash = StoreHash;
+    header.cells = number_of_cells;
+    header.count = count;
+    header.hash_seed = HashSeed<Hash>::of(Hash{});
+    header.check_cell = number_of_cells;
+    for (size_type i = 0; i < number_of_cells; i++) {
+        if (table[i].first == EntryType::ACTIVE) {
+            header.check_cell = i;
+            header.check_hash = Hash{}(value_of(table[i].second));
+            break;
+        }
+    }
+
+    // Written to a file of its own first, so a reader never maps half a
+    // snapshot
+    std::string partial = path + ".partial";
+    std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // The cells are copied in chunks that were zeroed first, so the
+    // padding inside a cell is written as zeros rather than whatever the
+    // table's memory held
+    const size_type CHUNK = 4096;
+    std::vector<cell_type> chunk(std::min(CHUNK, number_of_cells));
+    for (size_type first = 0; first < number_of_cells && out; first += CHUNK) {
+        size_type n = std::min(CHUNK, number_of_cells - first);
+        std::memset(static_cast<void *>(chunk.data()), 0, n * sizeof(cell_type));
+        for (size_type i = 0; i < n; i++) {
+            chunk[i].first = table[first + i].first;
+            chunk[i].second = table[first + i].second;
+        }
+        out.write(reinterpret_cast<const char *>(chunk.data()), (std::streamsize) (n * sizeof(cell_type)));
+    }
+    out.close();
+
+    if (!out || std::rename(partial.c_str(), path.c_str()) != 0) {
+        std::remove(partial.c_str());
+        throw std::runtime_error("cannot write the snapshot " + path);
+    }
+}
+
+//-------------------------------------------------------
+// Name: open_mapped
+// PreCondition:  the file at path was written by save of a table of
+// this type
+// PostCondition: map the file read only and return a table answering
+// lookups from the mapped cells, without reading them
+// in. Throws std::runtime_error if the file cannot be
+// mapped or does not hold cells of this table type.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>
+HashTable<Key, Hash, Capacity, StoreHash, Probe>::open_mapped(const std::string &path) {
+    static_assert(std::is_trivially_copyable<Key>::value, "a snapshot holds the keys as raw bytes");
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open the snapshot " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || (size_type) info.st_size < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a snapshot");
+    }
+    size_type length = (size_type) info.st_size;
+    void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("cannot map the snapshot " + path);
+    }
+    // Unmapped again by its destructor if any check below fails
+    MappedHashTable<Key, Hash, Capacity, StoreHash, Probe> mapped(mapping, length);
+
+    const SnapshotHeader &header = *static_cast<const SnapshotHeader *>(mapping);
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION || header.byte_order != SNAPSHOT_BYTE_ORDER || header.cells == 0) {
+        throw std::runtime_error(path + " is not a snapshot");
+    }
+    if (header.key_size != sizeof(Key) || header.cell_size != sizeof(cell_type) || header.store_hash != StoreHash) {
+        throw std::runtime_error(path + " holds a table of another type");
+    }
+    // Bounding the cells by the file first keeps a corrupt count from
+    // overflowing the product
+    if (header.cells > (length - sizeof(SnapshotHeader)) / header.cell_size ||
+        length != sizeof(SnapshotHeader) + header.cells * header.cell_size) {
+        throw std::runtime_error(path + " is not a snapshot");
+    }
+    if (header.hash_seed != HashSeed<Hash>::of(Hash{}) ||
+        Probe::template round_up<Capacity>(header.cells) != header.cells || header.count > header.cells ||
+        header.check_cell > header.cells) {
+        throw std::runtime_error(path + " holds a table of another type");
+    }
+
+    // The value in the check cell has to hash as it did when saved and be
+    // found where it was saved
+    if (header.check_cell < header.cells) {
+        const cell_type &slot = mapped.cells[header.check_cell];
+        size_type hash_value = slot.first == EntryType::ACTIVE ? Hash{}(value_of(slot.second)) : 0;
+        if (slot.first != EntryType::ACTIVE || hash_value != header.check_hash ||
+            find(mapped.cells, header.cells, hash_value, value_of(slot.second)) != header.check_cell) {
+            throw std::runtime_error(path + " holds a table with another hash or probe sequence");
+        }
+    }
+    return mapped;
+}
+
+//-------------------------------------------------------
+// A table opened from a snapshot by HashTable::open_mapped. The cells are
+// read straight from the mapped file, so opening costs the same for any
+// size and the pages are read in by the first lookups that touch them.
+// Only lookups are offered; to change the values, insert them into a
+// HashTable.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+class MappedHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+    MappedHashTable(const MappedHashTable &other) = delete;
+
+    MappedHashTable &operator=(const MappedHashTable &other) = delete;
+
+    MappedHashTable(MappedHashTable &&other);
+
+    MappedHashTable &operator=(MappedHashTable &&other);
+
+    ~MappedHashTable();
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    size_t table_size() const;
+
+    bool contains(const key_type &key) const;
+
+    size_t position(const key_type &key) const;
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    bool contains(const K &key) const;
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    size_t position(const K &key) const;
+
+private:
+    using Table = HashTable<Key, Hash, Capacity, StoreHash, Probe>;
+    using cell_type = typename Table::cell_type;
+
+    friend class HashTable<Key, Hash, Capacity, StoreHash, Probe>;
+
+    void *mapping;
+    size_type length;
+    const cell_type *cells;
+    size_type number_of_cells;
+    size_type count;
+
+    MappedHashTable(void *mapping, size_type length);
+
+    template<class K>
+    size_t position_of(const K &key) const;
+};
 
+//-------------------------------------------------------
+// Name: MappedHashTable
+// PreCondition:  mapping holds length bytes starting with a
+// SnapshotHeader
+// PostCondition: takes over the mapping, which the destructor unmaps.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::MappedHashTable(void *mapping, size_type length)
+        : mapping(mapping), length(length) {
+    const SnapshotHeader &header = *static_cast<const SnapshotHeader *>(mapping);
+    cells = reinterpret_cast<const cell_type *>(static_cast<const char *>(mapping) + sizeof(SnapshotHeader));
+    number_of_cells = header.cells;
+    count = header.count;
+    // Lookups touch pages in no particular order, so reading ahead would
+    // only bring in pages nobody asked for
+    ::madvise(mapping, length, MADV_RANDOM);
+}
+
+//-------------------------------------------------------
+// Name: MappedHashTable
+// PreCondition:
+// PostCondition: takes over the mapping of the given table, which is
+// left empty.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::MappedHashTable(MappedHashTable &&other)
+        : mapping(other.mapping), length(other.length), cells(other.cells),
+          number_of_cells(other.number_of_cells), count(other.count) {
+    other.mapping = nullptr;
+    other.length = 0;
+    other.cells = nullptr;
+    other.number_of_cells = 0;
+    other.count = 0;
+}
+
+//-------------------------------------------------------
+// Move operator
+// PreCondition:
+// PostCondition: exchanges the mappings of the two tables.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+MappedHashTable<Key, Hash, Capacity, StoreHash, Probe> &
+MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::operator=(MappedHashTable &&other) {
+    std::swap(mapping, other.mapping);
+    std::swap(length, other.length);
+    std::swap(cells, other.cells);
+    std::swap(number_of_cells, other.number_of_cells);
+    std::swap(count, other.count);
+    return *this;
+}
+
+//-------------------------------------------------------
+// Name: ~MappedHashTable
+// PreCondition:
+// PostCondition: unmaps the snapshot.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::~MappedHashTable() {
+    if (mapping != nullptr) {
+        ::munmap(mapping, length);
+    }
+}
+
+//-------------------------------------------------------
+// Name: is_empty
+// PreCondition:
+// PostCondition: returns true if the table is empty.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::is_empty() const {
+    return count == 0;
+}
+
+//-------------------------------------------------------
+// Name: size
+// PreCondition:
+// PostCondition: returns the number of values in the table.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::size() const {
+    return count;
+}
+
+//-------------------------------------------------------
+// Name: table_size
+// PreCondition:
+// PostCondition: returns the number of cells.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::table_size() const {
+    return number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: contains
+// PreCondition:
+// PostCondition: returns Boolean true if the specified value is in the
+// table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+bool MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::contains(const key_type &key) const {
+    return position_of(key) < number_of_cells;
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K, class H, class>
+bool MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::contains(const K &key) const {
+    return position_of(key) < number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: position
+// PreCondition:
+// PostCondition: return the index of the cell that contains the
+// specified value, the same as in the saved table, or
+// table_size() + 1 if it is not there.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+size_t MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::position(const key_type &key) const {
+    return position_of(key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K, class H, class>
+size_t MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::position(const K &key) const {
+    return position_of(key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash, class Probe>
+template<class K>
+size_t MappedHashTable<Key, Hash, Capacity, StoreHash, Probe>::position_of(const K &key) const {
+    if (number_of_cells == 0) {
+        return 1;
     }
+    size_type index = Table::find(cells, number_of_cells, Hash{}(key), key);
+    return index < number_of_cells ? index : number_of_cells + 1;
 }
 
+}  // namespace open_addressing
+
 #endif  // HASHTABLE_OPEN_ADDRESSING_H
@@ -1,16 +1,77 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
+#include <string_view>
 #include <sstream>
 #include "hashtable_open_addressing.h"
 
+using open_addressing::HashTable;
+using open_addressing::S;
+
 using std::cout, std::endl;
 
+// Counts its calls, to check that a table storing hash codes does not
+// hash again when it grows
+struct CountingHash {
+    static size_t calls;
+
+    size_t operator()(const std::string &s) const {
+        calls++;
+        return std::hash<std::string>{}(s);
+    }
+};
+
+size_t CountingHash::calls = 0;
+
 void test_strings();
 
 void test_integer_1();
 
+void test_remove_in_cluster();
+
+void test_power_of_two();
+
+void test_incremental_rehash();
+
+void test_move();
+
+void test_transparent();
+
+void test_stored_hash();
+
+void test_max_load_factor();
+
+void test_batch();
+
+void test_build();
+
+void test_parallel_rehash();
+
+void test_seeded_hash();
+
+void test_probe_policies();
+
+void test_snapshot();
+
 int main() {
     test_strings();
     test_integer_1();
+    test_remove_in_cluster();
+    test_power_of_two();
+    test_incremental_rehash();
+    test_move();
+    test_transparent();
+    test_stored_hash();
+    test_max_load_factor();
+    test_batch();
+    test_build();
+    test_parallel_rehash();
+    test_seeded_hash();
+    test_probe_policies();
+    test_snapshot();
 
     return 0;
 }
@@ -185,4 +246,842 @@ void test_strings() {
         std::cout << ss.str() << std::endl;
     }
 
-}
\ No newline at end of file
+}
+
+void test_remove_in_cluster() {
+    const int INITIAL_TABLE_SIZE = 11;
+    const int NUMBER_OF_CHURN_ROUNDS = 1000;
+
+    std::cout << "make a cluster of colliding ints in a table with 11 cells" << std::endl;
+    HashTable<int> table(INITIAL_TABLE_SIZE);
+    table.insert(0);
+    table.insert(11);
+    table.insert(22);
+
+    table.remove(11);
+    if (table.contains(22) && table.position(22) == 2) {
+        std::cout << "[PASSED] contains after remove in cluster test " << std::endl;
+    } else {
+        std::cout << "contains after remove in cluster test failed" << std::endl;
+    }
+
+    if (table.insert(22) == false && table.size() == 2) {
+        std::cout << "[PASSED] insert duplicate after remove in cluster test " << std::endl;
+    } else {
+        std::cout << "insert duplicate after remove in cluster test failed" << std::endl;
+    }
+
+    using EntryType = HashTable<int>::EntryType;
+    auto cells = table.get_table();
+    auto empty_cells = std::count_if(cells.begin(), cells.end(), [](const auto &slot) {
+        return slot.first == EntryType::EMPTY;
+    });
+    if (cells[0].first == EntryType::ACTIVE && cells[1].first == EntryType::DELETED &&
+        cells[2].first == EntryType::ACTIVE && empty_cells == INITIAL_TABLE_SIZE - 3) {
+        std::cout << "[PASSED] cell states test " << std::endl;
+    } else {
+        std::cout << "cell states test failed" << std::endl;
+    }
+
+    table.insert(33);
+    if (table.position(33) == 1) {
+        std::cout << "[PASSED] insert reuses deleted cell test " << std::endl;
+    } else {
+        std::cout << "insert reuses deleted cell test failed" << std::endl;
+    }
+
+    std::cout << "insert and remove values without growing the table" << std::endl;
+    bool all_found = true;
+    for (int n = 0; n < NUMBER_OF_CHURN_ROUNDS; n++) {
+        table.insert(44 + n * 11);
+        table.remove(44 + n * 11);
+        all_found = all_found && table.contains(0) && table.contains(22) && table.contains(33);
+    }
+
+    if (all_found && table.size() == 3 && table.table_size() == INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] churn test " << std::endl;
+    } else {
+        std::cout << "churn test failed" << std::endl;
+    }
+}
+
+void test_power_of_two() {
+    const int INITIAL_TABLE_SIZE = 11;
+    const int ROUNDED_TABLE_SIZE = 16;
+    const int NUMBER_OF_INPUTS = 500;
+
+    std::cout << "make a power of two hash table for ints" << std::endl;
+    HashTable<int, std::hash<int>, PowerOfTwoCapacity> table(INITIAL_TABLE_SIZE);
+
+    if (table.table_size() == ROUNDED_TABLE_SIZE) {
+        std::cout << "[PASSED] power of two table size test " << std::endl;
+    } else {
+        std::cout << "power of two table size test failed" << std::endl;
+    }
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n * 1024);
+    }
+
+    size_t cells = table.table_size();
+    bool all_found = (cells & (cells - 1)) == 0;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * 1024) && !table.contains(n * 1024 + 1);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS && table.load_factor() <= 0.5f) {
+        std::cout << "[PASSED] power of two grow test " << std::endl;
+    } else {
+        std::cout << "power of two grow test failed" << std::endl;
+    }
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        table.remove(n * 1024);
+    }
+
+    all_found = true;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * 1024) == (n % 2 == 1);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS / 2 && !table.rehash(cells - 1) && table.rehash(2 * cells + 1) &&
+        table.table_size() == 4 * cells && table.contains(1024)) {
+        std::cout << "[PASSED] power of two rehash test " << std::endl;
+    } else {
+        std::cout << "power of two rehash test failed" << std::endl;
+    }
+}
+
+void test_incremental_rehash() {
+    const int INITIAL_TABLE_SIZE = 11;
+    const int NUMBER_OF_INPUTS = 1000;
+
+    std::cout << "make a hash table for ints that rehashes incrementally" << std::endl;
+    HashTable<int> table(INITIAL_TABLE_SIZE);
+    table.incremental_rehash(true);
+
+    if (table.incremental_rehash() && table.migration_debt() == 0) {
+        std::cout << "[PASSED] incremental rehash enable test " << std::endl;
+    } else {
+        std::cout << "incremental rehash enable test failed" << std::endl;
+    }
+
+    // Insert until a growth leaves buckets to be moved
+    int inserted = 0;
+    while (table.migration_debt() == 0 && inserted < NUMBER_OF_INPUTS) {
+        table.insert(inserted++);
+    }
+
+    bool all_found = table.migration_debt() > 0 && table.size() == (size_t) inserted;
+
+    // Values not moved yet have no position, and every position given
+    // still holds its value once get_table() has moved the rest
+    HashTable<int> moving(table);
+    std::vector<size_t> positions;
+    for (int n = 0; n < inserted; n++) {
+        positions.push_back(moving.position(n));
+    }
+    auto cells = moving.get_table();
+    size_t unmoved = 0;
+    bool positions_kept = true;
+    for (int n = 0; n < inserted; n++) {
+        if (positions[n] >= cells.size()) {
+            unmoved++;
+        } else {
+            positions_kept = positions_kept && cells[positions[n]].first == HashTable<int>::EntryType::ACTIVE &&
+                             cells[positions[n]].second == n;
+        }
+        positions_kept = positions_kept && moving.position(n) < moving.table_size();
+    }
+
+    if (positions_kept && unmoved > 0 && moving.migration_debt() == 0) {
+        std::cout << "[PASSED] incremental rehash position test " << std::endl;
+    } else {
+        std::cout << "incremental rehash position test failed" << std::endl;
+    }
+
+    for (int n = 0; n < inserted; n++) {
+        all_found = all_found && !table.insert(n);
+    }
+
+    // A copy taken in the middle of the rehash holds the same values
+    HashTable<int> copy(table);
+    for (int n = 0; n < inserted; n++) {
+        all_found = all_found && copy.contains(n) && !copy.contains(n + NUMBER_OF_INPUTS);
+    }
+
+    if (all_found && copy.size() == (size_t) inserted) {
+        std::cout << "[PASSED] incremental rehash lookup test " << std::endl;
+    } else {
+        std::cout << "incremental rehash lookup test failed" << std::endl;
+    }
+
+    for (int n = inserted; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n);
+    }
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        table.remove(n);
+    }
+
+    // Every operation moves a few more, lookups alone finish the rehash
+    size_t lookups = 0;
+    while (table.migration_debt() > 0) {
+        table.contains(NUMBER_OF_INPUTS);
+        lookups++;
+    }
+
+    all_found = lookups < table.table_size();
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n) == (n % 2 == 1);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS / 2) {
+        std::cout << "[PASSED] incremental rehash finish test " << std::endl;
+    } else {
+        std::cout << "incremental rehash finish test failed" << std::endl;
+    }
+
+    table.incremental_rehash(false);
+    table.rehash(4 * table.table_size());
+    if (!table.incremental_rehash() && table.migration_debt() == 0 && table.contains(1) && !table.contains(2)) {
+        std::cout << "[PASSED] incremental rehash disable test " << std::endl;
+    } else {
+        std::cout << "incremental rehash disable test failed" << std::endl;
+    }
+}
+
+void test_move() {
+    const int NUMBER_OF_INPUTS = 100;
+    const int REPEATED_LENGTH = 40;
+
+    std::cout << "make a hash table for strings and move values into it" << std::endl;
+    HashTable<std::string> table;
+
+    std::string value(REPEATED_LENGTH, 'a');
+    bool inserted = table.insert(std::move(value));
+    std::string again(REPEATED_LENGTH, 'a');
+    if (inserted && !table.insert(std::move(again)) && again.size() == REPEATED_LENGTH
+        && table.contains(std::string(REPEATED_LENGTH, 'a'))) {
+        std::cout << "[PASSED] move insert test " << std::endl;
+    } else {
+        std::cout << "move insert test failed" << std::endl;
+    }
+
+    // The arguments of the std::string(count, ch) constructor
+    if (table.emplace(REPEATED_LENGTH, 'b') && !table.emplace(REPEATED_LENGTH, 'b')
+        && table.emplace("c") && table.contains(std::string(REPEATED_LENGTH, 'b')) && table.contains("c")
+        && table.size() == 3) {
+        std::cout << "[PASSED] emplace test " << std::endl;
+    } else {
+        std::cout << "emplace test failed" << std::endl;
+    }
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.emplace(std::to_string(n));
+    }
+
+    table.max_load_factor(0.25f);
+    size_t cells = table.table_size();
+    HashTable<std::string> moved(std::move(table));
+    bool all_found = moved.size() == NUMBER_OF_INPUTS + 3 && moved.table_size() == cells &&
+                     moved.max_load_factor() == 0.25f && table.max_load_factor() == 0.5f;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && moved.contains(std::to_string(n));
+    }
+
+    // The moved from table is still usable
+    if (all_found && table.size() == 0 && table.insert("d") && table.contains("d")) {
+        std::cout << "[PASSED] move constructor test " << std::endl;
+    } else {
+        std::cout << "move constructor test failed" << std::endl;
+    }
+
+    table = std::move(moved);
+    if (table.size() == NUMBER_OF_INPUTS + 3 && table.contains("c") && !table.contains("d") &&
+        table.max_load_factor() == 0.25f) {
+        std::cout << "[PASSED] move assignment test " << std::endl;
+    } else {
+        std::cout << "move assignment test failed" << std::endl;
+    }
+}
+
+void test_transparent() {
+    const int NUMBER_OF_INPUTS = 50;
+
+    std::cout << "make a hash table for strings with a transparent hash" << std::endl;
+    HashTable<std::string, StringHash> table;
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert("/api/v1/session/" + std::to_string(n));
+    }
+
+    // The views point into a larger buffer, as they would from a parser
+    std::string line = "GET /api/v1/session/7 HTTP/1.1";
+    std::string_view view = std::string_view(line).substr(4, 17);
+
+    if (table.contains(view) && table.contains("/api/v1/session/8") && !table.contains(std::string_view(line))) {
+        std::cout << "[PASSED] transparent contains test " << std::endl;
+    } else {
+        std::cout << "transparent contains test failed" << std::endl;
+    }
+
+    if (table.position(view) == table.position(std::string(view)) && table.position("missing") > table.table_size()) {
+        std::cout << "[PASSED] transparent position test " << std::endl;
+    } else {
+        std::cout << "transparent position test failed" << std::endl;
+    }
+
+    if (table.remove(view) == 1 && table.remove(view) == 0 && !table.contains(std::string(view))
+        && table.size() == NUMBER_OF_INPUTS - 1) {
+        std::cout << "[PASSED] transparent remove test " << std::endl;
+    } else {
+        std::cout << "transparent remove test failed" << std::endl;
+    }
+
+    // std::hash<S<Key>> is transparent as well, so S values are found by key
+    HashTable<S<std::string>> wrapped;
+    wrapped.insert(S<std::string>{"alpha"});
+    wrapped.insert(S<std::string>{"beta"});
+
+    if (wrapped.contains("alpha") && wrapped.contains(std::string_view("beta")) && !wrapped.contains("gamma")
+        && wrapped.contains(S<std::string>{"beta"}) && wrapped.remove("alpha") == 1 && wrapped.size() == 1) {
+        std::cout << "[PASSED] transparent S test " << std::endl;
+    } else {
+        std::cout << "transparent S test failed" << std::endl;
+    }
+}
+
+void test_stored_hash() {
+    const int NUMBER_OF_INPUTS = 200;
+
+    std::cout << "make a hash table for strings that stores the hash codes" << std::endl;
+    HashTable<std::string, CountingHash, PrimeCapacity, true> table;
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert("/api/v1/session/" + std::to_string(n));
+    }
+    table.emplace("/api/v1/session/0");
+
+    // Every insert and lookup hashes its argument exactly once
+    bool all_found = CountingHash::calls == NUMBER_OF_INPUTS + 1 && table.size() == NUMBER_OF_INPUTS;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains("/api/v1/session/" + std::to_string(n));
+    }
+    all_found = all_found && !table.contains("/api/v1/session/" + std::to_string(NUMBER_OF_INPUTS));
+
+    if (all_found && CountingHash::calls == 2 * NUMBER_OF_INPUTS + 2) {
+        std::cout << "[PASSED] stored hash lookup test " << std::endl;
+    } else {
+        std::cout << "stored hash lookup test failed" << std::endl;
+    }
+
+    size_t calls = CountingHash::calls;
+    table.rehash(4 * table.table_size());
+    if (CountingHash::calls == calls && table.contains("/api/v1/session/7") && table.remove("/api/v1/session/7") == 1
+        && !table.contains("/api/v1/session/7") && table.size() == NUMBER_OF_INPUTS - 1) {
+        std::cout << "[PASSED] stored hash rehash test " << std::endl;
+    } else {
+        std::cout << "stored hash rehash test failed" << std::endl;
+    }
+
+    // Transparent lookups compare against the stored hash codes as well
+    HashTable<std::string, StringHash, PowerOfTwoCapacity, true> transparent;
+    transparent.insert("alpha");
+    transparent.emplace(4, 'b');
+    if (transparent.contains(std::string_view("alpha")) && transparent.contains("bbbb") && !transparent.contains("bbb")) {
+        std::cout << "[PASSED] stored hash transparent test " << std::endl;
+    } else {
+        std::cout << "stored hash transparent test failed" << std::endl;
+    }
+}
+
+void test_max_load_factor() {
+    const int INITIAL_TABLE_SIZE = 101;
+    const int NUMBER_OF_INPUTS = 90;
+
+    cout << "fill an open addressing hash table to a higher load factor" << endl;
+    HashTable<int> table(INITIAL_TABLE_SIZE);
+    table.max_load_factor(0.9f);
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n);
+    }
+
+    bool all_found = table.table_size() == INITIAL_TABLE_SIZE && table.max_load_factor() == 0.9f;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n);
+    }
+
+    if (all_found) {
+        cout << "[PASSED] max load factor test " << endl;
+    } else {
+        cout << "max load factor test failed" << endl;
+    }
+
+    // Lowering the maximum grows the table right away
+    table.max_load_factor(0.5f);
+    all_found = table.load_factor() <= 0.5f && table.size() == NUMBER_OF_INPUTS;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n);
+    }
+
+    try {
+        table.max_load_factor(1.5f);
+        all_found = false;
+    } catch (const std::invalid_argument &) {
+    }
+
+    if (all_found) {
+        cout << "[PASSED] lower max load factor test " << endl;
+    } else {
+        cout << "lower max load factor test failed" << endl;
+    }
+}
+
+void test_batch() {
+    const int NUMBER_OF_INPUTS = 1000;
+
+    cout << "insert, find and remove keys in batches" << endl;
+    HashTable<int> table;
+    table.incremental_rehash(true);
+
+    std::vector<int> keys;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        keys.push_back(n * 3);
+    }
+    // The duplicate at the end is not inserted twice
+    keys.push_back(0);
+
+    if (table.insert_batch(keys.data(), keys.size()) == NUMBER_OF_INPUTS && table.size() == NUMBER_OF_INPUTS) {
+        cout << "[PASSED] insert batch test " << endl;
+    } else {
+        cout << "insert batch test failed" << endl;
+    }
+
+    // Every other probe is a key that was never inserted
+    std::vector<int> probes;
+    for (int n = 0; n < 2 * NUMBER_OF_INPUTS; n++) {
+        probes.push_back(n % 2 == 0 ? n / 2 * 3 : n * 3 + 1);
+    }
+    std::vector<bool> found;
+    bool all_found = table.contains_batch(probes.data(), probes.size(), found) == NUMBER_OF_INPUTS
+                     && table.contains_batch(probes.data(), probes.size()) == NUMBER_OF_INPUTS
+                     && found.size() == probes.size();
+    for (size_t i = 0; i < probes.size(); i++) {
+        all_found = all_found && found[i] == (i % 2 == 0) && found[i] == table.contains(probes[i]);
+    }
+
+    if (all_found) {
+        cout << "[PASSED] contains batch test " << endl;
+    } else {
+        cout << "contains batch test failed" << endl;
+    }
+
+    if (table.remove_batch(probes.data(), probes.size()) == NUMBER_OF_INPUTS && table.is_empty()
+        && table.remove_batch(keys.data(), 0) == 0) {
+        cout << "[PASSED] remove batch test " << endl;
+    } else {
+        cout << "remove batch test failed" << endl;
+    }
+}
+
+void test_build() {
+    const int NUMBER_OF_INPUTS = 5000;
+
+    cout << "build tables from a range of keys with one and with four threads" << endl;
+    std::vector<int> keys;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        keys.push_back(n * 7);
+    }
+    // Duplicates are only stored once
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 10) {
+        keys.push_back(n * 7);
+    }
+
+    bool all_built = true;
+    for (size_t threads : {1, 4}) {
+        HashTable<int> table;
+        table.insert(-1);
+        table.build(keys.begin(), keys.end(), threads);
+
+        bool built = table.size() == NUMBER_OF_INPUTS && !table.contains(-1) && table.load_factor() <= table.max_load_factor();
+        for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+            built = built && table.contains(n * 7) && !table.contains(n * 7 + 1);
+        }
+        // The table stays usable afterwards
+        built = built && table.insert(-1) && table.remove(0) == 1 && table.size() == NUMBER_OF_INPUTS;
+        all_built = all_built && built;
+    }
+
+    if (all_built) {
+        cout << "[PASSED] build test " << endl;
+    } else {
+        cout << "build test failed" << endl;
+    }
+
+    HashTable<int> empty;
+    empty.build(keys.begin(), keys.begin(), 4);
+    if (empty.is_empty() && empty.insert(1) && empty.contains(1)) {
+        cout << "[PASSED] build empty range test " << endl;
+    } else {
+        cout << "build empty range test failed" << endl;
+    }
+}
+
+void test_parallel_rehash() {
+    const int NUMBER_OF_INPUTS = 20000;
+    const int REHASH_VALUE = 100003;
+
+    cout << "rehash with four threads" << endl;
+    HashTable<int> table;
+    HashTable<int, std::hash<int>, PrimeCapacity, true> hashed;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n * 5);
+        hashed.insert(n * 5);
+    }
+    // Deleted cells are dropped by the rehash
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        table.remove(n * 5);
+        hashed.remove(n * 5);
+    }
+    HashTable<int> copy(table);
+
+    bool rehashed = table.rehash(REHASH_VALUE, 4) && hashed.rehash(REHASH_VALUE, 4) && copy.rehash(REHASH_VALUE, 4)
+                    && table.table_size() == REHASH_VALUE && table.size() == NUMBER_OF_INPUTS / 2
+                    && hashed.size() == NUMBER_OF_INPUTS / 2;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        rehashed = rehashed && table.contains(n * 5) == (n % 2 == 1) && hashed.contains(n * 5) == (n % 2 == 1)
+                   && table.position(n * 5) == copy.position(n * 5);
+    }
+
+    if (rehashed) {
+        cout << "[PASSED] parallel rehash test " << endl;
+    } else {
+        cout << "parallel rehash test failed" << endl;
+    }
+
+    if (!table.rehash(NUMBER_OF_INPUTS / 2, 4) && table.table_size() == REHASH_VALUE) {
+        cout << "[PASSED] parallel rehash over load factor test " << endl;
+    } else {
+        cout << "parallel rehash over load factor test failed" << endl;
+    }
+}
+
+void test_seeded_hash() {
+    const int NUMBER_OF_INPUTS = 1000;
+    const std::uint64_t SEED = 42;
+
+    cout << "use the bundled hashes, with and without a seed" << endl;
+    HashTable<int, WyHash<>> wy;
+    HashTable<std::string, Xxh3Hash<SEED>> xxh3;
+    HashTable<std::string, MurmurHash<>, PowerOfTwoCapacity> murmur;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        wy.insert(n);
+        xxh3.insert("key " + std::to_string(n));
+        murmur.insert(std::string(n % 70, 'x') + std::to_string(n));
+    }
+
+    bool all_found = wy.size() == NUMBER_OF_INPUTS && xxh3.size() == NUMBER_OF_INPUTS
+                     && murmur.size() == NUMBER_OF_INPUTS;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && wy.contains(n) && !wy.contains(n + NUMBER_OF_INPUTS)
+                    && xxh3.contains(std::string_view("key " + std::to_string(n)))
+                    && murmur.contains(std::string(n % 70, 'x') + std::to_string(n));
+    }
+
+    if (all_found) {
+        cout << "[PASSED] seeded hash table test " << endl;
+    } else {
+        cout << "seeded hash table test failed" << endl;
+    }
+
+    // Every length up to well past the longest short input path
+    std::string text(200, 'a');
+    for (size_t i = 0; i < text.size(); i++) {
+        text[i] = (char) ('a' + i * 7 % 26);
+    }
+    bool consistent = true;
+    for (size_t length = 0; length <= text.size(); length++) {
+        std::string key = text.substr(0, length);
+        std::string other = key;
+        if (length > 0) {
+            other[length / 2] ^= 1;
+        }
+        consistent = consistent && WyHash<>{}(key) == WyHash<>{}(std::string_view(key))
+                     && Xxh3Hash<>{}(key) == Xxh3Hash<>{}(key.c_str())
+                     && MurmurHash<>{}(key) == MurmurHash<>(0)(key)
+                     && WyHash<>{}(key) != WyHash<SEED>{}(key) && Xxh3Hash<>{}(key) != Xxh3Hash<>(SEED)(key)
+                     && MurmurHash<>{}(key) != MurmurHash<SEED>{}(key)
+                     && (length == 0 || (WyHash<>{}(key) != WyHash<>{}(other) && Xxh3Hash<>{}(key) != Xxh3Hash<>{}(other)
+                                         && MurmurHash<>{}(key) != MurmurHash<>{}(other)));
+    }
+
+    if (consistent && WyHash<>{}(7) == WyHash<>{}(7L) && Xxh3Hash<>{}(7) != Xxh3Hash<>{}(8)
+        && MurmurHash<>{}(7) != MurmurHash<SEED>{}(7)) {
+        cout << "[PASSED] seeded hash values test " << endl;
+    } else {
+        cout << "seeded hash values test failed" << endl;
+    }
+}
+
+// Visits the home cell and the one after it, over and over, while
+// claiming to reach every cell, so three values whose homes are at most
+// one cell apart leave the last with no free cell
+struct ShortProbe {
+    template<class Capacity>
+    static constexpr size_t round_up(size_t cells) {
+        return Capacity::round_up(cells);
+    }
+
+    template<class Capacity>
+    static constexpr float max_load_factor() {
+        return 1.0f;
+    }
+
+    template<class Capacity>
+    class Sequence {
+    public:
+        Sequence(size_t hash_value, size_t cells) : home(Capacity::index(hash_value, cells)), step(0), cells(cells) {}
+
+        size_t index() const {
+            return (home + step) % cells;
+        }
+
+        void next() {
+            step = (step + 1) % 2;
+        }
+
+    private:
+        size_t home;
+        size_t step;
+        size_t cells;
+    };
+};
+
+struct MixedHash {
+    size_t operator()(int key) const {
+        size_t mixed = (size_t) key * 0x9E3779B97F4A7C15ULL;
+        return mixed ^ mixed >> 31;
+    }
+};
+
+// Inserts, finds and removes values in a table with the given probe
+// policy, also through a rehash, a parallel rehash and a build
+template<class Table>
+bool probe_round_trip() {
+    const int NUMBER_OF_INPUTS = 2000;
+
+    Table table;
+    std::vector<int> keys;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        keys.push_back(n * 11);
+        table.insert(n * 11);
+    }
+    bool ok = table.size() == NUMBER_OF_INPUTS && !table.insert(0);
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        ok = ok && table.remove(n * 11) == 1;
+    }
+    ok = ok && table.rehash(4 * table.table_size()) && table.rehash(2 * table.table_size(), 3);
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        ok = ok && table.contains(n * 11) == (n % 2 == 1) && !table.contains(n * 11 + 1);
+    }
+
+    table.build(keys.begin(), keys.end(), 3);
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        ok = ok && table.contains(n * 11);
+    }
+    return ok && table.size() == NUMBER_OF_INPUTS;
+}
+
+void test_probe_policies() {
+    const size_t PRIME_CELLS = 11;
+    const size_t POWER_OF_TWO_CELLS = 16;
+
+    cout << "probe with the quadratic, triangular and double hashing policies" << endl;
+    // Cells visited from home cell 0
+    std::vector<size_t> quadratic;
+    QuadraticProbe::Sequence<PrimeCapacity> squares(0, PRIME_CELLS);
+    for (int i = 0; i < 6; i++, squares.next()) {
+        quadratic.push_back(squares.index());
+    }
+    // Both of these reach every cell
+    std::vector<bool> triangular(POWER_OF_TWO_CELLS, false);
+    TriangularProbe::Sequence<PowerOfTwoCapacity> triangles(0, POWER_OF_TWO_CELLS);
+    for (size_t i = 0; i < POWER_OF_TWO_CELLS; i++, triangles.next()) {
+        triangular[triangles.index()] = true;
+    }
+    std::vector<bool> double_hashed(PRIME_CELLS, false);
+    DoubleHashProbe::Sequence<PrimeCapacity> steps((size_t) 12345 << 32, PRIME_CELLS);
+    for (size_t i = 0; i < PRIME_CELLS; i++, steps.next()) {
+        double_hashed[steps.index()] = true;
+    }
+
+    if (quadratic == std::vector<size_t>{0, 1, 4, 9, 5, 3}
+        && std::count(triangular.begin(), triangular.end(), false) == 0
+        && std::count(double_hashed.begin(), double_hashed.end(), false) == 0) {
+        cout << "[PASSED] probe sequence test " << endl;
+    } else {
+        cout << "probe sequence test failed" << endl;
+    }
+
+    if (probe_round_trip<HashTable<int, std::hash<int>, PrimeCapacity, false, QuadraticProbe>>()
+        && probe_round_trip<HashTable<int, std::hash<int>, PowerOfTwoCapacity, false, TriangularProbe>>()
+        && probe_round_trip<HashTable<int, std::hash<int>, PrimeCapacity, true, DoubleHashProbe>>()
+        && probe_round_trip<HashTable<int, std::hash<int>, PowerOfTwoCapacity, false, DoubleHashProbe>>()) {
+        cout << "[PASSED] probe policy table test " << endl;
+    } else {
+        cout << "probe policy table test failed" << endl;
+    }
+
+    // A policy may only be run up to the load factor its sequences reach
+    // a free cell at, and sizes are rounded to ones it reaches half of
+    HashTable<int, std::hash<int>, PrimeCapacity, false, QuadraticProbe> quadratic_table(100);
+    bool refused = false;
+    try {
+        quadratic_table.max_load_factor(0.6f);
+    } catch (const std::invalid_argument &) {
+        refused = true;
+    }
+    quadratic_table.rehash(1000);
+    if (refused && quadratic_table.max_load_factor() == 0.5f && quadratic_table.table_size() == 1009 &&
+        PrimeCapacity::is_prime(HashTable<int, std::hash<int>, PrimeCapacity, false, TriangularProbe>(50).table_size())) {
+        cout << "[PASSED] probe load bound test " << endl;
+    } else {
+        cout << "probe load bound test failed" << endl;
+    }
+
+    // A sequence that reaches only two cells makes every way of placing
+    // values grow the table instead of losing them
+    using ShortTable = HashTable<int, MixedHash, PrimeCapacity, false, ShortProbe>;
+    const int NUMBER_OF_INPUTS = 3000;
+    ShortTable dense;
+    dense.max_load_factor(0.95f);
+    std::vector<int> keys;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        keys.push_back(n * 11);
+        dense.insert(n * 11);
+    }
+    ShortTable rehashed(dense);
+    ShortTable built;
+    built.max_load_factor(0.95f);
+    built.build(keys.begin(), keys.end(), 3);
+    bool kept = dense.rehash(dense.size() + dense.size() / 10) &&
+                rehashed.rehash(rehashed.size() + rehashed.size() / 10, 3);
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        kept = kept && dense.contains(n * 11) && rehashed.contains(n * 11) && built.contains(n * 11);
+    }
+
+    // The first three keys share a home cell once the values are migrated
+    // to the larger table
+    HashTable<int, std::hash<int>, PrimeCapacity, false, ShortProbe> migrated;
+    migrated.incremental_rehash(true);
+    int target = (int) PrimeCapacity::next_size(migrated.table_size() * 4);
+    std::vector<int> shared{0, target, 2 * target, 1, 2, 3, 4, 5};
+    for (int key : shared) {
+        migrated.insert(key);
+    }
+    bool moved = migrated.size() == shared.size() && migrated.table_size() > (size_t) target;
+    for (int key : shared) {
+        moved = moved && migrated.contains(key);
+    }
+
+    if (probe_round_trip<ShortTable>() && kept && moved && dense.size() == NUMBER_OF_INPUTS &&
+        rehashed.size() == NUMBER_OF_INPUTS && built.size() == NUMBER_OF_INPUTS) {
+        cout << "[PASSED] probe overflow test " << endl;
+    } else {
+        cout << "probe overflow test failed" << endl;
+    }
+}
+
+void test_snapshot() {
+    const int NUMBER_OF_INPUTS = 5000;
+    const std::string PATH = "open_addressing_snapshot.tmp";
+
+    cout << "save a table of ints and serve lookups from the mapped file" << endl;
+    HashTable<int> table;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n * 3);
+    }
+    // Leave deleted cells in the probe sequences
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 7) {
+        table.remove(n * 3);
+    }
+    table.save(PATH);
+
+    auto mapped = HashTable<int>::open_mapped(PATH);
+    bool same = mapped.size() == table.size() && mapped.table_size() == table.table_size();
+    for (int n = 0; n < NUMBER_OF_INPUTS * 3 && same; n++) {
+        same = mapped.contains(n) == table.contains(n) && mapped.position(n) == table.position(n);
+    }
+    if (same && !mapped.is_empty()) {
+        cout << "[PASSED] mapped lookup test " << endl;
+    } else {
+        cout << "mapped lookup test failed" << endl;
+    }
+
+    // The mapping moves with the table and outlives the file name
+    auto moved = std::move(mapped);
+    std::remove(PATH.c_str());
+    if (moved.contains(3) && !moved.contains(0) && mapped.size() == 0 && !mapped.contains(3)) {
+        cout << "[PASSED] mapped move test " << endl;
+    } else {
+        cout << "mapped move test failed" << endl;
+    }
+
+    // Stored hash codes and an empty table
+    HashTable<long, std::hash<long>, PowerOfTwoCapacity, true> hashed;
+    HashTable<long, std::hash<long>, PowerOfTwoCapacity, true> empty;
+    for (long n = 0; n < NUMBER_OF_INPUTS; n++) {
+        hashed.insert(n * n);
+    }
+    hashed.save(PATH);
+    auto mapped_hashed = decltype(hashed)::open_mapped(PATH);
+    empty.save(PATH);
+    auto mapped_empty = decltype(empty)::open_mapped(PATH);
+    if (mapped_hashed.size() == NUMBER_OF_INPUTS && mapped_hashed.contains(49) && !mapped_hashed.contains(50) &&
+        mapped_empty.is_empty() && !mapped_empty.contains(0)) {
+        cout << "[PASSED] mapped stored hash test " << endl;
+    } else {
+        cout << "mapped stored hash test failed" << endl;
+    }
+
+    // Snapshots of another key size, hash or capacity are refused, as
+    // are missing files and files that are not snapshots
+    table.save(PATH);
+    int refused = 0;
+    auto try_open = [&](auto open) {
+        try {
+            open();
+        } catch (const std::runtime_error &) {
+            refused++;
+        }
+    };
+    try_open([&] { HashTable<long>::open_mapped(PATH); });
+    try_open([&] { HashTable<int, WyHash<>>::open_mapped(PATH); });
+    try_open([&] { HashTable<int, WyHash<>, PrimeCapacity, true>::open_mapped(PATH); });
+    try_open([&] { HashTable<int, std::hash<int>, PowerOfTwoCapacity>::open_mapped(PATH); });
+    try_open([&] { HashTable<int>::open_mapped(PATH + ".missing"); });
+    // A cell count that only matches the file length once the product
+    // with the cell size overflows
+    {
+        std::fstream patched(PATH, std::ios::binary | std::ios::in | std::ios::out);
+        open_addressing::SnapshotHeader header;
+        patched.read(reinterpret_cast<char *>(&header), sizeof(header));
+        header.cells += (std::uint64_t{1} << 63) / header.cell_size * 2;
+        patched.seekp(0);
+        patched.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    try_open([&] { HashTable<int>::open_mapped(PATH); });
+    {
+        std::ofstream junk(PATH, std::ios::binary | std::ios::trunc);
+        junk << "not a snapshot, only text that is long enough to hold a header........................";
+    }
+    try_open([&] { HashTable<int>::open_mapped(PATH); });
+    std::remove(PATH.c_str());
+
+    if (refused == 7) {
+        cout << "[PASSED] mapped type check test " << endl;
+    } else {
+        cout << "mapped type check test failed" << endl;
+    }
+}
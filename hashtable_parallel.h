@@ -0,0 +1,91 @@
+#ifndef HASHTABLE_PARALLEL_H
+#define HASHTABLE_PARALLEL_H
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Helpers for the operations that split their work over several threads,
+// such as building a table from a range of keys. Each thread works on its
+// own part of the data, so none of them take locks.
+
+//-------------------------------------------------------
+// Name: thread_count
+// PreCondition:
+// PostCondition: returns the number of threads to use when zero is
+// asked for, one per hardware thread.
+//---------------------------------------------------------
+inline std::size_t thread_count(std::size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+    }
+    return num_threads == 0 ? 1 : num_threads;
+}
+
+//-------------------------------------------------------
+// Name: parallel_for
+// PreCondition:  num_threads is greater than zero
+// PostCondition: splits [0, n) into num_threads contiguous slices and
+// calls work(t, first, last) for each slice t on its own
+// thread, the first slice on the calling thread.
+// Returns once every slice is done.
+//---------------------------------------------------------
+template<class Work>
+void parallel_for(std::size_t num_threads, std::size_t n, Work work) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (std::size_t t = 1; t < num_threads; t++) {
+        threads.emplace_back(work, t, n * t / num_threads, n * (t + 1) / num_threads);
+    }
+    work(0, 0, n / num_threads);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+//-------------------------------------------------------
+// Name: partition_by_region
+// PreCondition:  region[i] < regions for every i in [0, n)
+// PostCondition: fills order with the indices 0 to n - 1 grouped by
+// region, keeping their order within a region, and
+// offsets with regions + 1 entries so that the indices
+// of region r are order[offsets[r]] up to
+// order[offsets[r + 1]]. Every thread counts and then
+// scatters its own slice of the indices.
+//---------------------------------------------------------
+template<class Region>
+void partition_by_region(std::size_t num_threads, std::size_t n, std::size_t regions, const Region &region,
+                         std::vector<std::size_t> &order, std::vector<std::size_t> &offsets) {
+    // counts[t * regions + r] is the number of indices of slice t in region r
+    std::vector<std::size_t> counts(num_threads * regions, 0);
+    parallel_for(num_threads, n, [&](std::size_t t, std::size_t first, std::size_t last) {
+        std::size_t *count = &counts[t * regions];
+        for (std::size_t i = first; i < last; i++) {
+            count[region[i]]++;
+        }
+    });
+
+    // Turn the counts into the position of each slice's first index in
+    // each region
+    offsets.assign(regions + 1, 0);
+    std::size_t position = 0;
+    for (std::size_t r = 0; r < regions; r++) {
+        offsets[r] = position;
+        for (std::size_t t = 0; t < num_threads; t++) {
+            std::size_t slice_count = counts[t * regions + r];
+            counts[t * regions + r] = position;
+            position += slice_count;
+        }
+    }
+    offsets[regions] = position;
+
+    order.resize(n);
+    parallel_for(num_threads, n, [&](std::size_t t, std::size_t first, std::size_t last) {
+        std::size_t *next = &counts[t * regions];
+        for (std::size_t i = first; i < last; i++) {
+            order[next[region[i]]++] = i;
+        }
+    });
+}
+
+#endif  // HASHTABLE_PARALLEL_H
@@ -0,0 +1,706 @@
+#ifndef HASHTABLE_POOLED_CHAINING_H
+#define HASHTABLE_POOLED_CHAINING_H
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "hashtable_capacity.h"
+#include "hashtable_hash.h"
+
+//-------------------------------------------------------
+// Slab allocator for the nodes of one table. Nodes are carved out of slabs
+// that double in size up to a limit, a removed node goes on a free list for
+// the next insert, and clear() releases every slab at once. The pool only
+// hands out memory, constructing and destroying the nodes is up to the
+// table.
+//---------------------------------------------------------
+template<class Node>
+class NodePool {
+public:
+    NodePool();
+
+    NodePool(const NodePool &other) = delete;
+
+    NodePool &operator=(const NodePool &other) = delete;
+
+    ~NodePool();
+
+    void swap(NodePool &other);
+
+    void *allocate();
+
+    void release(void *node);
+
+    void clear();
+
+    size_t allocated_bytes() const;
+
+private:
+    // A released node, reusing the memory of the node itself
+    struct FreeNode {
+        FreeNode *next;
+    };
+
+    // Each slab with its number of nodes
+    std::vector<std::pair<Node *, size_t>> slabs;
+    FreeNode *free_list;
+    size_t slab_capacity;
+    size_t used_in_slab;
+    size_t bytes;
+
+    // Slab sizes, in nodes
+    static constexpr size_t FIRST_SLAB_NODES = 64;
+    static constexpr size_t MAX_SLAB_NODES = 65536;
+};
+
+template<class Node>
+NodePool<Node>::NodePool() : free_list(nullptr), slab_capacity(0), used_in_slab(0), bytes(0) {
+}
+
+template<class Node>
+NodePool<Node>::~NodePool() {
+    clear();
+}
+
+template<class Node>
+void NodePool<Node>::swap(NodePool &other) {
+    slabs.swap(other.slabs);
+    std::swap(free_list, other.free_list);
+    std::swap(slab_capacity, other.slab_capacity);
+    std::swap(used_in_slab, other.used_in_slab);
+    std::swap(bytes, other.bytes);
+}
+
+//-------------------------------------------------------
+// Name: allocate()
+// PreCondition:
+// PostCondition: return uninitialized memory for one node, taken from
+// the free list or else from the current slab, starting
+// a new slab when it is full
+//---------------------------------------------------------
+template<class Node>
+void *NodePool<Node>::allocate() {
+    if (free_list != nullptr) {
+        FreeNode *node = free_list;
+        free_list = node->next;
+        return node;
+    }
+
+    if (slabs.empty() || used_in_slab == slab_capacity) {
+        slab_capacity = slabs.empty() ? FIRST_SLAB_NODES : std::min(slab_capacity * 2, MAX_SLAB_NODES);
+        slabs.emplace_back(std::allocator<Node>().allocate(slab_capacity), slab_capacity);
+        used_in_slab = 0;
+        bytes += slab_capacity * sizeof(Node);
+    }
+
+    return slabs.back().first + used_in_slab++;
+}
+
+//-------------------------------------------------------
+// Name: release()
+// PreCondition: node came from allocate() and has been destroyed
+// PostCondition: put the node memory on the free list
+//---------------------------------------------------------
+template<class Node>
+void NodePool<Node>::release(void *node) {
+    free_list = new(node) FreeNode{free_list};
+}
+
+//-------------------------------------------------------
+// Name: clear()
+// PreCondition: every node has been destroyed
+// PostCondition: release all slabs
+//---------------------------------------------------------
+template<class Node>
+void NodePool<Node>::clear() {
+    for (auto &slab : slabs) {
+        std::allocator<Node>().deallocate(slab.first, slab.second);
+    }
+    slabs.clear();
+    free_list = nullptr;
+    slab_capacity = 0;
+    used_in_slab = 0;
+    bytes = 0;
+}
+
+//-------------------------------------------------------
+// Name: allocated_bytes()
+// PreCondition:
+// PostCondition: return the size of all slabs
+//---------------------------------------------------------
+template<class Node>
+size_t NodePool<Node>::allocated_bytes() const {
+    return bytes;
+}
+
+// Separate chaining with singly linked nodes that are allocated from a
+// NodePool owned by the table instead of one heap allocation per value.
+// The buckets are the heads of intrusive lists, a rehash relinks the
+// existing nodes into the new buckets, and make_empty() or the destructor
+// frees all nodes by releasing the slabs. Same interface as the separate
+// chaining HashTable.
+template<class Key, class Hash=std::hash<Key>, class Capacity=PrimeCapacity>
+class PooledHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+private:
+    struct Node {
+        Node *next;
+        Key value;
+
+        template<class... Args>
+        explicit Node(Args &&... args) : next(nullptr), value(std::forward<Args>(args)...) {}
+    };
+
+    // The head of the list in each bucket
+    std::vector<Node *> table;
+    size_type count;
+    float maximum_load_factor;
+    NodePool<Node> pool;
+
+    // Constants
+    static constexpr size_type DEFAULT_BUCKET_SIZE = 11;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 1.0f;
+
+    template<class Value>
+    bool place(Value &&value);
+
+    template<class K>
+    Node **find(const K &key);
+
+    template<class K>
+    size_t remove_key(const K &key);
+
+    void grow();
+
+    void relink(size_type buckets);
+
+    void destroy_all();
+
+public:
+    PooledHashTable();
+
+    PooledHashTable(size_type buckets);
+
+    PooledHashTable(const PooledHashTable &other);
+
+    PooledHashTable(PooledHashTable &&other);
+
+    ~PooledHashTable();
+
+    PooledHashTable &operator=(const PooledHashTable &other);
+
+    PooledHashTable &operator=(PooledHashTable &&other);
+
+    void swap(PooledHashTable &other);
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    void make_empty();
+
+    bool insert(const value_type &value);
+
+    bool insert(value_type &&value);
+
+    template<class... Args>
+    bool emplace(Args &&... args);
+
+    size_t remove(const key_type &key);
+
+    bool contains(const key_type &key);
+
+    // Lookups by any type a transparent Hash accepts
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    size_t remove(const K &key);
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    bool contains(const K &key);
+
+    size_t bucket_count() const;
+
+    size_t bucket_size(size_t n) const;
+
+    size_t bucket(const key_type &key) const;
+
+    float load_factor() const;
+
+    float max_load_factor() const;
+
+    void max_load_factor(float mlf);
+
+    bool rehash(size_type count);
+
+    size_t allocated_bytes() const;
+
+    void print_table(std::ostream &os = std::cout) const;
+};
+
+//-------------------------------------------------------
+// Name: PooledHashTable()
+// PreCondition:
+// PostCondition: makes an empty table with 11 buckets, rounded up to a
+// size the capacity policy allows
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+PooledHashTable<Key, Hash, Capacity>::PooledHashTable() : PooledHashTable(DEFAULT_BUCKET_SIZE) {
+}
+
+//-------------------------------------------------------
+// Name: PooledHashTable(size_type buckets)
+// PreCondition: buckets is greater than zero
+// PostCondition: makes an empty table with the specified number of
+// buckets, rounded up to a size the capacity policy allows
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+PooledHashTable<Key, Hash, Capacity>::PooledHashTable(size_type buckets) {
+    table.assign(Capacity::round_up(buckets), nullptr);
+    count = 0;
+    maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+}
+
+//-------------------------------------------------------
+// Name: PooledHashTable(const PooledHashTable &other)
+// PreCondition:
+// PostCondition: makes a copy of other with its own pool
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+PooledHashTable<Key, Hash, Capacity>::PooledHashTable(const PooledHashTable &other)
+        : PooledHashTable(other.table.size()) {
+    maximum_load_factor = other.maximum_load_factor;
+    for (Node *head : other.table) {
+        for (Node *node = head; node != nullptr; node = node->next) {
+            insert(node->value);
+        }
+    }
+}
+
+//-------------------------------------------------------
+// Name: PooledHashTable(PooledHashTable &&other)
+// PreCondition:
+// PostCondition: take over the buckets and the pool of other, which is
+// left empty with the default number of buckets
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+PooledHashTable<Key, Hash, Capacity>::PooledHashTable(PooledHashTable &&other) : PooledHashTable() {
+    swap(other);
+}
+
+//-------------------------------------------------------
+// Name: ~PooledHashTable()
+// PreCondition:
+// PostCondition: destroy the values, the pool then frees the slabs
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+PooledHashTable<Key, Hash, Capacity>::~PooledHashTable() {
+    destroy_all();
+}
+
+//-------------------------------------------------------
+// Name: operator=(const PooledHashTable &other)
+// PreCondition:
+// PostCondition: replace the contents with a copy of other
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+PooledHashTable<Key, Hash, Capacity> &PooledHashTable<Key, Hash, Capacity>::operator=(const PooledHashTable &other) {
+    if (this != &other) {
+        PooledHashTable copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+//-------------------------------------------------------
+// Name: operator=(PooledHashTable &&other)
+// PreCondition:
+// PostCondition: take over the buckets and the pool of other, which is
+// left with the previous contents of this table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+PooledHashTable<Key, Hash, Capacity> &PooledHashTable<Key, Hash, Capacity>::operator=(PooledHashTable &&other) {
+    swap(other);
+    return *this;
+}
+
+//-------------------------------------------------------
+// Name: swap()
+// PreCondition:
+// PostCondition: exchange the contents of the two tables, the nodes
+// stay in the pool that allocated them
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+void PooledHashTable<Key, Hash, Capacity>::swap(PooledHashTable &other) {
+    table.swap(other.table);
+    std::swap(count, other.count);
+    std::swap(maximum_load_factor, other.maximum_load_factor);
+    pool.swap(other.pool);
+}
+
+//-------------------------------------------------------
+// Name: is_empty()
+// PreCondition:
+// PostCondition: return true if the table holds no values
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+bool PooledHashTable<Key, Hash, Capacity>::is_empty() const {
+    return count == 0;
+}
+
+//-------------------------------------------------------
+// Name: size()
+// PreCondition:
+// PostCondition: return the number of values in the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+size_t PooledHashTable<Key, Hash, Capacity>::size() const {
+    return count;
+}
+
+//-------------------------------------------------------
+// Name: make_empty()
+// PreCondition:
+// PostCondition: remove all values and free all nodes at once, the
+// number of buckets is kept
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+void PooledHashTable<Key, Hash, Capacity>::make_empty() {
+    destroy_all();
+    std::fill(table.begin(), table.end(), nullptr);
+    count = 0;
+    pool.clear();
+}
+
+//-------------------------------------------------------
+// Name: destroy_all()
+// PreCondition:
+// PostCondition: run the destructor of every value, the nodes are
+// left in place for the pool to free
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+void PooledHashTable<Key, Hash, Capacity>::destroy_all() {
+    if constexpr (!std::is_trivially_destructible<Key>::value) {
+        for (Node *head : table) {
+            for (Node *node = head; node != nullptr;) {
+                Node *next = node->next;
+                node->~Node();
+                node = next;
+            }
+        }
+    }
+}
+
+//-------------------------------------------------------
+// Name: insert()
+// PreCondition:
+// PostCondition: insert the given value into the table, rehashing if
+// the maximum load factor is exceeded, return true if
+// insert was successful (false if item already exists)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+bool PooledHashTable<Key, Hash, Capacity>::insert(const value_type &value) {
+    return place(value);
+}
+
+template<class Key, class Hash, class Capacity>
+bool PooledHashTable<Key, Hash, Capacity>::insert(value_type &&value) {
+    return place(std::move(value));
+}
+
+//-------------------------------------------------------
+// Name: emplace()
+// PreCondition:
+// PostCondition: construct the value from the given arguments directly
+// in a pooled node, return true if insert was successful
+// (false if item already exists, the node then goes back
+// to the pool)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+template<class... Args>
+bool PooledHashTable<Key, Hash, Capacity>::emplace(Args &&... args) {
+    Node *node = new(pool.allocate()) Node(std::forward<Args>(args)...);
+
+    if (*find(node->value) != nullptr) {
+        node->~Node();
+        pool.release(node);
+        return false;
+    }
+
+    Node *&head = table[Capacity::index(Hash{}(node->value), table.size())];
+    node->next = head;
+    head = node;
+    count++;
+    grow();
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: place()
+// PreCondition:
+// PostCondition: the insert shared by copies and moves, the node is
+// only taken from the pool once the value is known to be
+// new
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+template<class Value>
+bool PooledHashTable<Key, Hash, Capacity>::place(Value &&value) {
+    Node **link = find(value);
+    if (*link != nullptr) {
+        return false;
+    }
+
+    // The end of the chain is as good as the head, and already at hand
+    *link = new(pool.allocate()) Node(std::forward<Value>(value));
+    count++;
+    grow();
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: find()
+// PreCondition:
+// PostCondition: return the link that points to the node holding key,
+// or the null link at the end of its bucket if there is
+// none
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+template<class K>
+typename PooledHashTable<Key, Hash, Capacity>::Node **PooledHashTable<Key, Hash, Capacity>::find(const K &key) {
+    Node **link = &table[Capacity::index(Hash{}(key), table.size())];
+    while (*link != nullptr && !((*link)->value == key)) {
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+//-------------------------------------------------------
+// Name: grow()
+// PreCondition:
+// PostCondition: rehash to more buckets if the maximum load factor is
+// exceeded
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+void PooledHashTable<Key, Hash, Capacity>::grow() {
+    if (load_factor() > maximum_load_factor) {
+        relink(Capacity::next_size(table.size() * 2));
+    }
+}
+
+//-------------------------------------------------------
+// Name: remove()
+// PreCondition:
+// PostCondition: remove the specified value from the table and return
+// its node to the pool, return number of elements
+// removed (0 or 1)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+size_t PooledHashTable<Key, Hash, Capacity>::remove(const key_type &key) {
+    return remove_key(key);
+}
+
+template<class Key, class Hash, class Capacity>
+template<class K, class H, class>
+size_t PooledHashTable<Key, Hash, Capacity>::remove(const K &key) {
+    return remove_key(key);
+}
+
+template<class Key, class Hash, class Capacity>
+template<class K>
+size_t PooledHashTable<Key, Hash, Capacity>::remove_key(const K &key) {
+    Node **link = find(key);
+    Node *node = *link;
+    if (node == nullptr) {
+        return 0;
+    }
+
+    *link = node->next;
+    node->~Node();
+    pool.release(node);
+    count--;
+    return 1;
+}
+
+//-------------------------------------------------------
+// Name: contains()
+// PreCondition:
+// PostCondition: return true if the specified value is in the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+bool PooledHashTable<Key, Hash, Capacity>::contains(const key_type &key) {
+    return *find(key) != nullptr;
+}
+
+template<class Key, class Hash, class Capacity>
+template<class K, class H, class>
+bool PooledHashTable<Key, Hash, Capacity>::contains(const K &key) {
+    return *find(key) != nullptr;
+}
+
+//-------------------------------------------------------
+// Name: bucket_count()
+// PreCondition:
+// PostCondition: return the number of buckets in the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+size_t PooledHashTable<Key, Hash, Capacity>::bucket_count() const {
+    return table.size();
+}
+
+//-------------------------------------------------------
+// Name: bucket_size()
+// PreCondition:
+// PostCondition: return the number of values in the nth bucket, throw
+// std::out_of_range if n is not a bucket
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+size_t PooledHashTable<Key, Hash, Capacity>::bucket_size(size_t n) const {
+    if (n >= table.size()) throw std::out_of_range("Value is out of range");
+
+    size_t length = 0;
+    for (Node *node = table[n]; node != nullptr; node = node->next) {
+        length++;
+    }
+    return length;
+}
+
+//-------------------------------------------------------
+// Name: bucket()
+// PreCondition:
+// PostCondition: return the index of the bucket that contains the
+// specified value (or would contain it, if it existed)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+size_t PooledHashTable<Key, Hash, Capacity>::bucket(const key_type &key) const {
+    return Capacity::index(Hash{}(key), table.size());
+}
+
+//-------------------------------------------------------
+// Name: load_factor()
+// PreCondition:
+// PostCondition: return the current load factor of the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+float PooledHashTable<Key, Hash, Capacity>::load_factor() const {
+    return (float) count / (float) table.size();
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:
+// PostCondition: return the maximum load factor of the table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+float PooledHashTable<Key, Hash, Capacity>::max_load_factor() const {
+    return maximum_load_factor;
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:  mlf is greater than zero
+// PostCondition: set the maximum load factor of the table, throws
+// std::invalid_argument if the input is not greater than
+// zero.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+void PooledHashTable<Key, Hash, Capacity>::max_load_factor(float mlf) {
+    if (!(mlf > 0.0f)) {
+        throw std::invalid_argument("max load factor must be greater than 0");
+    }
+    maximum_load_factor = mlf;
+}
+
+//-------------------------------------------------------
+// Name: rehash()
+// PreCondition:
+// PostCondition: set the number of buckets to the specified value,
+// rounded up to a size the capacity policy allows, unless
+// that would exceed the maximum load factor. The nodes
+// are relinked, not reallocated. Returns false if the
+// number of buckets is unchanged or would exceed the
+// maximum load factor.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+bool PooledHashTable<Key, Hash, Capacity>::rehash(size_type count) {
+    count = Capacity::round_up(count);
+
+    if (count == table.size()) {
+        return false;
+    }
+
+    if (((float) size() / count) > maximum_load_factor) {
+        return false;
+    }
+
+    relink(count);
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: relink()
+// PreCondition: buckets can hold all the values
+// PostCondition: move every node to the head of its bucket in a new
+// array of buckets
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+void PooledHashTable<Key, Hash, Capacity>::relink(size_type buckets) {
+    std::vector<Node *> old_table(buckets, nullptr);
+    old_table.swap(table);
+
+    for (Node *head : old_table) {
+        for (Node *node = head; node != nullptr;) {
+            Node *next = node->next;
+            Node *&new_head = table[Capacity::index(Hash{}(node->value), table.size())];
+            node->next = new_head;
+            new_head = node;
+            node = next;
+        }
+    }
+}
+
+//-------------------------------------------------------
+// Name: allocated_bytes()
+// PreCondition:
+// PostCondition: return the memory held for nodes, including the
+// nodes that are free for reuse
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+size_t PooledHashTable<Key, Hash, Capacity>::allocated_bytes() const {
+    return pool.allocated_bytes();
+}
+
+//-------------------------------------------------------
+// Name: print_table()
+// PreCondition:
+// PostCondition: print the non empty buckets and their values
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity>
+void PooledHashTable<Key, Hash, Capacity>::print_table(std::ostream &os) const {
+    if (is_empty()) {
+        os << "<empty>\n";
+        return;
+    }
+
+    for (size_type i = 0; i < table.size(); i++) {
+        if (table[i] == nullptr) {
+            continue;
+        }
+        os << i << ": [";
+        for (Node *node = table[i]; node != nullptr; node = node->next) {
+            os << node->value << (node->next != nullptr ? ", " : "");
+        }
+        os << "]" << std::endl;
+    }
+}
+
+#endif  // HASHTABLE_POOLED_CHAINING_H
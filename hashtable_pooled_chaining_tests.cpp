@@ -0,0 +1,198 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "hashtable_pooled_chaining.h"
+
+void test_integer_1();
+
+void test_strings();
+
+void test_pool_reuse();
+
+void test_copy_and_move();
+
+int main() {
+    test_integer_1();
+    test_strings();
+    test_pool_reuse();
+    test_copy_and_move();
+    return 0;
+}
+
+void test_integer_1() {
+    const int INITIAL_SIZE = 0;
+    const int INITIAL_TABLE_SIZE = 11;
+    const int NUMBER_OF_INPUTS = 3;
+    const int NUMBER_OF_INPUTS_AFTER_REMOVE = 2;
+    const int VALID_REHASH_VALUE = 50;
+
+    std::cout << "make an empty pooled hash table with 11 buckets for ints" << std::endl;
+    PooledHashTable<int> table(INITIAL_TABLE_SIZE);
+
+    if (table.size() == INITIAL_SIZE && table.is_empty() && table.bucket_count() == INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed " << std::endl;
+    }
+
+    table.insert(5);
+    table.insert(3);
+    table.insert(6);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(3) && table.contains(5) && !table.contains(4)) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed " << std::endl;
+    }
+
+    if (table.bucket(3) == 3 && table.bucket_size(3) == 1 && table.bucket_size(4) == 0) {
+        std::cout << "[PASSED] bucket test " << std::endl;
+    } else {
+        std::cout << "bucket test failed " << std::endl;
+    }
+
+    try {
+        table.bucket_size(INITIAL_TABLE_SIZE);
+        std::cout << "bucket size range test failed " << std::endl;
+    } catch (const std::out_of_range &) {
+        std::cout << "[PASSED] bucket size range test " << std::endl;
+    }
+
+    if (table.remove(3) == 1 && table.remove(3) == 0 && table.size() == NUMBER_OF_INPUTS_AFTER_REMOVE) {
+        std::cout << "[PASSED] remove test " << std::endl;
+    } else {
+        std::cout << "remove test failed " << std::endl;
+    }
+
+    std::stringstream output;
+    table.print_table(output);
+    if (output.str() == "5: [5]\n6: [6]\n") {
+        std::cout << "[PASSED] print table test " << std::endl;
+    } else {
+        std::cout << "print table test failed " << std::endl;
+    }
+
+    // Too few buckets for the load factor, then the same number again
+    bool refused = !table.rehash(1) && !table.rehash(table.bucket_count());
+    if (refused && table.rehash(VALID_REHASH_VALUE) && table.bucket_count() == VALID_REHASH_VALUE &&
+        table.contains(5) && table.contains(6)) {
+        std::cout << "[PASSED] rehash test " << std::endl;
+    } else {
+        std::cout << "rehash test failed " << std::endl;
+    }
+
+    try {
+        table.max_load_factor(0.0f);
+        std::cout << "max load factor range test failed " << std::endl;
+    } catch (const std::invalid_argument &) {
+        std::cout << "[PASSED] max load factor range test " << std::endl;
+    }
+
+    table.make_empty();
+    output.str("");
+    table.print_table(output);
+    if (table.is_empty() && table.allocated_bytes() == 0 && output.str() == "<empty>\n"
+        && table.bucket_count() == VALID_REHASH_VALUE) {
+        std::cout << "[PASSED] make empty test " << std::endl;
+    } else {
+        std::cout << "make empty test failed " << std::endl;
+    }
+}
+
+void test_strings() {
+    const int NUMBER_OF_INPUTS = 1000;
+
+    std::cout << "make a pooled hash table for strings" << std::endl;
+    PooledHashTable<std::string, StringHash> table;
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert("/api/v1/session/" + std::to_string(n));
+    }
+
+    bool all_found = table.size() == NUMBER_OF_INPUTS && table.load_factor() <= table.max_load_factor();
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains("/api/v1/session/" + std::to_string(n));
+    }
+
+    if (all_found && !table.contains("/api/v1/session/") && table.bucket_count() > NUMBER_OF_INPUTS) {
+        std::cout << "[PASSED] grow test " << std::endl;
+    } else {
+        std::cout << "grow test failed " << std::endl;
+    }
+
+    std::string line = "GET /api/v1/session/7 HTTP/1.1";
+    std::string_view view = std::string_view(line).substr(4, 17);
+    if (table.contains(view) && table.remove(view) == 1 && !table.contains("/api/v1/session/7")
+        && table.emplace(3, 'x') && table.contains("xxx") && !table.emplace("xxx")) {
+        std::cout << "[PASSED] transparent and emplace test " << std::endl;
+    } else {
+        std::cout << "transparent and emplace test failed " << std::endl;
+    }
+}
+
+void test_pool_reuse() {
+    const int NUMBER_OF_INPUTS = 500;
+    const int ROUNDS = 10;
+
+    std::cout << "remove and insert values in a pooled hash table" << std::endl;
+    PooledHashTable<int> table(2 * NUMBER_OF_INPUTS);
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n);
+    }
+    size_t bytes = table.allocated_bytes();
+
+    // Removed nodes are reused, so the pool does not grow
+    for (int round = 1; round <= ROUNDS; round++) {
+        for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+            table.remove(n + (round - 1) * NUMBER_OF_INPUTS);
+            table.insert(n + round * NUMBER_OF_INPUTS);
+        }
+    }
+
+    bool all_found = table.size() == NUMBER_OF_INPUTS;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n + ROUNDS * NUMBER_OF_INPUTS) && !table.contains(n);
+    }
+
+    if (all_found && table.allocated_bytes() == bytes) {
+        std::cout << "[PASSED] pool reuse test " << std::endl;
+    } else {
+        std::cout << "pool reuse test failed " << std::endl;
+    }
+}
+
+void test_copy_and_move() {
+    const int NUMBER_OF_INPUTS = 100;
+
+    std::cout << "copy and move pooled hash tables" << std::endl;
+    PooledHashTable<std::string> table;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(std::to_string(n));
+    }
+
+    PooledHashTable<std::string> copy(table);
+    copy.remove("0");
+    bool all_found = copy.size() == NUMBER_OF_INPUTS - 1 && table.contains("0");
+    for (int n = 1; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && copy.contains(std::to_string(n));
+    }
+
+    if (all_found) {
+        std::cout << "[PASSED] copy test " << std::endl;
+    } else {
+        std::cout << "copy test failed " << std::endl;
+    }
+
+    PooledHashTable<std::string> moved(std::move(table));
+    table = copy;
+    copy = std::move(moved);
+    if (copy.size() == NUMBER_OF_INPUTS && copy.contains("0") && table.size() == NUMBER_OF_INPUTS - 1
+        && !table.contains("0") && table.insert("0")) {
+        std::cout << "[PASSED] move test " << std::endl;
+    } else {
+        std::cout << "move test failed " << std::endl;
+    }
+}
@@ -0,0 +1,206 @@
+#ifndef HASHTABLE_PROBE_H
+#define HASHTABLE_PROBE_H
+
+#include <cstddef>
+#include <type_traits>
+#include "hashtable_capacity.h"
+
+// Probe policies decide the order in which the open addressing table visits
+// the cells of a hash value. A policy is a class with a member template
+// Sequence<Capacity>, constructed from the hash value and the number of
+// cells, with two constexpr members:
+//
+//   index()           the cell to visit now, starting at the home cell
+//   next()            moves to the following cell of the sequence
+//
+// and two static constexpr member templates over the Capacity policy:
+//
+//   round_up<C>(n)         number of cells to use when n is requested,
+//                          a size the sequence needs
+//   max_load_factor<C>()   highest load factor at which every sequence
+//                          still reaches a free cell, 0 if the policy
+//                          cannot be used with C at all
+//
+// The table visits at most as many cells as it has. LinearProbe reaches
+// every cell of any table. DoubleHashProbe reaches every cell of a prime
+// or power of two table, so it rounds PrimeCapacity sizes up to a prime.
+// TriangularProbe reaches every cell of a power of two table but only
+// (p + 1) / 2 cells of a prime table of p cells, and QuadraticProbe the
+// same (p + 1) / 2 cells of a prime table. On a power of two table the
+// squares reach only a few of the cells, so QuadraticProbe does not
+// compile with PowerOfTwoCapacity.
+
+//-------------------------------------------------------
+// Adds step to index in a table of cells cells, where step is less than
+// twice the number of cells.
+//---------------------------------------------------------
+constexpr std::size_t probe_advance(std::size_t index, std::size_t step, std::size_t cells) {
+    index += step;
+    while (index >= cells) {
+        index -= cells;
+    }
+    return index;
+}
+
+//-------------------------------------------------------
+// The cell after the last one: values that collide share one run of cells,
+// which is read in as few cache lines as possible. Reaches every cell.
+//---------------------------------------------------------
+struct LinearProbe {
+    template<class Capacity>
+    static constexpr std::size_t round_up(std::size_t cells) {
+        return Capacity::round_up(cells);
+    }
+
+    template<class Capacity>
+    static constexpr float max_load_factor() {
+        return 1.0f;
+    }
+
+    template<class Capacity>
+    class Sequence {
+    public:
+        constexpr Sequence(std::size_t hash_value, std::size_t cells)
+                : current(Capacity::index(hash_value, cells)), cells(cells) {}
+
+        constexpr std::size_t index() const {
+            return current;
+        }
+
+        constexpr void next() {
+            current = Capacity::next(current, cells);
+        }
+
+    private:
+        std::size_t current;
+        std::size_t cells;
+    };
+};
+
+//-------------------------------------------------------
+// The home cell plus 1, 4, 9, ... cells, which breaks up the runs linear
+// probing builds around popular home cells. Reaches (p + 1) / 2 cells of a
+// prime table of p cells, so the load factor stays at or below 0.5.
+//---------------------------------------------------------
+struct QuadraticProbe {
+    template<class Capacity>
+    static constexpr std::size_t round_up(std::size_t cells) {
+        return Capacity::next_size(Capacity::round_up(cells));
+    }
+
+    template<class Capacity>
+    static constexpr float max_load_factor() {
+        return std::is_same<Capacity, PowerOfTwoCapacity>::value ? 0.0f : 0.5f;
+    }
+
+    template<class Capacity>
+    class Sequence {
+        static_assert(max_load_factor<Capacity>() > 0.0f,
+                      "QuadraticProbe reaches too few cells of a power of two table");
+
+    public:
+        constexpr Sequence(std::size_t hash_value, std::size_t cells)
+                : current(Capacity::index(hash_value, cells)), step(1), cells(cells) {}
+
+        constexpr std::size_t index() const {
+            return current;
+        }
+
+        // Consecutive squares differ by consecutive odd numbers
+        constexpr void next() {
+            current = probe_advance(current, step, cells);
+            step = step + 2 < cells ? step + 2 : step + 2 - cells;
+        }
+
+    private:
+        std::size_t current;
+        std::size_t step;
+        std::size_t cells;
+    };
+};
+
+//-------------------------------------------------------
+// The home cell plus 1, 3, 6, 10, ... cells, the triangular numbers.
+// Visits every cell of a power of two table exactly once, and (p + 1) / 2
+// cells of a prime table of p cells.
+//---------------------------------------------------------
+struct TriangularProbe {
+    template<class Capacity>
+    static constexpr std::size_t round_up(std::size_t cells) {
+        return Capacity::next_size(Capacity::round_up(cells));
+    }
+
+    template<class Capacity>
+    static constexpr float max_load_factor() {
+        return std::is_same<Capacity, PowerOfTwoCapacity>::value ? 1.0f : 0.5f;
+    }
+
+    template<class Capacity>
+    class Sequence {
+    public:
+        constexpr Sequence(std::size_t hash_value, std::size_t cells)
+                : current(Capacity::index(hash_value, cells)), step(1), cells(cells) {}
+
+        constexpr std::size_t index() const {
+            return current;
+        }
+
+        constexpr void next() {
+            current = probe_advance(current, step, cells);
+            step = step + 1 < cells ? step + 1 : 0;
+        }
+
+    private:
+        std::size_t current;
+        std::size_t step;
+        std::size_t cells;
+    };
+};
+
+//-------------------------------------------------------
+// A fixed step taken from the high half of the hash value, so values with
+// the same home cell usually follow different sequences. The step is odd
+// and less than the number of cells, so every cell of a prime or power of
+// two table is reached.
+//---------------------------------------------------------
+struct DoubleHashProbe {
+    template<class Capacity>
+    static constexpr std::size_t round_up(std::size_t cells) {
+        return Capacity::next_size(Capacity::round_up(cells));
+    }
+
+    template<class Capacity>
+    static constexpr float max_load_factor() {
+        return 1.0f;
+    }
+
+    template<class Capacity>
+    class Sequence {
+    public:
+        constexpr Sequence(std::size_t hash_value, std::size_t cells)
+                : current(Capacity::index(hash_value, cells)), step(step_of(hash_value, cells)), cells(cells) {}
+
+        constexpr std::size_t index() const {
+            return current;
+        }
+
+        constexpr void next() {
+            current = probe_advance(current, step, cells);
+        }
+
+    private:
+        std::size_t current;
+        std::size_t step;
+        std::size_t cells;
+
+        static constexpr std::size_t step_of(std::size_t hash_value, std::size_t cells) {
+            if (cells <= 3) {
+                return 1;
+            }
+            std::size_t high = hash_value >> (sizeof(std::size_t) * 4);
+            return 1 + high % ((cells - 1) / 2) * 2;
+        }
+    };
+};
+
+#endif  // HASHTABLE_PROBE_H
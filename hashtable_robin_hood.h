@@ -0,0 +1,411 @@
+#ifndef HASHTABLE_ROBIN_HOOD_H
+#define HASHTABLE_ROBIN_HOOD_H
+
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Open addressing with linear probing where every cell also stores how far
+// its value is from its home cell. A value being inserted takes the cell of
+// any value that is closer to home ("richer") than itself, which keeps the
+// probe lengths short and even, so the table can run at a high load factor.
+template<class Key, class Hash=std::hash<Key>>
+class RobinHoodHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+private:
+    size_type number_of_cells;
+    float maximum_load_factor;
+    size_type count;
+
+    // Probe distance of the value in each cell, EMPTY if the cell is unused
+    std::vector<std::pair<int, Key>> table;
+
+    // Constants
+    static constexpr int EMPTY = -1;
+    static constexpr size_type DEFAULT_CELL_SIZE = 11;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.9f;
+
+    size_type next_index(size_type index) const;
+
+    bool is_prime(size_type num) const;
+
+public:
+    RobinHoodHashTable();
+
+    RobinHoodHashTable(size_type cells);
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    size_t table_size() const;
+
+    void make_empty();
+
+    bool insert(const value_type &value);
+
+    size_t remove(const key_type &key);
+
+    bool contains(const key_type &key) const;
+
+    size_t position(const key_type &key) const;
+
+    bool rehash(size_type count);
+
+    float load_factor() const;
+
+    float max_load_factor() const;
+
+    void max_load_factor(float mlf);
+
+    size_t max_probe_length() const;
+
+    void print_table(std::ostream &os = std::cout) const;
+};
+
+//-------------------------------------------------------
+// Name: RobinHoodHashTable
+// PreCondition:
+// PostCondition: makes an empty table with 11 cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+RobinHoodHashTable<Key, Hash>::RobinHoodHashTable() : RobinHoodHashTable(DEFAULT_CELL_SIZE) {
+}
+
+//-------------------------------------------------------
+// Name: RobinHoodHashTable
+// PreCondition:  cells is greater than zero
+// PostCondition: makes an empty table with the specified number of
+// cells
+//---------------------------------------------------------
+template<class Key, class Hash>
+RobinHoodHashTable<Key, Hash>::RobinHoodHashTable(size_type cells) {
+    number_of_cells = cells;
+    maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    count = 0;
+    table.resize(number_of_cells);
+    for (auto &slot : table) {
+        slot.first = EMPTY;
+    }
+}
+
+//-------------------------------------------------------
+// Name: is_empty
+// PreCondition:
+// PostCondition: returns true if the table is empty.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool RobinHoodHashTable<Key, Hash>::is_empty() const {
+    return count == 0;
+}
+
+//-------------------------------------------------------
+// Name: size
+// PreCondition:
+// PostCondition: returns the number of active values in the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t RobinHoodHashTable<Key, Hash>::size() const {
+    return count;
+}
+
+//-------------------------------------------------------
+// Name: table_size
+// PreCondition:
+// PostCondition: return the number of cells in the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t RobinHoodHashTable<Key, Hash>::table_size() const {
+    return number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: make_empty
+// PreCondition:
+// PostCondition: remove all values from the table. Do not change the
+// number of cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void RobinHoodHashTable<Key, Hash>::make_empty() {
+    for (auto &slot : table) {
+        slot.first = EMPTY;
+    }
+    count = 0;
+}
+
+//-------------------------------------------------------
+// Name: next_index
+// PreCondition:  index is a valid cell
+// PostCondition: returns the cell after index, wrapping around to the
+// first cell.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename RobinHoodHashTable<Key, Hash>::size_type RobinHoodHashTable<Key, Hash>::next_index(size_type index) const {
+    index++;
+    return index == number_of_cells ? 0 : index;
+}
+
+//-------------------------------------------------------
+// Name: insert
+// PreCondition:
+// PostCondition: insert the given value reference into the table,
+// displacing values that are closer to their home cell,
+// rehashing if the maximum load factor is exceeded,
+// return true if insert was successful (false if item
+// already exists).
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool RobinHoodHashTable<Key, Hash>::insert(const value_type &value) {
+    size_type index = Hash{}(value) % number_of_cells;
+    int distance = 0;
+
+    // Until the first swap the value can still be found further along
+    for (; table[index].first >= distance; distance++) {
+        auto &slot = table[index];
+        if (slot.first == distance && slot.second == value) {
+            return false;
+        }
+        index = next_index(index);
+    }
+
+    // The value is missing, so carry it along swapping out richer values
+    Key carried = value;
+    while (table[index].first != EMPTY) {
+        auto &slot = table[index];
+        if (slot.first < distance) {
+            std::swap(slot.first, distance);
+            std::swap(slot.second, carried);
+        }
+        distance++;
+        index = next_index(index);
+    }
+    table[index].first = distance;
+    table[index].second = std::move(carried);
+    count++;
+
+    if (load_factor() > maximum_load_factor) {
+        size_type cell_number = number_of_cells * 2;
+        while (!is_prime(cell_number)) {
+            cell_number++;
+        }
+        rehash(cell_number);
+    }
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: is_prime()
+// PreCondition: num should be positive
+// PostCondition: returns the number is prime or not.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool RobinHoodHashTable<Key, Hash>::is_prime(size_type num) const {
+    for (size_type i = 2; i * i <= num; i++)
+        if (num % i == 0) // Factor found
+            return false;
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: load_factor()
+// PreCondition:
+// PostCondition: return the current load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float RobinHoodHashTable<Key, Hash>::load_factor() const {
+    return (float) size() / (float) table_size();
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:
+// PostCondition: return the current maximum load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float RobinHoodHashTable<Key, Hash>::max_load_factor() const {
+    return maximum_load_factor;
+}
+
+//-------------------------------------------------------
+// Name: max_load_factor()
+// PreCondition:
+// PostCondition: set the maximum load factor of the table, forces a
+// rehash if the new maximum is less than the current
+// load factor, throws std::invalid_argument if the
+// input is not between zero and one.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void RobinHoodHashTable<Key, Hash>::max_load_factor(float mlf) {
+    if (!(mlf > 0.0f && mlf < 1.0f)) throw std::invalid_argument("Maximum load factor must be between 0 and 1");
+    maximum_load_factor = mlf;
+
+    if (load_factor() > maximum_load_factor) {
+        size_type cell_number = (size_type) ((float) size() / maximum_load_factor) + 1;
+        while (!is_prime(cell_number)) {
+            cell_number++;
+        }
+        rehash(cell_number);
+    }
+}
+
+//-------------------------------------------------------
+// Name: remove
+// PreCondition:
+// PostCondition: remove the specified value from the table, return
+// number of elements removed (0 or 1). The values after
+// it are shifted back one cell so no deleted markers
+// are needed.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t RobinHoodHashTable<Key, Hash>::remove(const key_type &key) {
+    size_type index = position(key);
+    if (index >= number_of_cells) {
+        return 0;
+    }
+
+    size_type next = next_index(index);
+    while (table[next].first > 0) {
+        table[index].first = table[next].first - 1;
+        table[index].second = std::move(table[next].second);
+        index = next;
+        next = next_index(next);
+    }
+    table[index].first = EMPTY;
+    count--;
+    return 1;
+}
+
+//-------------------------------------------------------
+// Name: contains
+// PreCondition:
+// PostCondition: returns Boolean true if the specified value is in the
+// table
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool RobinHoodHashTable<Key, Hash>::contains(const key_type &key) const {
+    return position(key) < number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: rehash()
+// PreCondition:
+// PostCondition: set the number of cells to the specified value and
+// rehash the table if the total number of cells has
+// changed. Returns false without rehashing if the new
+// number of cells would exceed the maximum load factor.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool RobinHoodHashTable<Key, Hash>::rehash(size_type table_size) {
+    //If the count is same, no need to rehash
+    if (table_size == number_of_cells) {
+        return false;
+    }
+
+    // Check for the load factor
+    if (((float) size() / (float) table_size) > maximum_load_factor) {
+        return false;
+    }
+
+    std::vector<std::pair<int, Key>> old_table(table_size);
+    for (auto &slot : old_table) {
+        slot.first = EMPTY;
+    }
+    old_table.swap(table);
+    number_of_cells = table_size;
+
+    // Every value is known to be unique, so only the displacement is needed
+    for (auto &old_slot : old_table) {
+        if (old_slot.first == EMPTY) {
+            continue;
+        }
+
+        size_type index = Hash{}(old_slot.second) % number_of_cells;
+        int distance = 0;
+        Key carried = std::move(old_slot.second);
+        while (table[index].first != EMPTY) {
+            auto &slot = table[index];
+            if (slot.first < distance) {
+                std::swap(slot.first, distance);
+                std::swap(slot.second, carried);
+            }
+            distance++;
+            index = next_index(index);
+        }
+        table[index].first = distance;
+        table[index].second = std::move(carried);
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: position
+// PreCondition:
+// PostCondition: return the index of the cell that contains the
+// specified value, or an invalid index if it is not in
+// the table. The search stops as soon as it reaches a
+// value closer to its home cell than the key would be.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t RobinHoodHashTable<Key, Hash>::position(const key_type &key) const {
+    size_type index = Hash{}(key) % number_of_cells;
+
+    for (int distance = 0; table[index].first >= distance; distance++) {
+        auto &slot = table[index];
+        if (slot.first == distance && slot.second == key) {
+            return index;
+        }
+        index = next_index(index);
+    }
+
+    // returning an invalid position
+    return number_of_cells + 1;
+}
+
+//-------------------------------------------------------
+// Name: max_probe_length
+// PreCondition:
+// PostCondition: return the largest number of cells any value is away
+// from its home cell.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t RobinHoodHashTable<Key, Hash>::max_probe_length() const {
+    int longest = 0;
+    for (auto &slot : table) {
+        if (slot.first > longest) {
+            longest = slot.first;
+        }
+    }
+    return longest;
+}
+
+//-------------------------------------------------------
+// Name: print_table
+// PreCondition:
+// PostCondition: pretty print the table, the empty table should
+// print “<empty>\n”.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void RobinHoodHashTable<Key, Hash>::print_table(std::ostream &os) const {
+    if (is_empty()) {
+        os << "<empty>\n";
+        return;
+    }
+    for (size_type i = 0; i < number_of_cells; i++) {
+        auto &slot = table[i];
+        if (slot.first != EMPTY) {
+            os << i << ": ";
+            os << slot.second;
+            os << std::endl;
+        }
+    }
+}
+
+#endif  // HASHTABLE_ROBIN_HOOD_H
@@ -0,0 +1,165 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "hashtable_robin_hood.h"
+
+void test_integer_1();
+
+void test_high_load();
+
+void test_strings();
+
+int main() {
+    test_integer_1();
+    test_high_load();
+    test_strings();
+    return 0;
+}
+
+void test_integer_1() {
+    const int INITIAL_SIZE = 0;
+    const int INITIAL_TABLE_SIZE = 11;
+    const int NUMBER_OF_INPUTS = 4;
+    const int NUMBER_OF_INPUTS_AFTER_REMOVE = 3;
+    const int INVALID_REHASH_VALUE = 1;
+    const int VALID_REHASH_VALUE = 53;
+
+    std::cout << "make an empty robin hood table with 11 cells for ints" << std::endl;
+    RobinHoodHashTable<int> table(INITIAL_TABLE_SIZE);
+
+    if (table.size() == INITIAL_SIZE && table.table_size() == INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed" << std::endl;
+    }
+
+    // 0, 11 and 22 share home cell 0, 1 is displaced by them
+    table.insert(1);
+    table.insert(0);
+    table.insert(11);
+    table.insert(22);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(11)) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed" << std::endl;
+    }
+
+    if (table.position(0) == 0 && table.position(11) == 1 && table.position(22) == 2 &&
+        table.position(1) == 3) {
+        std::cout << "[PASSED] displacement test " << std::endl;
+    } else {
+        std::cout << "displacement test failed" << std::endl;
+    }
+
+    if (!table.contains(33) && table.position(33) > INITIAL_TABLE_SIZE) {
+        std::cout << "[PASSED] contains non exist test " << std::endl;
+    } else {
+        std::cout << "contains non exist test failed" << std::endl;
+    }
+
+    table.remove(11);
+    if (table.size() == NUMBER_OF_INPUTS_AFTER_REMOVE && table.position(22) == 1 &&
+        table.position(1) == 2) {
+        std::cout << "[PASSED] remove shifts back test " << std::endl;
+    } else {
+        std::cout << "remove shifts back test failed" << std::endl;
+    }
+
+    if (!table.rehash(INITIAL_TABLE_SIZE) && !table.rehash(INVALID_REHASH_VALUE) &&
+        table.rehash(VALID_REHASH_VALUE) && table.contains(0) && table.contains(22) && table.contains(1)) {
+        std::cout << "[PASSED] rehash test " << std::endl;
+    } else {
+        std::cout << "rehash test failed" << std::endl;
+    }
+
+    table.make_empty();
+    if (table.is_empty() && !table.contains(0)) {
+        std::cout << "[PASSED] make empty test " << std::endl;
+    } else {
+        std::cout << "make empty test failed" << std::endl;
+    }
+}
+
+void test_high_load() {
+    const int NUMBER_OF_INPUTS = 100000;
+    const size_t MAX_PROBE_LENGTH = 64;
+
+    std::cout << "fill a robin hood table up to a load factor of 0.9" << std::endl;
+    RobinHoodHashTable<int> table;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n * 7919);
+    }
+
+    bool all_found = true;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * 7919) && !table.contains(n * 7919 + 1);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS && table.load_factor() <= table.max_load_factor() &&
+        table.load_factor() > 0.4f) {
+        std::cout << "[PASSED] high load insert test " << std::endl;
+    } else {
+        std::cout << "high load insert test failed" << std::endl;
+    }
+
+    if (table.max_probe_length() < MAX_PROBE_LENGTH) {
+        std::cout << "[PASSED] max probe length test " << std::endl;
+    } else {
+        std::cout << "max probe length test failed " << table.max_probe_length() << std::endl;
+    }
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        table.remove(n * 7919);
+    }
+
+    all_found = true;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * 7919) == (n % 2 == 1);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS / 2) {
+        std::cout << "[PASSED] high load remove test " << std::endl;
+    } else {
+        std::cout << "high load remove test failed" << std::endl;
+    }
+
+    try {
+        table.max_load_factor(1.5f);
+        std::cout << "invalid max load factor test failed" << std::endl;
+    } catch (std::invalid_argument &) {
+        std::cout << "[PASSED] invalid max load factor test " << std::endl;
+    }
+
+    table.max_load_factor(0.2f);
+    if (table.load_factor() <= 0.2f && table.contains(7919)) {
+        std::cout << "[PASSED] lower max load factor test " << std::endl;
+    } else {
+        std::cout << "lower max load factor test failed" << std::endl;
+    }
+}
+
+void test_strings() {
+    std::cout << "make an empty robin hood table for strings" << std::endl;
+    RobinHoodHashTable<std::string> table;
+    table.insert("Closer to the Heart");
+    table.insert("The Blacksmith and the Artist");
+    table.insert("Closer to the Heart");
+
+    std::stringstream ss;
+    table.print_table(ss);
+    if (table.size() == 2 && ss.str().find("The Blacksmith and the Artist") != std::string::npos) {
+        std::cout << "[PASSED] print table test " << std::endl;
+    } else {
+        std::cout << "print table test failed" << std::endl;
+    }
+
+    table.make_empty();
+    std::stringstream empty;
+    table.print_table(empty);
+    if (empty.str() == "<empty>\n") {
+        std::cout << "[PASSED] print empty table test " << std::endl;
+    } else {
+        std::cout << "print empty table test failed" << std::endl;
+    }
+}
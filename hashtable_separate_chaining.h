@@ -1,11 +1,23 @@
 #ifndef HASHTABLE_SEPARATE_CHAINING_H
 #define HASHTABLE_SEPARATE_CHAINING_H
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <list>
 #include <stdexcept>
 #include <functional>
 #include <iostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "hashtable_capacity.h"
+#include "hashtable_hash.h"
+#include "hashtable_parallel.h"
+
+// In a namespace of its own so that a program can use this table and the
+// open addressing one side by side
+namespace separate_chaining {
 
 template<typename Key>
 struct S {
@@ -18,14 +30,29 @@ bool operator==(const S<Key> &lhs, const S<Key> &rhs) {
 }
 
 template<typename Key>
-struct std::hash<S<Key>> {
-    std::size_t operator()(S<Key> const &s) const noexcept {
-        std::size_t h = std::hash<std::string>{}(s.key);
-        return h;
+bool operator==(const S<Key> &lhs, std::string_view rhs) {
+    return lhs.key == rhs;
+}
+
+}  // namespace separate_chaining
+
+// Transparent, so a table of S<Key> can be searched by the key alone
+template<typename Key>
+struct std::hash<separate_chaining::S<Key>> {
+    using is_transparent = void;
+
+    std::size_t operator()(separate_chaining::S<Key> const &s) const noexcept {
+        return std::hash<Key>{}(s.key);
+    }
+
+    std::size_t operator()(std::string_view key) const noexcept {
+        return std::hash<std::string_view>{}(key);
     }
 };
 
-template<class Key, class Hash=std::hash<Key>>
+namespace separate_chaining {
+
+template<class Key, class Hash=std::hash<Key>, class Capacity=PrimeCapacity, bool StoreHash=false>
 class HashTable {
 public:
     // Member Types - do not modify
@@ -35,28 +62,90 @@ public:
     using size_type = size_t;
     // you can write your code below this
 
+    // What a node holds, the value alone or, with StoreHash, the value
+    // together with its hash code
+    using stored_type = typename std::conditional<StoreHash, HashedValue<Key>, Key>::type;
+    using bucket_type = std::list<stored_type>;
+
 private:
     size_type number_of_buckets;
     float maximum_load_factor;
 
+    // Number of values in table and old_table, kept up to date by every
+    // change so that size() and the load check on insert are O(1)
+    size_type count;
+
     // The pointer to the hash table
-    std::list<Key> *table;
+    bucket_type *table;
+
+    // Buckets being emptied by an incremental rehash, the buckets before
+    // migrated_buckets have already been moved into table
+    bucket_type *old_table;
+    size_type old_number_of_buckets;
+    size_type migrated_buckets;
+    bool incremental;
 
     // Constants
     const size_type DEFAULT_BUCKET_SIZE = 11;
     const float DEFAULT_MAX_LOAD_FACTOR = 1.0f;
+    const size_type MIGRATION_STEP = 4;
+
+    // Keys hashed and prefetched together by the batch operations
+    static constexpr size_type BATCH_SIZE = 16;
+
+    bucket_type &bucket_of(size_type hash_value);
+
+    static const Key &value_of(const stored_type &stored);
+
+    static size_type hash_of(const stored_type &stored);
+
+    template<class K>
+    static bool matches(const stored_type &stored, size_type hash_value, const K &key);
 
-    bool is_prime(size_type num);
+    template<class K>
+    size_t remove_key(const K &key);
+
+    template<class K>
+    size_t remove_hashed(size_type hash_value, const K &key);
+
+    template<class K>
+    bool contains_key(const K &key);
+
+    template<class K>
+    bool contains_hashed(size_type hash_value, const K &key);
+
+    template<class Operation>
+    size_t for_each_prefetched(const key_type *keys, size_type n, Operation operation);
+
+    void start_migration(size_type buckets);
+
+    void migrate(size_type buckets);
+
+    void relink(size_type threads);
+
+    template<class Value>
+    bool place(Value &&value);
+
+    template<class Value>
+    bool place_hashed(size_type hash_value, Value &&value);
+
+    void grow();
 
 public:
     HashTable();
 
     HashTable(const HashTable &other);
 
+    HashTable(HashTable &&other);
+
     ~HashTable();
 
     HashTable &operator=(const HashTable &other);
 
+    HashTable &operator=(HashTable &&other);
+
+    void swap(HashTable &other);
+
     HashTable(size_type buckets);
 
     bool is_empty() const;
@@ -67,6 +156,11 @@ public:
 
     bool insert(const value_type &value);
 
+    bool insert(value_type &&value);
+
+    template<class... Args>
+    bool emplace(Args &&... args);
+
     size_t remove(const key_type &key);
 
     bool contains(const key_type &key);
@@ -77,6 +171,17 @@ public:
 
     size_t bucket(const key_type &key) const;
 
+    // Lookups by any type a transparent Hash accepts, such as a
+    // std::string_view into a table of std::string with StringHash
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    size_t remove(const K &key);
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    bool contains(const K &key);
+
+    template<class K, class H = Hash, class = typename H::is_transparent>
+    size_t bucket(const K &key) const;
+
     float load_factor() const;
 
     float max_load_factor() const;
@@ -85,14 +190,44 @@ public:
 
     void rehash(size_type count);
 
-    std::list<Key> *get_table();
+    // Rehash with the nodes relinked by num_threads threads, or one per
+    // hardware thread when it is zero
+    void rehash(size_type count, size_type num_threads);
+
+    // Make room for the given number of values, so that inserting them
+    // into an empty table never rehashes
+    void reserve(size_type values);
+
+    bucket_type *get_table();
 
     void print_table(std::ostream &os = std::cout) const;
 
-    // Optional
-//     HashTable(HashTable&& other);
-//     HashTable& operator=(HashTable&& other);
-//     bool insert(value_type&& value);
+    bool incremental_rehash() const;
+
+    void incremental_rehash(bool enabled);
+
+    size_t migration_debt() const;
+
+    // Operations on many independent keys. Each group of keys is hashed
+    // and has its buckets and first nodes prefetched before the first one
+    // is searched, so the cache misses of the group overlap
+    size_t insert_batch(const value_type *values, size_type n);
+
+    // The same with hashes[i] the hash of values[i], computed ahead by the
+    // caller, for example on another thread
+    size_t insert_batch(const value_type *values, const size_type *hashes, size_type n);
+
+    size_t contains_batch(const key_type *keys, size_type n);
+
+    size_t contains_batch(const key_type *keys, size_type n, std::vector<bool> &found);
+
+    size_t remove_batch(const key_type *keys, size_type n);
+
+    // Replace the values with the keys of a random access range. The
+    // table is sized once for all of them and filled by num_threads
+    // threads, or one per hardware thread when it is zero
+    template<class Iterator>
+    void build(Iterator first, Iterator last, size_type num_threads = 0);
 };
 
 //-------------------------------------------------------
@@ -101,11 +236,16 @@ public:
 // PreCondition:
 // PostCondition:
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash>::HashTable() {
-    number_of_buckets = DEFAULT_BUCKET_SIZE;
+template<class Key, class Hash, class Capacity, bool StoreHash>
+HashTable<Key, Hash, Capacity, StoreHash>::HashTable() {
+    number_of_buckets = Capacity::round_up(DEFAULT_BUCKET_SIZE);
     maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
-    table = new std::list<Key>[DEFAULT_BUCKET_SIZE];
+    count = 0;
+    table = new bucket_type[number_of_buckets];
+    old_table = nullptr;
+    old_number_of_buckets = 0;
+    migrated_buckets = 0;
+    incremental = false;
 }
 
 //-------------------------------------------------------
@@ -113,21 +253,13 @@ HashTable<Key, Hash>::HashTable() {
 // PreCondition:
 // PostCondition:
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash>::HashTable(const HashTable &other) {
-    // Clear the content
-    delete[] table;
-
-    number_of_buckets = other.number_of_buckets;
-    maximum_load_factor = other.maximum_load_factor;
-
-    // Create a new table
-    table = new std::list<Key>[number_of_buckets];
+template<class Key, class Hash, class Capacity, bool StoreHash>
+HashTable<Key, Hash, Capacity, StoreHash>::HashTable(const HashTable &other) {
+    // Nothing to clear yet
+    table = nullptr;
+    old_table = nullptr;
 
-    // copy values
-    for (size_type i = 0; i < number_of_buckets; i++) {
-        table[i] = other.table[i];
-    }
+    *this = other;
 }
 
 //-------------------------------------------------------
@@ -135,21 +267,39 @@ HashTable<Key, Hash>::HashTable(const HashTable &other) {
 // PreCondition:
 // PostCondition:
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash> &HashTable<Key, Hash>::operator=(const HashTable &other) { // clear , new, copy
+template<class Key, class Hash, class Capacity, bool StoreHash>
+HashTable<Key, Hash, Capacity, StoreHash> &HashTable<Key, Hash, Capacity, StoreHash>::operator=(const HashTable &other) { // clear , new, copy
+    if (this == &other) {
+        return *this;
+    }
+
     // Clear the content
     delete[] table;
+    delete[] old_table;
 
     number_of_buckets = other.number_of_buckets;
     maximum_load_factor = other.maximum_load_factor;
+    count = other.count;
+    old_number_of_buckets = other.old_number_of_buckets;
+    migrated_buckets = other.migrated_buckets;
+    incremental = other.incremental;
 
     // Create a new table
-    table = new std::list<Key>[number_of_buckets];
+    table = new bucket_type[number_of_buckets];
 
     // copy values
     for (size_type i = 0; i < number_of_buckets; i++) {
         table[i] = other.table[i];
     }
+
+    // copy the buckets of a rehash in progress
+    old_table = nullptr;
+    if (other.old_table != nullptr) {
+        old_table = new bucket_type[old_number_of_buckets];
+        for (size_type i = 0; i < old_number_of_buckets; i++) {
+            old_table[i] = other.old_table[i];
+        }
+    }
     return *this;
 }
 
@@ -159,11 +309,59 @@ HashTable<Key, Hash> &HashTable<Key, Hash>::operator=(const HashTable &other) {
 // PreCondition:
 // PostCondition:
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash>::HashTable(size_type buckets) {
-    number_of_buckets = buckets;
+template<class Key, class Hash, class Capacity, bool StoreHash>
+HashTable<Key, Hash, Capacity, StoreHash>::HashTable(size_type buckets) {
+    number_of_buckets = Capacity::round_up(buckets);
     maximum_load_factor = DEFAULT_MAX_LOAD_FACTOR;
-    table = new std::list<Key>[number_of_buckets];
+    count = 0;
+    table = new bucket_type[number_of_buckets];
+    old_table = nullptr;
+    old_number_of_buckets = 0;
+    migrated_buckets = 0;
+    incremental = false;
+}
+
+//-------------------------------------------------------
+// Move constructor
+// Name: HashTable(HashTable &&other)
+// PreCondition:
+// PostCondition: take over the buckets of other, which is left empty
+// with the default number of buckets
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+HashTable<Key, Hash, Capacity, StoreHash>::HashTable(HashTable &&other) : HashTable() {
+    swap(other);
+}
+
+//-------------------------------------------------------
+// Move operator
+// Name: operator=(HashTable &&other)
+// PreCondition:
+// PostCondition: take over the buckets of other, which is left with
+// the previous buckets of this table
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+HashTable<Key, Hash, Capacity, StoreHash> &HashTable<Key, Hash, Capacity, StoreHash>::operator=(HashTable &&other) {
+    swap(other);
+    return *this;
+}
+
+//-------------------------------------------------------
+// Name: swap()
+// PreCondition:
+// PostCondition: exchange the contents of the two tables without
+// copying any value
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::swap(HashTable &other) {
+    std::swap(number_of_buckets, other.number_of_buckets);
+    std::swap(maximum_load_factor, other.maximum_load_factor);
+    std::swap(count, other.count);
+    std::swap(table, other.table);
+    std::swap(old_table, other.old_table);
+    std::swap(old_number_of_buckets, other.old_number_of_buckets);
+    std::swap(migrated_buckets, other.migrated_buckets);
+    std::swap(incremental, other.incremental);
 }
 
 //-------------------------------------------------------
@@ -172,9 +370,10 @@ HashTable<Key, Hash>::HashTable(size_type buckets) {
 // PreCondition:
 // PostCondition: clear the hashtable
 //---------------------------------------------------------
-template<class Key, class Hash>
-HashTable<Key, Hash>::~HashTable() {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+HashTable<Key, Hash, Capacity, StoreHash>::~HashTable() {
     delete[] table;
+    delete[] old_table;
 }
 
 //-------------------------------------------------------
@@ -182,14 +381,9 @@ HashTable<Key, Hash>::~HashTable() {
 // PreCondition:
 // PostCondition: Returns true if the table is empty.
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::is_empty() const {
-    for (size_type i = 0; i < number_of_buckets; ++i) {
-        if (table[i].size() != 0) {
-            return false;
-        }
-    }
-    return true;
+template<class Key, class Hash, class Capacity, bool StoreHash>
+bool HashTable<Key, Hash, Capacity, StoreHash>::is_empty() const {
+    return count == 0;
 }
 
 //-------------------------------------------------------
@@ -197,16 +391,9 @@ bool HashTable<Key, Hash>::is_empty() const {
 // PreCondition:
 // PostCondition: returns the number of values in the table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::size() const {
-    size_type sum{};
-    for (size_type i = 0; i < number_of_buckets; ++i) {
-        if (table[i].size() != 0) {
-            sum += table[i].size();
-        }
-    }
-
-    return sum;
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::size() const {
+    return count;
 }
 
 //-------------------------------------------------------
@@ -215,11 +402,16 @@ size_t HashTable<Key, Hash>::size() const {
 // PostCondition: remove all values from the table. Do not change the
 // number of buckets. Do not change the maximum load factor.
 //---------------------------------------------------------
-template<class Key, class Hash>
-void HashTable<Key, Hash>::make_empty() {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::make_empty() {
     for (size_type i = 0; i < number_of_buckets; i++) {
         table[i].clear();
     }
+    count = 0;
+
+    delete[] old_table;
+    old_table = nullptr;
+    migrated_buckets = 0;
 }
 
 //-------------------------------------------------------
@@ -228,68 +420,157 @@ void HashTable<Key, Hash>::make_empty() {
 // PostCondition: insert the given value reference into the table,
 // rehashing only if the maximum load factor is
 // exceeded, return true if insert was successful (false
-// if item already exists).
+// if item already exists). With incremental rehashing
+// the new buckets are only filled a few at a time by
+// the following operations.
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::insert(const value_type &value) {
-    size_type hash_value = Hash{}(value);
-    size_type index = hash_value % number_of_buckets;
+template<class Key, class Hash, class Capacity, bool StoreHash>
+bool HashTable<Key, Hash, Capacity, StoreHash>::insert(const value_type &value) {
+    return place(value);
+}
 
-    if (contains(value)) {
-        return false;
-    }
+//-------------------------------------------------------
+// Name: insert()
+// PreCondition:
+// PostCondition: same as inserting a reference, but the value is moved
+// into its node instead of copied
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+bool HashTable<Key, Hash, Capacity, StoreHash>::insert(value_type &&value) {
+    return place(std::move(value));
+}
 
-    table[index].push_back(value);
+//-------------------------------------------------------
+// Name: emplace()
+// PreCondition:
+// PostCondition: construct the value from the given arguments directly
+// in a new node and link the node into its bucket,
+// return true if insert was successful (false if item
+// already exists, the node is then dropped)
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class... Args>
+bool HashTable<Key, Hash, Capacity, StoreHash>::emplace(Args &&... args) {
+    migrate(MIGRATION_STEP);
+
+    bucket_type node;
+    size_type hash_value;
+    if constexpr (StoreHash) {
+        node.emplace_back(0, std::forward<Args>(args)...);
+        hash_value = node.front().hash = Hash{}(node.front().value);
+    } else {
+        node.emplace_back(std::forward<Args>(args)...);
+        hash_value = Hash{}(node.front());
+    }
 
-    if (load_factor() > maximum_load_factor) {
-        // Find the next prime
-        size_type bucket_number = number_of_buckets * 2;
-        while (!is_prime(bucket_number)) {
-            bucket_number++;
+    bucket_type &list = bucket_of(hash_value);
+    for (auto &x : list) {
+        if (matches(x, hash_value, value_of(node.front()))) {
+            return false;
         }
-
-        rehash(bucket_number);
     }
 
+    list.splice(list.end(), node);
+    count++;
+    grow();
     return true;
-
 }
 
 //-------------------------------------------------------
-// Name: is_prime()
-// PreCondition: num should be positive
-// PostCondition: returns the number is prime or not.
+// Name: place()
+// PreCondition:
+// PostCondition: the insert shared by copies and moves, the node is
+// only created once the value is known to be new
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::is_prime(size_type num) {
-    for (size_type i = 2; i * i <= num; i++)
-        if (num % i == 0) // Factor found
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class Value>
+bool HashTable<Key, Hash, Capacity, StoreHash>::place(Value &&value) {
+    return place_hashed(Hash{}(value), std::forward<Value>(value));
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class Value>
+bool HashTable<Key, Hash, Capacity, StoreHash>::place_hashed(size_type hash_value, Value &&value) {
+    migrate(MIGRATION_STEP);
+
+    bucket_type &list = bucket_of(hash_value);
+    for (auto &x : list) {
+        if (matches(x, hash_value, value)) {
             return false;
+        }
+    }
+
+    if constexpr (StoreHash) {
+        list.emplace_back(hash_value, std::forward<Value>(value));
+    } else {
+        list.push_back(std::forward<Value>(value));
+    }
+    count++;
+    grow();
     return true;
 }
 
+//-------------------------------------------------------
+// Name: grow()
+// PreCondition:
+// PostCondition: rehash to more buckets if the maximum load factor is
+// exceeded
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::grow() {
+    if (load_factor() > maximum_load_factor) {
+        // Find the next size allowed by the capacity policy
+        size_type bucket_number = Capacity::next_size(number_of_buckets * 2);
+
+        if (incremental) {
+            start_migration(bucket_number);
+        } else {
+            rehash(bucket_number);
+        }
+    }
+}
+
 //-------------------------------------------------------
 // Name: remove()
 // PreCondition: the key shouldn't be null
 // PostCondition: remove the specified value from the table, return
 // number of elements removed (0 or 1).
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::remove(const key_type &key) {
-    size_type hash_value = Hash{}(key);
-    size_type index = hash_value % number_of_buckets;
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::remove(const key_type &key) {
+    return remove_key(key);
+}
 
-    // find the key in (index)th list
-    typename std::list<Key>::iterator i;
-    for (i = table[index].begin(); i != table[index].end(); i++) {
-        if (*i == key) {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class K, class H, class>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::remove(const K &key) {
+    return remove_key(key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class K>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::remove_key(const K &key) {
+    return remove_hashed(Hash{}(key), key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class K>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::remove_hashed(size_type hash_value, const K &key) {
+    migrate(MIGRATION_STEP);
+
+    // find the key in its list
+    bucket_type &list = bucket_of(hash_value);
+    typename bucket_type::iterator i;
+    for (i = list.begin(); i != list.end(); i++) {
+        if (matches(*i, hash_value, key)) {
             break;
         }
     }
 
     // if key is found in hash table, remove it
-    if (i != table[index].end()) {
-        table[index].erase(i);
+    if (i != list.end()) {
+        list.erase(i);
+        count--;
         return 1;
     }
     return 0;
@@ -302,15 +583,33 @@ size_t HashTable<Key, Hash>::remove(const key_type &key) {
 // PostCondition: returns Boolean true if the specified value is in the
 // table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-bool HashTable<Key, Hash>::contains(const key_type &key) {
-    size_type hash_value = Hash{}(key);
-    size_type index = hash_value % number_of_buckets;
+template<class Key, class Hash, class Capacity, bool StoreHash>
+bool HashTable<Key, Hash, Capacity, StoreHash>::contains(const key_type &key) {
+    return contains_key(key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class K, class H, class>
+bool HashTable<Key, Hash, Capacity, StoreHash>::contains(const K &key) {
+    return contains_key(key);
+}
 
-    // find the key in (index)th list
-    typename std::list<Key>::iterator i;
-    for (i = table[index].begin(); i != table[index].end(); i++) {
-        if (*i == key) {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class K>
+bool HashTable<Key, Hash, Capacity, StoreHash>::contains_key(const K &key) {
+    return contains_hashed(Hash{}(key), key);
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class K>
+bool HashTable<Key, Hash, Capacity, StoreHash>::contains_hashed(size_type hash_value, const K &key) {
+    migrate(MIGRATION_STEP);
+
+    // find the key in its list
+    bucket_type &list = bucket_of(hash_value);
+    typename bucket_type::iterator i;
+    for (i = list.begin(); i != list.end(); i++) {
+        if (matches(*i, hash_value, key)) {
             return true;
         }
     }
@@ -321,13 +620,195 @@ bool HashTable<Key, Hash>::contains(const key_type &key) {
     return false;
 }
 
+//-------------------------------------------------------
+// Name: insert_batch()
+// PreCondition: values points to n values
+// PostCondition: insert every value as insert() does, return the
+// number of values that were new.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::insert_batch(const value_type *values, size_type n) {
+    return for_each_prefetched(values, n, [&](size_type hash_value, size_type i) {
+        return place_hashed(hash_value, values[i]);
+    });
+}
+
+//-------------------------------------------------------
+// Name: insert_batch()
+// PreCondition: values and hashes point to n values and their hashes
+// PostCondition: insert every value as insert() does without hashing
+// it again, return the number of values that were new.
+// The buckets of each group of BATCH_SIZE values and
+// their first nodes are prefetched before the first
+// one is placed.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::insert_batch(const value_type *values, const size_type *hashes,
+                                                               size_type n) {
+    bucket_type *buckets[BATCH_SIZE];
+    size_t total = 0;
+    for (size_type first = 0; first < n; first += BATCH_SIZE) {
+        size_type group = std::min(BATCH_SIZE, n - first);
+        for (size_type i = 0; i < group; i++) {
+            buckets[i] = &bucket_of(hashes[first + i]);
+            __builtin_prefetch(buckets[i]);
+        }
+        for (size_type i = 0; i < group; i++) {
+            if (!buckets[i]->empty()) {
+                __builtin_prefetch(&buckets[i]->front());
+            }
+        }
+        for (size_type i = 0; i < group; i++) {
+            total += place_hashed(hashes[first + i], values[first + i]);
+        }
+    }
+    return total;
+}
+
+//-------------------------------------------------------
+// Name: contains_batch()
+// PreCondition: keys points to n keys
+// PostCondition: return the number of keys in the table. The second
+// form also sets found[i] to whether keys[i] is in the
+// table.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::contains_batch(const key_type *keys, size_type n) {
+    return for_each_prefetched(keys, n, [&](size_type hash_value, size_type i) {
+        return contains_hashed(hash_value, keys[i]);
+    });
+}
+
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::contains_batch(const key_type *keys, size_type n,
+                                                                 std::vector<bool> &found) {
+    found.assign(n, false);
+    return for_each_prefetched(keys, n, [&](size_type hash_value, size_type i) {
+        return found[i] = contains_hashed(hash_value, keys[i]);
+    });
+}
+
+//-------------------------------------------------------
+// Name: remove_batch()
+// PreCondition: keys points to n keys
+// PostCondition: remove every key as remove() does, return the number
+// of values removed.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::remove_batch(const key_type *keys, size_type n) {
+    return for_each_prefetched(keys, n, [&](size_type hash_value, size_type i) {
+        return remove_hashed(hash_value, keys[i]);
+    });
+}
+
+//-------------------------------------------------------
+// Name: for_each_prefetched()
+// PreCondition: keys points to n keys
+// PostCondition: calls operation(hash, i) for every key in order and
+// returns the sum of the results. Before the first key
+// of each group of BATCH_SIZE is passed on, the whole
+// group is hashed and its buckets prefetched, and then
+// the first node of each bucket is prefetched.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class Operation>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::for_each_prefetched(const key_type *keys, size_type n,
+                                                                      Operation operation) {
+    size_type hashes[BATCH_SIZE];
+    bucket_type *buckets[BATCH_SIZE];
+    size_t total = 0;
+    for (size_type first = 0; first < n; first += BATCH_SIZE) {
+        size_type group = std::min(BATCH_SIZE, n - first);
+        for (size_type i = 0; i < group; i++) {
+            hashes[i] = Hash{}(keys[first + i]);
+            buckets[i] = &bucket_of(hashes[i]);
+            __builtin_prefetch(buckets[i]);
+        }
+        for (size_type i = 0; i < group; i++) {
+            if (!buckets[i]->empty()) {
+                __builtin_prefetch(&buckets[i]->front());
+            }
+        }
+        for (size_type i = 0; i < group; i++) {
+            total += operation(hashes[i], first + i);
+        }
+    }
+    return total;
+}
+
+//-------------------------------------------------------
+// Name: build()
+// PreCondition: [first, last) is a random access range of keys
+// PostCondition: the table holds exactly the distinct keys of the
+// range, in enough buckets for the maximum load factor.
+// The keys are hashed in parallel, then each thread
+// links the keys of its own range of buckets.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class Iterator>
+void HashTable<Key, Hash, Capacity, StoreHash>::build(Iterator first, Iterator last, size_type num_threads) {
+    size_type n = last - first;
+    size_type threads = thread_count(num_threads);
+    size_type buckets = Capacity::next_size((size_type) ((float) n / maximum_load_factor) + 1);
+
+    // Drop the values and any rehash in progress
+    delete[] old_table;
+    old_table = nullptr;
+    old_number_of_buckets = 0;
+    migrated_buckets = 0;
+    delete[] table;
+    table = new bucket_type[buckets];
+    number_of_buckets = buckets;
+    count = 0;
+
+    std::vector<size_type> hashes(n);
+    std::vector<std::uint16_t> regions(n);
+    parallel_for(threads, n, [&](size_type, size_type begin, size_type end) {
+        for (size_type i = begin; i < end; i++) {
+            hashes[i] = Hash{}(first[i]);
+            regions[i] = (std::uint16_t) (Capacity::index(hashes[i], buckets) * threads / buckets);
+        }
+    });
+    std::vector<size_type> order, offsets;
+    partition_by_region(threads, n, threads, regions, order, offsets);
+
+    std::vector<size_type> placed(threads, 0);
+    parallel_for(threads, threads, [&](size_type t, size_type, size_type) {
+        for (size_type k = offsets[t]; k < offsets[t + 1]; k++) {
+            size_type i = order[k];
+            bucket_type &list = table[Capacity::index(hashes[i], buckets)];
+            bool found = false;
+            for (auto &x : list) {
+                if (matches(x, hashes[i], first[i])) {
+                    found = true;
+                    break;
+                }
+            }
+            if (found) {
+                continue;
+            }
+
+            if constexpr (StoreHash) {
+                list.emplace_back(hashes[i], first[i]);
+            } else {
+                list.push_back(first[i]);
+            }
+            placed[t]++;
+        }
+    });
+
+    for (size_type t = 0; t < threads; t++) {
+        count += placed[t];
+    }
+}
+
 //-------------------------------------------------------
 // Name: bucket_count()
 // PreCondition:
 // PostCondition: return the number of buckets in the table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::bucket_count() const {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::bucket_count() const {
     return number_of_buckets;
 }
 
@@ -338,8 +819,8 @@ size_t HashTable<Key, Hash>::bucket_count() const {
 // (by index); throw std::out_of_range if the bucket
 // index is out of bounds of the table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::bucket_size(size_t n) const {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::bucket_size(size_t n) const {
     if (n < 0 || n >= number_of_buckets) throw std::out_of_range("Value is out of range");
     return table[n].size();
 
@@ -350,21 +831,28 @@ size_t HashTable<Key, Hash>::bucket_size(size_t n) const {
 // PreCondition:  Key should be not null value
 // PostCondition: return the index of the bucket that contains the
 // specified value (or would contain it, if it existed).
+// While an incremental rehash is in progress this is the
+// bucket the value ends up in once it has been moved.
 //---------------------------------------------------------
-template<class Key, class Hash>
-size_t HashTable<Key, Hash>::bucket(const key_type &key) const {
-    size_type hash_value = Hash{}(key);
-    size_type index = hash_value % number_of_buckets;
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::bucket(const key_type &key) const {
+    size_type index = Capacity::index(Hash{}(key), number_of_buckets);
     return index;
 }
 
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class K, class H, class>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::bucket(const K &key) const {
+    return Capacity::index(Hash{}(key), number_of_buckets);
+}
+
 //-------------------------------------------------------
 // Name: load_factor()
 // PreCondition:
 // PostCondition: return the current load factor of the table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-float HashTable<Key, Hash>::load_factor() const {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+float HashTable<Key, Hash, Capacity, StoreHash>::load_factor() const {
     return (float) size() / (float) bucket_count();
 }
 
@@ -373,8 +861,8 @@ float HashTable<Key, Hash>::load_factor() const {
 // PreCondition:
 // PostCondition: return the current maximum load factor of the table.
 //---------------------------------------------------------
-template<class Key, class Hash>
-float HashTable<Key, Hash>::max_load_factor() const {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+float HashTable<Key, Hash, Capacity, StoreHash>::max_load_factor() const {
     return maximum_load_factor;
 }
 
@@ -386,8 +874,8 @@ float HashTable<Key, Hash>::max_load_factor() const {
 // load factor, throws std::invalid_argument if the
 // input is invalid.
 //---------------------------------------------------------
-template<class Key, class Hash>
-void HashTable<Key, Hash>::max_load_factor(float mlf) {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::max_load_factor(float mlf) {
     maximum_load_factor = mlf;
 }
 
@@ -399,54 +887,223 @@ void HashTable<Key, Hash>::max_load_factor(float mlf) {
 // changed. If the new number of buckets would cause the
 // load factor to exceed the maximum load factor, then
 // the new number of buckets is at least size() /
-// max_load_factor().
+// max_load_factor(). The number of buckets is first
+// rounded up to a size the capacity policy allows.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::rehash(HashTable::size_type buckets) {
+    rehash(buckets, 1);
+}
+
+//-------------------------------------------------------
+// Name: rehash()
+// PreCondition:
+// PostCondition: rehash as above, relinking the nodes with the given
+// number of threads, or one per hardware thread when it
+// is zero. Every bucket ends up in the same order as
+// with one thread.
 //---------------------------------------------------------
-template<class Key, class Hash>
-void HashTable<Key, Hash>::rehash(HashTable::size_type count) {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::rehash(size_type buckets, size_type num_threads) {
+    buckets = Capacity::round_up(buckets);
+
+    // An explicit rehash finishes any incremental one first
+    migrate(old_number_of_buckets);
 
     //If the count is same, no need to rehash
-    if (count == number_of_buckets) {
+    if (buckets == number_of_buckets) {
         return;
     }
 
     // Check for the load factor
-    if (((float) size() / count) > maximum_load_factor) {
+    if (((float) size() / buckets) > maximum_load_factor) {
         std::cout << "Invalid count\n";
         return;
     }
 
-    // create a new hash table and copy values
-    HashTable<Key> *newHashTable = new HashTable<Key>(count);
-    newHashTable->max_load_factor(maximum_load_factor);
-    // std::list<Key> *table2 = new std::list<Key>[count];
+    // create the new buckets and relink every node into them at once
+    start_migration(buckets);
+    size_type threads = thread_count(num_threads);
+    if (threads == 1) {
+        migrate(old_number_of_buckets);
+    } else {
+        relink(threads);
+    }
+}
+
+//-------------------------------------------------------
+// Name: reserve()
+// PreCondition:
+// PostCondition: grow the table to enough buckets for the given number
+// of values at the maximum load factor. Never shrinks
+// the table.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::reserve(size_type values) {
+    size_type buckets = (size_type) ((double) values / maximum_load_factor) + 1;
+    if (buckets > number_of_buckets) {
+        rehash(buckets);
+    }
+}
 
-    for (size_type index = 0; index < number_of_buckets; ++index) {
-        typename std::list<Key>::iterator i;
-        for (i = table[index].begin(); i != table[index].end(); i++) {
-            newHashTable->insert(*i);
+template<class Key, class Hash, class Capacity, bool StoreHash>
+typename HashTable<Key, Hash, Capacity, StoreHash>::bucket_type *HashTable<Key, Hash, Capacity, StoreHash>::get_table() {
+    migrate(old_number_of_buckets);
+    return table;
+}
+
+//-------------------------------------------------------
+// Name: bucket_of()
+// PreCondition:
+// PostCondition: return the list that contains the values with the
+// given hash. While an incremental rehash is in progress
+// this is the old bucket if it has not been moved yet.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+typename HashTable<Key, Hash, Capacity, StoreHash>::bucket_type &
+HashTable<Key, Hash, Capacity, StoreHash>::bucket_of(size_type hash_value) {
+    if (old_table != nullptr) {
+        size_type old_index = Capacity::index(hash_value, old_number_of_buckets);
+        if (old_index >= migrated_buckets) {
+            return old_table[old_index];
         }
     }
+    return table[Capacity::index(hash_value, number_of_buckets)];
+}
 
-    // Clear table;
-    delete[] table;
+//-------------------------------------------------------
+// Name: incremental_rehash()
+// PreCondition:
+// PostCondition: return true if growing the table moves the buckets a
+// few at a time instead of all at once.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+bool HashTable<Key, Hash, Capacity, StoreHash>::incremental_rehash() const {
+    return incremental;
+}
 
-    number_of_buckets = newHashTable->bucket_count();
-    table = new std::list<Key>[number_of_buckets];
+//-------------------------------------------------------
+// Name: incremental_rehash()
+// PreCondition:
+// PostCondition: turn incremental rehashing on or off, turning it off
+// finishes a rehash that is in progress.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::incremental_rehash(bool enabled) {
+    incremental = enabled;
+    if (!incremental) {
+        migrate(old_number_of_buckets);
+    }
+}
 
-    for (size_type index = 0; index < number_of_buckets; ++index) {
-        typename std::list<Key>::iterator i;
-        for (i = (newHashTable->get_table())[index].begin(); i != (newHashTable->get_table())[index].end(); i++) {
-            insert(*i);
-        }
+//-------------------------------------------------------
+// Name: migration_debt()
+// PreCondition:
+// PostCondition: return the number of insert, remove or contains calls
+// left before an incremental rehash has moved every
+// bucket, 0 if none is in progress.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+size_t HashTable<Key, Hash, Capacity, StoreHash>::migration_debt() const {
+    if (old_table == nullptr) {
+        return 0;
+    }
+    return (old_number_of_buckets - migrated_buckets + MIGRATION_STEP - 1) / MIGRATION_STEP;
+}
+
+//-------------------------------------------------------
+// Name: start_migration()
+// PreCondition:
+// PostCondition: finish any incremental rehash in progress, then make
+// the current buckets the old buckets and start over
+// with the given number of empty buckets.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::start_migration(size_type buckets) {
+    migrate(old_number_of_buckets);
+
+    old_table = table;
+    old_number_of_buckets = number_of_buckets;
+    migrated_buckets = 0;
+    table = new bucket_type[buckets];
+    number_of_buckets = buckets;
+}
+
+//-------------------------------------------------------
+// Name: migrate()
+// PreCondition:
+// PostCondition: relink the nodes of up to the given number of old
+// buckets into the new buckets, the values are known to
+// be unique so no lookups are needed. The old buckets
+// are released once all are moved.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::migrate(size_type buckets) {
+    if (old_table == nullptr) {
+        return;
     }
 
-    delete newHashTable;
+    for (size_type moved = 0; moved < buckets && migrated_buckets < old_number_of_buckets; moved++) {
+        bucket_type &old_bucket = old_table[migrated_buckets++];
+        while (!old_bucket.empty()) {
+            size_type index = Capacity::index(hash_of(old_bucket.front()), number_of_buckets);
+            table[index].splice(table[index].end(), old_bucket, old_bucket.begin());
+        }
+    }
 
+    if (migrated_buckets == old_number_of_buckets) {
+        delete[] old_table;
+        old_table = nullptr;
+        migrated_buckets = 0;
+    }
 }
 
-template<class Key, class Hash>
-std::list<Key> *HashTable<Key, Hash>::get_table() {
-    return table;
+//-------------------------------------------------------
+// Name: relink()
+// PreCondition: a migration was just started, threads is greater
+// than zero
+// PostCondition: relinks every node of the old buckets into the new
+// ones and releases the old buckets, as migrate() does.
+// Thread t owns the new buckets from
+// ceil(t * buckets / threads) up to the start of the
+// next thread's buckets. Each thread first moves the
+// nodes of its own range of old buckets into one
+// staging list per owner, then links the nodes staged
+// for it into its own buckets. Nodes are spliced, never
+// copied, and no locks are needed.
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::relink(size_type threads) {
+    // staging[t * threads + r] holds the nodes thread t found for thread
+    // r, and indices the same entry their new buckets
+    std::vector<bucket_type> staging(threads * threads);
+    std::vector<std::vector<size_type>> indices(threads * threads);
+    parallel_for(threads, old_number_of_buckets, [&](size_type t, size_type begin, size_type end) {
+        for (size_type b = begin; b < end; b++) {
+            bucket_type &old_bucket = old_table[b];
+            while (!old_bucket.empty()) {
+                size_type index = Capacity::index(hash_of(old_bucket.front()), number_of_buckets);
+                size_type stage = t * threads + index * threads / number_of_buckets;
+                staging[stage].splice(staging[stage].end(), old_bucket, old_bucket.begin());
+                indices[stage].push_back(index);
+            }
+        }
+    });
+
+    // Taking the staged nodes in thread order keeps the order of the old
+    // buckets, as in migrate()
+    parallel_for(threads, threads, [&](size_type r, size_type, size_type) {
+        for (size_type t = 0; t < threads; t++) {
+            bucket_type &staged = staging[t * threads + r];
+            for (size_type index : indices[t * threads + r]) {
+                table[index].splice(table[index].end(), staged, staged.begin());
+            }
+        }
+    });
+
+    delete[] old_table;
+    old_table = nullptr;
+    migrated_buckets = 0;
 }
 
 //-------------------------------------------------------
@@ -457,28 +1114,89 @@ std::list<Key> *HashTable<Key, Hash>::get_table() {
 // print “<empty>\n”, but the format of the output is
 // not graded.
 //---------------------------------------------------------
-template<class Key, class Hash>
-void HashTable<Key, Hash>::print_table(std::ostream &os) const {
+template<class Key, class Hash, class Capacity, bool StoreHash>
+void HashTable<Key, Hash, Capacity, StoreHash>::print_table(std::ostream &os) const {
     if (is_empty()) {
         os << "<empty>\n";
         return;
     }
-    for (size_type i = 0; i < number_of_buckets; i++) {
-        if (table[i].size() == 0) {
-            continue;
-        }
-        os << i << ": [";
+    auto print_bucket = [&os](const bucket_type &bucket) {
+        os << "[";
         bool first = true;
-        for (auto x : table[i]) {
+        for (auto &x : bucket) {
             if (first) {
-                os << x;
+                os << value_of(x);
                 first = false;
             } else {
-                os << ", " << x;
+                os << ", " << value_of(x);
             }
         }
         os << "]" << std::endl;
+    };
+
+    for (size_type i = 0; i < number_of_buckets; i++) {
+        if (table[i].size() == 0) {
+            continue;
+        }
+        os << i << ": ";
+        print_bucket(table[i]);
+    }
+    for (size_type i = migrated_buckets; old_table != nullptr && i < old_number_of_buckets; i++) {
+        if (old_table[i].size() == 0) {
+            continue;
+        }
+        os << "old " << i << ": ";
+        print_bucket(old_table[i]);
     }
 }
 
+//-------------------------------------------------------
+// Name: value_of()
+// PreCondition:
+// PostCondition: return the value held in a node
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+const Key &HashTable<Key, Hash, Capacity, StoreHash>::value_of(const stored_type &stored) {
+    if constexpr (StoreHash) {
+        return stored.value;
+    } else {
+        return stored;
+    }
+}
+
+//-------------------------------------------------------
+// Name: hash_of()
+// PreCondition:
+// PostCondition: return the hash of the value held in a node, read
+// from the node when it is stored there
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+typename HashTable<Key, Hash, Capacity, StoreHash>::size_type
+HashTable<Key, Hash, Capacity, StoreHash>::hash_of(const stored_type &stored) {
+    if constexpr (StoreHash) {
+        return stored.hash;
+    } else {
+        return Hash{}(stored);
+    }
+}
+
+//-------------------------------------------------------
+// Name: matches()
+// PreCondition: hash_value is the hash of key
+// PostCondition: return true if the node holds key, the values are
+// only compared when the stored hash is equal
+//---------------------------------------------------------
+template<class Key, class Hash, class Capacity, bool StoreHash>
+template<class K>
+bool HashTable<Key, Hash, Capacity, StoreHash>::matches(const stored_type &stored, size_type hash_value,
+                                                        const K &key) {
+    if constexpr (StoreHash) {
+        return stored.hash == hash_value && stored.value == key;
+    } else {
+        return stored == key;
+    }
+}
+
+}  // namespace separate_chaining
+
 #endif  // HASHTABLE_SEPARATE_CHAINING_H
@@ -1,16 +1,62 @@
 #include <iostream>
+#include <string>
+#include <vector>
+#include <string_view>
 #include <sstream>
 #include "hashtable_separate_chaining.h"
 
+using separate_chaining::HashTable;
+using separate_chaining::S;
+
 using std::cout, std::endl;
 
+// Counts its calls, to check that a table storing hash codes does not
+// hash again when it grows
+struct CountingHash {
+    static size_t calls;
+
+    size_t operator()(const std::string &s) const {
+        calls++;
+        return std::hash<std::string>{}(s);
+    }
+};
+
+size_t CountingHash::calls = 0;
+
 void test_integer_1();
 
 void test_string();
 
+void test_power_of_two();
+
+void test_incremental_rehash();
+
+void test_move();
+
+void test_transparent();
+
+void test_stored_hash();
+
+void test_size_tracking();
+
+void test_batch();
+
+void test_build();
+
+void test_parallel_rehash();
+
 int main() {
     test_integer_1();
     test_string();
+    test_power_of_two();
+    test_incremental_rehash();
+    test_move();
+    test_transparent();
+    test_stored_hash();
+    test_size_tracking();
+    test_batch();
+    test_build();
+    test_parallel_rehash();
     return 0;
 }
 
@@ -184,4 +230,426 @@ void test_string() {
         table.print_table(ss);
         std::cout << ss.str() << std::endl;
     }
-}
\ No newline at end of file
+}
+
+void test_power_of_two() {
+    const int INITIAL_TABLE_SIZE = 11;
+    const int ROUNDED_TABLE_SIZE = 16;
+    const int NUMBER_OF_INPUTS = 2000;
+
+    std::cout << "make a power of two hash table for ints" << std::endl;
+    HashTable<int, std::hash<int>, PowerOfTwoCapacity> table(INITIAL_TABLE_SIZE);
+
+    if (table.bucket_count() == ROUNDED_TABLE_SIZE) {
+        std::cout << "[PASSED] power of two bucket count test " << std::endl;
+    } else {
+        std::cout << "power of two bucket count test failed" << std::endl;
+    }
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n * 1024);
+    }
+
+    size_t buckets = table.bucket_count();
+    bool all_found = (buckets & (buckets - 1)) == 0;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n * 1024) && !table.contains(n * 1024 + 1);
+    }
+
+    // Fibonacci hashing spreads the multiples of 1024 over the buckets
+    size_t longest = 0;
+    for (size_t i = 0; i < buckets; i++) {
+        longest = std::max(longest, table.bucket_size(i));
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS && table.load_factor() <= 1.0f && longest < 10) {
+        std::cout << "[PASSED] power of two grow test " << std::endl;
+    } else {
+        std::cout << "power of two grow test failed" << std::endl;
+    }
+
+    table.rehash(4 * buckets + 1);
+    if (table.bucket_count() == 8 * buckets && table.bucket(1024) < table.bucket_count() && table.contains(1024)) {
+        std::cout << "[PASSED] power of two rehash test " << std::endl;
+    } else {
+        std::cout << "power of two rehash test failed" << std::endl;
+    }
+}
+
+void test_incremental_rehash() {
+    const int INITIAL_TABLE_SIZE = 11;
+    const int NUMBER_OF_INPUTS = 1000;
+
+    std::cout << "make a hash table for ints that rehashes incrementally" << std::endl;
+    HashTable<int> table(INITIAL_TABLE_SIZE);
+    table.incremental_rehash(true);
+
+    if (table.incremental_rehash() && table.migration_debt() == 0) {
+        std::cout << "[PASSED] incremental rehash enable test " << std::endl;
+    } else {
+        std::cout << "incremental rehash enable test failed" << std::endl;
+    }
+
+    // Insert until a growth leaves buckets to be moved
+    int inserted = 0;
+    while (table.migration_debt() == 0 && inserted < NUMBER_OF_INPUTS) {
+        table.insert(inserted++);
+    }
+
+    bool all_found = table.migration_debt() > 0 && table.size() == (size_t) inserted;
+    for (int n = 0; n < inserted; n++) {
+        all_found = all_found && !table.insert(n);
+    }
+
+    // A copy taken in the middle of the rehash holds the same values
+    HashTable<int> copy(table);
+    for (int n = 0; n < inserted; n++) {
+        all_found = all_found && copy.contains(n) && !copy.contains(n + NUMBER_OF_INPUTS);
+    }
+
+    if (all_found && copy.size() == (size_t) inserted) {
+        std::cout << "[PASSED] incremental rehash lookup test " << std::endl;
+    } else {
+        std::cout << "incremental rehash lookup test failed" << std::endl;
+    }
+
+    for (int n = inserted; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n);
+    }
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        table.remove(n);
+    }
+
+    // Every operation moves a few more, lookups alone finish the rehash
+    size_t lookups = 0;
+    while (table.migration_debt() > 0) {
+        table.contains(NUMBER_OF_INPUTS);
+        lookups++;
+    }
+
+    all_found = lookups < table.bucket_count();
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n) == (n % 2 == 1);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS / 2) {
+        std::cout << "[PASSED] incremental rehash finish test " << std::endl;
+    } else {
+        std::cout << "incremental rehash finish test failed" << std::endl;
+    }
+
+    table.incremental_rehash(false);
+    table.rehash(4 * table.bucket_count());
+    if (!table.incremental_rehash() && table.migration_debt() == 0 && table.contains(1) && !table.contains(2)) {
+        std::cout << "[PASSED] incremental rehash disable test " << std::endl;
+    } else {
+        std::cout << "incremental rehash disable test failed" << std::endl;
+    }
+}
+
+void test_move() {
+    const int NUMBER_OF_INPUTS = 100;
+    const int REPEATED_LENGTH = 40;
+
+    std::cout << "make a hash table for strings and move values into it" << std::endl;
+    HashTable<std::string> table;
+
+    std::string value(REPEATED_LENGTH, 'a');
+    bool inserted = table.insert(std::move(value));
+    std::string again(REPEATED_LENGTH, 'a');
+    if (inserted && !table.insert(std::move(again)) && again.size() == REPEATED_LENGTH
+        && table.contains(std::string(REPEATED_LENGTH, 'a'))) {
+        std::cout << "[PASSED] move insert test " << std::endl;
+    } else {
+        std::cout << "move insert test failed" << std::endl;
+    }
+
+    // The arguments of the std::string(count, ch) constructor
+    if (table.emplace(REPEATED_LENGTH, 'b') && !table.emplace(REPEATED_LENGTH, 'b')
+        && table.emplace("c") && table.contains(std::string(REPEATED_LENGTH, 'b')) && table.contains("c")
+        && table.size() == 3) {
+        std::cout << "[PASSED] emplace test " << std::endl;
+    } else {
+        std::cout << "emplace test failed" << std::endl;
+    }
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.emplace(std::to_string(n));
+    }
+
+    size_t cells = table.bucket_count();
+    HashTable<std::string> moved(std::move(table));
+    bool all_found = moved.size() == NUMBER_OF_INPUTS + 3 && moved.bucket_count() == cells;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && moved.contains(std::to_string(n));
+    }
+
+    // The moved from table is still usable
+    if (all_found && table.size() == 0 && table.insert("d") && table.contains("d")) {
+        std::cout << "[PASSED] move constructor test " << std::endl;
+    } else {
+        std::cout << "move constructor test failed" << std::endl;
+    }
+
+    table = std::move(moved);
+    if (table.size() == NUMBER_OF_INPUTS + 3 && table.contains("c") && !table.contains("d")) {
+        std::cout << "[PASSED] move assignment test " << std::endl;
+    } else {
+        std::cout << "move assignment test failed" << std::endl;
+    }
+}
+
+void test_transparent() {
+    const int NUMBER_OF_INPUTS = 50;
+
+    std::cout << "make a hash table for strings with a transparent hash" << std::endl;
+    HashTable<std::string, StringHash> table;
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert("/api/v1/session/" + std::to_string(n));
+    }
+
+    // The views point into a larger buffer, as they would from a parser
+    std::string line = "GET /api/v1/session/7 HTTP/1.1";
+    std::string_view view = std::string_view(line).substr(4, 17);
+
+    if (table.contains(view) && table.contains("/api/v1/session/8") && !table.contains(std::string_view(line))) {
+        std::cout << "[PASSED] transparent contains test " << std::endl;
+    } else {
+        std::cout << "transparent contains test failed" << std::endl;
+    }
+
+    if (table.bucket(view) == table.bucket(std::string(view))) {
+        std::cout << "[PASSED] transparent bucket test " << std::endl;
+    } else {
+        std::cout << "transparent bucket test failed" << std::endl;
+    }
+
+    if (table.remove(view) == 1 && table.remove(view) == 0 && !table.contains(std::string(view))
+        && table.size() == NUMBER_OF_INPUTS - 1) {
+        std::cout << "[PASSED] transparent remove test " << std::endl;
+    } else {
+        std::cout << "transparent remove test failed" << std::endl;
+    }
+
+    // std::hash<S<Key>> is transparent as well, so S values are found by key
+    HashTable<S<std::string>> wrapped;
+    wrapped.insert(S<std::string>{"alpha"});
+    wrapped.insert(S<std::string>{"beta"});
+
+    if (wrapped.contains("alpha") && wrapped.contains(std::string_view("beta")) && !wrapped.contains("gamma")
+        && wrapped.contains(S<std::string>{"beta"}) && wrapped.remove("alpha") == 1 && wrapped.size() == 1) {
+        std::cout << "[PASSED] transparent S test " << std::endl;
+    } else {
+        std::cout << "transparent S test failed" << std::endl;
+    }
+}
+
+void test_stored_hash() {
+    const int NUMBER_OF_INPUTS = 200;
+
+    std::cout << "make a hash table for strings that stores the hash codes" << std::endl;
+    HashTable<std::string, CountingHash, PrimeCapacity, true> table;
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert("/api/v1/session/" + std::to_string(n));
+    }
+    table.emplace("/api/v1/session/0");
+
+    // Every insert and lookup hashes its argument exactly once
+    bool all_found = CountingHash::calls == NUMBER_OF_INPUTS + 1 && table.size() == NUMBER_OF_INPUTS;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains("/api/v1/session/" + std::to_string(n));
+    }
+    all_found = all_found && !table.contains("/api/v1/session/" + std::to_string(NUMBER_OF_INPUTS));
+
+    if (all_found && CountingHash::calls == 2 * NUMBER_OF_INPUTS + 2) {
+        std::cout << "[PASSED] stored hash lookup test " << std::endl;
+    } else {
+        std::cout << "stored hash lookup test failed" << std::endl;
+    }
+
+    size_t calls = CountingHash::calls;
+    table.rehash(4 * table.bucket_count());
+    if (CountingHash::calls == calls && table.contains("/api/v1/session/7") && table.remove("/api/v1/session/7") == 1
+        && !table.contains("/api/v1/session/7") && table.size() == NUMBER_OF_INPUTS - 1) {
+        std::cout << "[PASSED] stored hash rehash test " << std::endl;
+    } else {
+        std::cout << "stored hash rehash test failed" << std::endl;
+    }
+
+    // Transparent lookups compare against the stored hash codes as well
+    HashTable<std::string, StringHash, PowerOfTwoCapacity, true> transparent;
+    transparent.insert("alpha");
+    transparent.emplace(4, 'b');
+    if (transparent.contains(std::string_view("alpha")) && transparent.contains("bbbb") && !transparent.contains("bbb")) {
+        std::cout << "[PASSED] stored hash transparent test " << std::endl;
+    } else {
+        std::cout << "stored hash transparent test failed" << std::endl;
+    }
+}
+
+void test_size_tracking() {
+    const int NUMBER_OF_INPUTS = 100000;
+
+    std::cout << "make a large hash table for ints and track its size" << std::endl;
+    HashTable<int> table;
+
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n);
+        table.insert(n);
+    }
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+        table.remove(n);
+        table.remove(n);
+    }
+    table.emplace(0);
+
+    if (table.size() == NUMBER_OF_INPUTS / 2 + 1 && !table.is_empty()
+        && table.load_factor() == (float) table.size() / (float) table.bucket_count()) {
+        std::cout << "[PASSED] size after insert and remove test " << std::endl;
+    } else {
+        std::cout << "size after insert and remove test failed" << std::endl;
+    }
+
+    HashTable<int> copy(table);
+    table.rehash(4 * table.bucket_count());
+    HashTable<int> moved(std::move(copy));
+    if (table.size() == NUMBER_OF_INPUTS / 2 + 1 && moved.size() == table.size() && copy.size() == 0
+        && copy.is_empty()) {
+        std::cout << "[PASSED] size after copy, move and rehash test " << std::endl;
+    } else {
+        std::cout << "size after copy, move and rehash test failed" << std::endl;
+    }
+
+    table.make_empty();
+    if (table.size() == 0 && table.is_empty() && table.load_factor() == 0.0f) {
+        std::cout << "[PASSED] size after make empty test " << std::endl;
+    } else {
+        std::cout << "size after make empty test failed" << std::endl;
+    }
+}
+
+void test_batch() {
+    const int NUMBER_OF_INPUTS = 1000;
+
+    std::cout << "insert, find and remove keys in batches" << std::endl;
+    HashTable<int> table;
+    table.incremental_rehash(true);
+
+    std::vector<int> keys;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        keys.push_back(n * 3);
+    }
+    // The duplicate at the end is not inserted twice
+    keys.push_back(0);
+
+    if (table.insert_batch(keys.data(), keys.size()) == NUMBER_OF_INPUTS && table.size() == NUMBER_OF_INPUTS) {
+        std::cout << "[PASSED] insert batch test " << std::endl;
+    } else {
+        std::cout << "insert batch test failed" << std::endl;
+    }
+
+    // Every other probe is a key that was never inserted
+    std::vector<int> probes;
+    for (int n = 0; n < 2 * NUMBER_OF_INPUTS; n++) {
+        probes.push_back(n % 2 == 0 ? n / 2 * 3 : n * 3 + 1);
+    }
+    std::vector<bool> found;
+    bool all_found = table.contains_batch(probes.data(), probes.size(), found) == NUMBER_OF_INPUTS
+                     && table.contains_batch(probes.data(), probes.size()) == NUMBER_OF_INPUTS
+                     && found.size() == probes.size();
+    for (size_t i = 0; i < probes.size(); i++) {
+        all_found = all_found && found[i] == (i % 2 == 0) && found[i] == table.contains(probes[i]);
+    }
+
+    if (all_found) {
+        std::cout << "[PASSED] contains batch test " << std::endl;
+    } else {
+        std::cout << "contains batch test failed" << std::endl;
+    }
+
+    if (table.remove_batch(probes.data(), probes.size()) == NUMBER_OF_INPUTS && table.is_empty()
+        && table.remove_batch(keys.data(), 0) == 0) {
+        std::cout << "[PASSED] remove batch test " << std::endl;
+    } else {
+        std::cout << "remove batch test failed" << std::endl;
+    }
+}
+
+void test_build() {
+    const int NUMBER_OF_INPUTS = 5000;
+
+    std::cout << "build tables from a range of keys with one and with four threads" << std::endl;
+    std::vector<int> keys;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        keys.push_back(n * 7);
+    }
+    // Duplicates are only stored once
+    for (int n = 0; n < NUMBER_OF_INPUTS; n += 10) {
+        keys.push_back(n * 7);
+    }
+
+    bool all_built = true;
+    for (size_t threads : {1, 4}) {
+        HashTable<int> table;
+        table.insert(-1);
+        table.build(keys.begin(), keys.end(), threads);
+
+        bool built = table.size() == NUMBER_OF_INPUTS && !table.contains(-1) && table.load_factor() <= 1.0f;
+        for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+            built = built && table.contains(n * 7) && !table.contains(n * 7 + 1);
+        }
+        // The table stays usable afterwards
+        built = built && table.insert(-1) && table.remove(0) == 1 && table.size() == NUMBER_OF_INPUTS;
+        all_built = all_built && built;
+    }
+
+    if (all_built) {
+        std::cout << "[PASSED] build test " << std::endl;
+    } else {
+        std::cout << "build test failed" << std::endl;
+    }
+
+    HashTable<int> empty;
+    empty.build(keys.begin(), keys.begin(), 4);
+    if (empty.is_empty() && empty.insert(1) && empty.contains(1)) {
+        std::cout << "[PASSED] build empty range test " << std::endl;
+    } else {
+        std::cout << "build empty range test failed" << std::endl;
+    }
+}
+
+void test_parallel_rehash() {
+    const int NUMBER_OF_INPUTS = 20000;
+    const int REHASH_VALUE = 30011;
+
+    std::cout << "rehash with four threads" << std::endl;
+    HashTable<int> table;
+    HashTable<int> sequential;
+    HashTable<int, std::hash<int>, PrimeCapacity, true> hashed;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n * 5);
+        sequential.insert(n * 5);
+        hashed.insert(n * 5);
+    }
+    table.rehash(REHASH_VALUE, 4);
+    sequential.rehash(REHASH_VALUE, 1);
+    hashed.rehash(REHASH_VALUE, 4);
+
+    bool rehashed = table.bucket_count() == REHASH_VALUE && table.size() == NUMBER_OF_INPUTS
+                    && hashed.size() == NUMBER_OF_INPUTS;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        rehashed = rehashed && table.contains(n * 5) && hashed.contains(n * 5) && !table.contains(n * 5 + 1);
+    }
+    // The buckets keep the order a single thread gives them
+    for (int b = 0; b < REHASH_VALUE; b++) {
+        rehashed = rehashed && table.get_table()[b] == sequential.get_table()[b];
+    }
+
+    if (rehashed) {
+        std::cout << "[PASSED] parallel rehash test " << std::endl;
+    } else {
+        std::cout << "parallel rehash test failed" << std::endl;
+    }
+}
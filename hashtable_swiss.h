@@ -0,0 +1,491 @@
+#ifndef HASHTABLE_SWISS_H
+#define HASHTABLE_SWISS_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+// Define HASHTABLE_SWISS_SCALAR to use the portable group scan even when
+// the compiler targets SSE2 or AVX2.
+#if !defined(HASHTABLE_SWISS_SCALAR) && defined(__AVX2__)
+#define HASHTABLE_SWISS_AVX2
+#include <immintrin.h>
+#elif !defined(HASHTABLE_SWISS_SCALAR) && defined(__SSE2__)
+#define HASHTABLE_SWISS_SSE2
+#include <emmintrin.h>
+#endif
+
+//-------------------------------------------------------
+// One group of control bytes. Every match returns a bit mask with bit i
+// set if the i-th control byte of the group matches.
+//---------------------------------------------------------
+struct ControlGroup {
+    using mask_type = std::uint32_t;
+
+    // Control byte of a cell that never held a value, or whose value was
+    // removed. A full cell holds the low 7 bits of the hash of its value.
+    static constexpr signed char EMPTY = -128;
+    static constexpr signed char DELETED = -2;
+
+#if defined(HASHTABLE_SWISS_AVX2)
+    static constexpr std::size_t WIDTH = 32;
+    __m256i control;
+
+    explicit ControlGroup(const signed char *position)
+            : control(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(position))) {}
+
+    mask_type match(signed char fragment) const {
+        return (mask_type) _mm256_movemask_epi8(_mm256_cmpeq_epi8(control, _mm256_set1_epi8(fragment)));
+    }
+
+    mask_type match_empty() const {
+        return match(EMPTY);
+    }
+
+    // EMPTY and DELETED are the only negative control bytes
+    mask_type match_empty_or_deleted() const {
+        return (mask_type) _mm256_movemask_epi8(control);
+    }
+
+    static const char *kind() { return "avx2"; }
+#elif defined(HASHTABLE_SWISS_SSE2)
+    static constexpr std::size_t WIDTH = 16;
+    __m128i control;
+
+    explicit ControlGroup(const signed char *position)
+            : control(_mm_loadu_si128(reinterpret_cast<const __m128i *>(position))) {}
+
+    mask_type match(signed char fragment) const {
+        return (mask_type) _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(fragment)));
+    }
+
+    mask_type match_empty() const {
+        return match(EMPTY);
+    }
+
+    // EMPTY and DELETED are the only negative control bytes
+    mask_type match_empty_or_deleted() const {
+        return (mask_type) _mm_movemask_epi8(control);
+    }
+
+    static const char *kind() { return "sse2"; }
+#else
+    static constexpr std::size_t WIDTH = 16;
+    const signed char *control;
+
+    explicit ControlGroup(const signed char *position) : control(position) {}
+
+    mask_type match(signed char fragment) const {
+        mask_type mask = 0;
+        for (std::size_t i = 0; i < WIDTH; i++) {
+            mask |= (mask_type) (control[i] == fragment) << i;
+        }
+        return mask;
+    }
+
+    mask_type match_empty() const {
+        return match(EMPTY);
+    }
+
+    mask_type match_empty_or_deleted() const {
+        mask_type mask = 0;
+        for (std::size_t i = 0; i < WIDTH; i++) {
+            mask |= (mask_type) (control[i] < 0) << i;
+        }
+        return mask;
+    }
+
+    static const char *kind() { return "scalar"; }
+#endif
+};
+
+// Open addressing over groups of cells. A separate array holds one control
+// byte per cell, so a whole group is compared against the 7 bit fragment of
+// the hash at once and the keys are only read for cells whose fragment
+// matches. Most lookups of missing keys never touch the keys at all.
+template<class Key, class Hash=std::hash<Key>>
+class SwissHashTable {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hash = Hash;
+    using size_type = size_t;
+
+private:
+    size_type number_of_cells;
+    size_type count;
+    size_type deleted_count;
+
+    std::vector<signed char> control;
+    std::vector<Key> keys;
+
+    // Constants
+    static constexpr size_type GROUP_WIDTH = ControlGroup::WIDTH;
+    static constexpr size_type DEFAULT_CELL_SIZE = ControlGroup::WIDTH;
+    static constexpr float MAX_LOAD_FACTOR = 0.875f;
+
+    static size_type mix(size_type hash_value);
+
+    static size_type round_cells(size_type cells);
+
+    size_type find(const key_type &key, size_type hash_value) const;
+
+    size_type find_free(size_type hash_value) const;
+
+    void resize(size_type cells);
+
+public:
+    SwissHashTable();
+
+    SwissHashTable(size_type cells);
+
+    bool is_empty() const;
+
+    size_t size() const;
+
+    size_t table_size() const;
+
+    void make_empty();
+
+    bool insert(const value_type &value);
+
+    size_t remove(const key_type &key);
+
+    bool contains(const key_type &key) const;
+
+    size_t position(const key_type &key) const;
+
+    bool rehash(size_type count);
+
+    float load_factor() const;
+
+    void print_table(std::ostream &os = std::cout) const;
+};
+
+//-------------------------------------------------------
+// Name: SwissHashTable
+// PreCondition:
+// PostCondition: makes an empty table with one group of cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+SwissHashTable<Key, Hash>::SwissHashTable() : SwissHashTable(DEFAULT_CELL_SIZE) {
+}
+
+//-------------------------------------------------------
+// Name: SwissHashTable
+// PreCondition:
+// PostCondition: makes an empty table with at least the specified
+// number of cells, rounded up to a power of two number
+// of groups.
+//---------------------------------------------------------
+template<class Key, class Hash>
+SwissHashTable<Key, Hash>::SwissHashTable(size_type cells) {
+    number_of_cells = round_cells(cells);
+    count = 0;
+    deleted_count = 0;
+    control.assign(number_of_cells, ControlGroup::EMPTY);
+    keys.resize(number_of_cells);
+}
+
+//-------------------------------------------------------
+// Name: round_cells
+// PreCondition:
+// PostCondition: returns the smallest power of two number of cells
+// that is at least one group and at least cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename SwissHashTable<Key, Hash>::size_type SwissHashTable<Key, Hash>::round_cells(size_type cells) {
+    size_type rounded = GROUP_WIDTH;
+    while (rounded < cells) {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+//-------------------------------------------------------
+// Name: mix
+// PreCondition:
+// PostCondition: returns the hash with all bits mixed, so that both the
+// group (high bits) and the fragment (low 7 bits) are
+// usable even for identity hashes.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename SwissHashTable<Key, Hash>::size_type SwissHashTable<Key, Hash>::mix(size_type hash_value) {
+    std::uint64_t h = hash_value;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return (size_type) h;
+}
+
+//-------------------------------------------------------
+// Name: find
+// PreCondition:  hash_value is the mixed hash of key
+// PostCondition: returns the cell holding key, or number_of_cells if
+// it is not in the table. Groups are visited in
+// triangular order, which reaches every group once.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename SwissHashTable<Key, Hash>::size_type
+SwissHashTable<Key, Hash>::find(const key_type &key, size_type hash_value) const {
+    const signed char fragment = (signed char) (hash_value & 0x7F);
+    const size_type group_mask = number_of_cells / GROUP_WIDTH - 1;
+    size_type group = (hash_value >> 7) & group_mask;
+
+    for (size_type step = 1; step <= group_mask + 1; step++) {
+        const size_type first_cell = group * GROUP_WIDTH;
+        ControlGroup control_group(&control[first_cell]);
+
+        for (auto mask = control_group.match(fragment); mask != 0; mask &= mask - 1) {
+            size_type index = first_cell + __builtin_ctz(mask);
+            if (keys[index] == key) {
+                return index;
+            }
+        }
+
+        // Nothing was ever probed past a group with an empty cell
+        if (control_group.match_empty() != 0) {
+            break;
+        }
+        group = (group + step) & group_mask;
+    }
+
+    return number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: find_free
+// PreCondition:  the table has at least one empty or deleted cell
+// PostCondition: returns the first empty or deleted cell on the probe
+// sequence of the hash.
+//---------------------------------------------------------
+template<class Key, class Hash>
+typename SwissHashTable<Key, Hash>::size_type SwissHashTable<Key, Hash>::find_free(size_type hash_value) const {
+    const size_type group_mask = number_of_cells / GROUP_WIDTH - 1;
+    size_type group = (hash_value >> 7) & group_mask;
+
+    for (size_type step = 1;; step++) {
+        const size_type first_cell = group * GROUP_WIDTH;
+        auto mask = ControlGroup(&control[first_cell]).match_empty_or_deleted();
+        if (mask != 0) {
+            return first_cell + __builtin_ctz(mask);
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+//-------------------------------------------------------
+// Name: is_empty
+// PreCondition:
+// PostCondition: returns true if the table is empty.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool SwissHashTable<Key, Hash>::is_empty() const {
+    return count == 0;
+}
+
+//-------------------------------------------------------
+// Name: size
+// PreCondition:
+// PostCondition: returns the number of active values in the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t SwissHashTable<Key, Hash>::size() const {
+    return count;
+}
+
+//-------------------------------------------------------
+// Name: table_size
+// PreCondition:
+// PostCondition: return the number of cells in the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t SwissHashTable<Key, Hash>::table_size() const {
+    return number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: make_empty
+// PreCondition:
+// PostCondition: remove all values from the table. Do not change the
+// number of cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void SwissHashTable<Key, Hash>::make_empty() {
+    control.assign(number_of_cells, ControlGroup::EMPTY);
+    count = 0;
+    deleted_count = 0;
+}
+
+//-------------------------------------------------------
+// Name: insert
+// PreCondition:
+// PostCondition: insert the given value reference into the table,
+// growing the table if the maximum load factor would be
+// exceeded, return true if insert was successful (false
+// if item already exists).
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool SwissHashTable<Key, Hash>::insert(const value_type &value) {
+    size_type hash_value = mix(Hash{}(value));
+    if (find(value, hash_value) != number_of_cells) {
+        return false;
+    }
+
+    // Deleted cells count towards the load as they lengthen the probes,
+    // while the values alone leave enough room the table is rebuilt at the
+    // same size instead of growing
+    if ((float) (count + deleted_count + 1) > MAX_LOAD_FACTOR * (float) number_of_cells) {
+        if (count * 32 <= number_of_cells * 25) {
+            resize(number_of_cells);
+        } else {
+            resize(number_of_cells * 2);
+        }
+    }
+
+    size_type index = find_free(hash_value);
+    if (control[index] == ControlGroup::DELETED) {
+        deleted_count--;
+    }
+    control[index] = (signed char) (hash_value & 0x7F);
+    keys[index] = value;
+    count++;
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: remove
+// PreCondition:
+// PostCondition: remove the specified value from the table, return
+// number of elements removed (0 or 1). The cell is only
+// marked as deleted if its group is full, as no probe
+// sequence continues past a group with an empty cell.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t SwissHashTable<Key, Hash>::remove(const key_type &key) {
+    size_type index = find(key, mix(Hash{}(key)));
+    if (index == number_of_cells) {
+        return 0;
+    }
+
+    size_type first_cell = index - index % GROUP_WIDTH;
+    if (ControlGroup(&control[first_cell]).match_empty() != 0) {
+        control[index] = ControlGroup::EMPTY;
+    } else {
+        control[index] = ControlGroup::DELETED;
+        deleted_count++;
+    }
+    count--;
+    return 1;
+}
+
+//-------------------------------------------------------
+// Name: contains
+// PreCondition:
+// PostCondition: returns Boolean true if the specified value is in the
+// table
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool SwissHashTable<Key, Hash>::contains(const key_type &key) const {
+    return find(key, mix(Hash{}(key))) != number_of_cells;
+}
+
+//-------------------------------------------------------
+// Name: position
+// PreCondition:
+// PostCondition: return the index of the cell that contains the
+// specified value, or an invalid index if it is not in
+// the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+size_t SwissHashTable<Key, Hash>::position(const key_type &key) const {
+    size_type index = find(key, mix(Hash{}(key)));
+    return index == number_of_cells ? number_of_cells + 1 : index;
+}
+
+//-------------------------------------------------------
+// Name: resize
+// PreCondition:  cells is a power of two multiple of the group width
+// and can hold all the values
+// PostCondition: moves every value into a fresh set of cells, which
+// also drops all the deleted cells.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void SwissHashTable<Key, Hash>::resize(size_type cells) {
+    std::vector<signed char> old_control(cells, ControlGroup::EMPTY);
+    std::vector<Key> old_keys(cells);
+    old_control.swap(control);
+    old_keys.swap(keys);
+    number_of_cells = cells;
+    deleted_count = 0;
+
+    for (size_type i = 0; i < old_control.size(); i++) {
+        if (old_control[i] < 0) {
+            continue;
+        }
+        size_type hash_value = mix(Hash{}(old_keys[i]));
+        size_type index = find_free(hash_value);
+        control[index] = old_control[i];
+        keys[index] = std::move(old_keys[i]);
+    }
+}
+
+//-------------------------------------------------------
+// Name: rehash()
+// PreCondition:
+// PostCondition: set the number of cells to the specified value,
+// rounded up to a power of two number of groups, and
+// rehash the table if the total number of cells has
+// changed. Returns false without rehashing if the new
+// number of cells would exceed the maximum load factor.
+//---------------------------------------------------------
+template<class Key, class Hash>
+bool SwissHashTable<Key, Hash>::rehash(size_type table_size) {
+    table_size = round_cells(table_size);
+    if (table_size == number_of_cells) {
+        return false;
+    }
+
+    if ((float) size() > MAX_LOAD_FACTOR * (float) table_size) {
+        return false;
+    }
+
+    resize(table_size);
+    return true;
+}
+
+//-------------------------------------------------------
+// Name: load_factor()
+// PreCondition:
+// PostCondition: return the current load factor of the table.
+//---------------------------------------------------------
+template<class Key, class Hash>
+float SwissHashTable<Key, Hash>::load_factor() const {
+    return (float) size() / (float) table_size();
+}
+
+//-------------------------------------------------------
+// Name: print_table
+// PreCondition:
+// PostCondition: pretty print the table, the empty table should
+// print “<empty>\n”.
+//---------------------------------------------------------
+template<class Key, class Hash>
+void SwissHashTable<Key, Hash>::print_table(std::ostream &os) const {
+    if (is_empty()) {
+        os << "<empty>\n";
+        return;
+    }
+    for (size_type i = 0; i < number_of_cells; i++) {
+        if (control[i] >= 0) {
+            os << i << ": ";
+            os << keys[i];
+            os << std::endl;
+        }
+    }
+}
+
+#endif  // HASHTABLE_SWISS_H
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "hashtable_swiss.h"
+
+void test_integer_1();
+
+void test_full_groups();
+
+void test_strings();
+
+int main() {
+    std::cout << "control groups use " << ControlGroup::kind() << std::endl;
+    test_integer_1();
+    test_full_groups();
+    test_strings();
+    return 0;
+}
+
+void test_integer_1() {
+    const int INITIAL_SIZE = 0;
+    const int NUMBER_OF_INPUTS = 3;
+    const int NUMBER_OF_INPUTS_AFTER_REMOVE = 2;
+
+    std::cout << "make an empty swiss table for ints" << std::endl;
+    SwissHashTable<int> table(11);
+
+    if (table.size() == INITIAL_SIZE && table.table_size() == ControlGroup::WIDTH) {
+        std::cout << "[PASSED] initial size test " << std::endl;
+    } else {
+        std::cout << "initial size test failed" << std::endl;
+    }
+
+    table.insert(5);
+    table.insert(3);
+    table.insert(6);
+
+    if (table.size() == NUMBER_OF_INPUTS && !table.insert(3)) {
+        std::cout << "[PASSED] insert test " << std::endl;
+    } else {
+        std::cout << "insert test failed" << std::endl;
+    }
+
+    if (table.contains(6) && !table.contains(8) && table.position(8) > table.table_size()) {
+        std::cout << "[PASSED] contains test " << std::endl;
+    } else {
+        std::cout << "contains test failed" << std::endl;
+    }
+
+    table.remove(8);
+    table.remove(6);
+    if (table.size() == NUMBER_OF_INPUTS_AFTER_REMOVE && !table.contains(6) && table.contains(5)) {
+        std::cout << "[PASSED] remove test" << std::endl;
+    } else {
+        std::cout << "remove test failed" << std::endl;
+    }
+
+    if (!table.rehash(1) && table.rehash(1000) && table.table_size() == 1024 && table.contains(3)) {
+        std::cout << "[PASSED] rehash test " << std::endl;
+    } else {
+        std::cout << "rehash test failed" << std::endl;
+    }
+
+    table.make_empty();
+    if (table.is_empty() && !table.contains(5)) {
+        std::cout << "[PASSED] make empty test " << std::endl;
+    } else {
+        std::cout << "make empty test failed" << std::endl;
+    }
+}
+
+void test_full_groups() {
+    const int NUMBER_OF_INPUTS = 100000;
+
+    std::cout << "fill a swiss table so most groups are full" << std::endl;
+    SwissHashTable<int> table;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        table.insert(n);
+    }
+
+    bool all_found = true;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n) && !table.contains(n + NUMBER_OF_INPUTS);
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS && table.load_factor() <= 0.875f) {
+        std::cout << "[PASSED] grow test " << std::endl;
+    } else {
+        std::cout << "grow test failed" << std::endl;
+    }
+
+    std::cout << "remove and insert values without growing the table" << std::endl;
+    size_t cells = table.table_size();
+    for (int round = 1; round <= 10; round++) {
+        for (int n = 0; n < NUMBER_OF_INPUTS; n += 2) {
+            table.remove(n + (round - 1) * NUMBER_OF_INPUTS);
+            table.insert(n + round * NUMBER_OF_INPUTS);
+        }
+    }
+
+    all_found = true;
+    for (int n = 0; n < NUMBER_OF_INPUTS; n++) {
+        all_found = all_found && table.contains(n + (n % 2 == 0 ? 10 * NUMBER_OF_INPUTS : 0));
+    }
+
+    if (all_found && table.size() == NUMBER_OF_INPUTS && table.table_size() == cells) {
+        std::cout << "[PASSED] churn test " << std::endl;
+    } else {
+        std::cout << "churn test failed" << std::endl;
+    }
+}
+
+void test_strings() {
+    std::cout << "make an empty swiss table for strings" << std::endl;
+    SwissHashTable<std::string> table;
+    table.insert("And them who hold High Places");
+    table.insert("Must be the ones to start");
+    table.insert("To mold a new Reality");
+    table.insert("Closer to the Heart");
+    table.insert("Closer to the Heart");
+
+    std::stringstream ss;
+    table.print_table(ss);
+    if (table.size() == 4 && ss.str().find("To mold a new Reality") != std::string::npos &&
+        !table.contains("Closer to the Start")) {
+        std::cout << "[PASSED] strings test " << std::endl;
+    } else {
+        std::cout << "strings test failed" << std::endl;
+    }
+
+    table.make_empty();
+    std::stringstream empty;
+    table.print_table(empty);
+    if (empty.str() == "<empty>\n") {
+        std::cout << "[PASSED] print empty table test " << std::endl;
+    } else {
+        std::cout << "print empty table test failed" << std::endl;
+    }
+}
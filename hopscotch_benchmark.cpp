@@ -0,0 +1,129 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hashtable_hopscotch.h"
+#include "hashtable_open_addressing.h"
+
+using open_addressing::HashTable;
+
+// Compares the linear probe of the open addressing table against hopscotch
+// hashing as the load factor rises. A linear probe miss scans up to the
+// next empty cell, which gets far away at high load, while a hopscotch
+// lookup only compares the cells its home cell's bitmap names. Both tables
+// are given the same number of cells and filled without growing.
+//
+// The second part measures lookup throughput from 1 up to 16 threads
+// sharing one prebuilt table. The threads only call the const position(),
+// which reads the cells and writes nothing, so lookups should scale with
+// the cores. A hopscotch lookup reads the home cell's bitmap and the cells
+// it names, all within one neighborhood. A linear probe reads a run of
+// cells that grows with the load.
+
+using Clock = std::chrono::steady_clock;
+
+template<class Table>
+void run(const char *name, float load, const std::vector<std::string> &present,
+         const std::vector<std::string> &missing) {
+    size_t keys = (size_t) ((float) present.size() * load);
+    Table table(present.size() + 1);
+    table.max_load_factor(0.99f);
+    size_t found = 0;
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < keys; i++) {
+        table.insert(present[i]);
+    }
+    auto inserted = Clock::now();
+    for (size_t i = 0; i < keys; i++) {
+        found += table.contains(present[i]);
+    }
+    auto hit = Clock::now();
+    for (size_t i = 0; i < keys; i++) {
+        found += table.contains(missing[i]);
+    }
+    auto miss = Clock::now();
+
+    auto per_key = [&](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::nano>(to - from).count() / (double) keys;
+    };
+    std::cout << name << "," << keys << "," << table.load_factor() << "," << per_key(start, inserted) << ","
+              << per_key(inserted, hit) << "," << per_key(hit, miss) << std::endl;
+
+    if (found != keys) {
+        std::cout << name << " returned wrong lookups" << std::endl;
+    }
+}
+
+template<class Table>
+void run_readers(const char *name, float load, unsigned threads, size_t lookups,
+                 const std::vector<std::string> &present, const std::vector<std::string> &missing) {
+    size_t keys = (size_t) ((float) present.size() * load);
+    Table filled(present.size() + 1);
+    filled.max_load_factor(0.99f);
+    for (size_t i = 0; i < keys; i++) {
+        filled.insert(present[i]);
+    }
+    const Table &table = filled;
+
+    // Every thread looks up present and missing keys in turn
+    std::vector<std::thread> readers;
+    std::vector<size_t> found(threads, 0);
+    auto start = Clock::now();
+    for (unsigned t = 0; t < threads; t++) {
+        readers.emplace_back([&, t]() {
+            size_t hits = 0;
+            for (size_t i = t; i < lookups; i += threads) {
+                const std::string &key = i & 1 ? missing[i / 2 % keys] : present[i / 2 % keys];
+                hits += table.position(key) < table.table_size();
+            }
+            found[t] = hits;
+        });
+    }
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    size_t hits = 0;
+    for (size_t h : found) {
+        hits += h;
+    }
+    std::cout << name << "," << threads << "," << table.load_factor() << "," << (double) lookups / seconds / 1e6
+              << std::endl;
+
+    if (hits != (lookups + 1) / 2) {
+        std::cout << name << " returned wrong lookups" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t NUMBER_OF_CELLS = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t LOOKUPS = argc > 2 ? std::stoul(argv[2]) : 16000000;
+    const unsigned MAX_THREADS = argc > 3 ? std::stoul(argv[3]) : 16;
+
+    std::vector<std::string> present, missing;
+    present.reserve(NUMBER_OF_CELLS);
+    missing.reserve(NUMBER_OF_CELLS);
+    for (size_t i = 0; i < NUMBER_OF_CELLS; i++) {
+        present.push_back("/api/v1/session/" + std::to_string(i * 2));
+        missing.push_back("/api/v1/session/" + std::to_string(i * 2 + 1));
+    }
+
+    std::cout << "table,keys,load_factor,insert_ns,hit_ns,miss_ns" << std::endl;
+    for (float load : {0.5f, 0.7f, 0.8f, 0.9f}) {
+        run<HashTable<std::string>>("linear_probe", load, present, missing);
+        run<HopscotchHashTable<std::string>>("hopscotch", load, present, missing);
+    }
+
+    std::cout << "hardware threads " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "table,threads,load_factor,mlookups_per_s" << std::endl;
+    for (float load : {0.5f, 0.9f}) {
+        for (unsigned threads = 1; threads <= MAX_THREADS; threads *= 2) {
+            run_readers<HashTable<std::string>>("linear_probe", load, threads, LOOKUPS, present, missing);
+            run_readers<HopscotchHashTable<std::string>>("hopscotch", load, threads, LOOKUPS, present, missing);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef SEPARATE_CHAINING
+#include "hashtable_separate_chaining.h"
+using separate_chaining::HashTable;
+#else
+#include "hashtable_open_addressing.h"
+using open_addressing::HashTable;
+#endif
+
+// Times every single insert into a growing table, once with the usual
+// rehash that moves all values when the table grows and once with the
+// incremental rehash that spreads the move over the following operations.
+// Compile with -DSEPARATE_CHAINING to measure the separate chaining table.
+
+using Clock = std::chrono::steady_clock;
+
+void run(const char *name, bool incremental, size_t number_of_keys) {
+    std::vector<double> latencies;
+    latencies.reserve(number_of_keys);
+
+    HashTable<int> table;
+    table.incremental_rehash(incremental);
+    for (size_t i = 0; i < number_of_keys; i++) {
+        auto start = Clock::now();
+        table.insert((int) i);
+        auto end = Clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    double total = 0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[std::min(latencies.size() - 1, (size_t) (p * (double) latencies.size()))];
+    };
+
+    std::cout << name << "," << incremental << "," << number_of_keys << "," << total / (double) number_of_keys
+              << "," << percentile(0.5) << "," << percentile(0.9999) << "," << latencies.back() << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 1000000;
+#ifdef SEPARATE_CHAINING
+    const char *name = "separate_chaining";
+#else
+    const char *name = "open_addressing";
+#endif
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+
+    std::cout << "table,incremental,keys,mean_ns,p50_ns,p9999_ns,max_ns" << std::endl;
+    run(name, false, NUMBER_OF_KEYS);
+    run(name, true, NUMBER_OF_KEYS);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include "hashtable_loader.h"
+#ifdef SEPARATE_CHAINING
+#include "hashtable_separate_chaining.h"
+using separate_chaining::HashTable;
+#else
+#include "hashtable_open_addressing.h"
+using open_addressing::HashTable;
+#endif
+
+// Loads a file of newline separated string keys into the table, first with
+// one getline and insert per line, then with load_keys without presizing,
+// with presizing and with a second thread hashing the batches, and reports
+// the keys loaded per second for each. Pass the number of keys to write to
+// a temporary file as the first argument, or the path of a key file to
+// load as the second. Compile with -DSEPARATE_CHAINING to measure the
+// separate chaining table.
+
+using Clock = std::chrono::steady_clock;
+using Table = HashTable<std::string, StringHash>;
+
+void report(const char *name, const char *method, const LoadStats &stats, size_t size) {
+    std::cout << name << "," << method << "," << stats.lines << "," << stats.bytes << "," << stats.seconds << ","
+              << stats.keys_per_second() << "," << size << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 4000000;
+#ifdef SEPARATE_CHAINING
+    const char *name = "separate_chaining";
+#else
+    const char *name = "open_addressing";
+#endif
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+    const bool GIVEN_FILE = argc > 2;
+    const std::string PATH = GIVEN_FILE ? argv[2] : "loader_benchmark_keys.tmp";
+
+    if (!GIVEN_FILE) {
+        std::mt19937_64 random(1);
+        std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+        for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+            out << "user:" << random() % (NUMBER_OF_KEYS * 4) << ":" << i << "\n";
+        }
+    }
+
+    std::cout << "table,method,keys,bytes,seconds,keys_per_s,size" << std::endl;
+    {
+        Table table;
+        LoadStats stats;
+        auto start = Clock::now();
+        std::ifstream in(PATH, std::ios::binary);
+        std::string line;
+        while (std::getline(in, line)) {
+            stats.lines++;
+            stats.bytes += line.size() + 1;
+            stats.inserted += table.insert(line);
+        }
+        stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        report(name, "getline", stats, table.size());
+    }
+
+    LoadOptions options;
+    options.presize = false;
+    {
+        Table table;
+        LoadStats stats = load_keys(table, PATH, options);
+        report(name, "load_keys", stats, table.size());
+    }
+    options.presize = true;
+    {
+        Table table;
+        LoadStats stats = load_keys(table, PATH, options);
+        report(name, "load_keys_presized", stats, table.size());
+    }
+    options.hash_thread = true;
+    {
+        Table table;
+        LoadStats stats = load_keys(table, PATH, options);
+        report(name, "load_keys_hash_thread", stats, table.size());
+    }
+
+    if (!GIVEN_FILE) {
+        std::remove(PATH.c_str());
+    }
+    return 0;
+}
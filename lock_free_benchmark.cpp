@@ -0,0 +1,64 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hashtable_concurrent_chaining.h"
+#include "hashtable_lock_free.h"
+
+// Throughput of lookups only, from 1 up to 64 threads, on a table filled
+// beforehand and never written during a run. Half the keys looked up are
+// present. The lock free table is compared with the lock striped table,
+// whose lookups take a shared lock on the stripe of the key. Lookups that
+// contend for a cache line stop scaling with the number of threads.
+
+using Clock = std::chrono::steady_clock;
+
+template<class Table>
+void run(const char *name, size_t number_of_keys, size_t operations, unsigned threads) {
+    Table table(number_of_keys * 4);
+    for (size_t i = 0; i < number_of_keys; i++) {
+        table.insert((int) (i * 2));
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<size_t> found(threads, 0);
+    auto start = Clock::now();
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::mt19937_64 random(t + 1);
+            std::uniform_int_distribution<int> keys(0, (int) (number_of_keys * 2 - 1));
+            size_t hits = 0;
+            for (size_t i = t; i < operations; i += threads) {
+                hits += table.contains(keys(random));
+            }
+            found[t] = hits;
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    size_t hits = 0;
+    for (size_t h : found) {
+        hits += h;
+    }
+    std::cout << name << "," << threads << "," << operations << "," << (double) operations / seconds / 1e6
+              << "," << (double) hits / (double) operations << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t OPERATIONS = argc > 2 ? std::stoul(argv[2]) : 16000000;
+    const unsigned MAX_THREADS = argc > 3 ? std::stoul(argv[3]) : 64;
+
+    std::cout << "hardware threads " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "table,threads,operations,mops_per_s,hit_rate" << std::endl;
+    for (unsigned threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        run<LockFreeHashTable<int>>("lock_free", NUMBER_OF_KEYS, OPERATIONS, threads);
+        run<ConcurrentHashTable<int>>("lock_striped", NUMBER_OF_KEYS, OPERATIONS, threads);
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "hashtable_open_addressing.h"
+
+using open_addressing::HashTable;
+
+// Keeps a fixed number of live keys in the table while removing and
+// inserting keys, and reports the time per operation and the lookup
+// latency after every round so that the effect of the deleted cells on the
+// probe sequences can be seen. The sparse table starts with four cells per
+// key; the full one starts just below the maximum load factor, where the
+// deleted cells make it rebuild or grow.
+
+using Clock = std::chrono::steady_clock;
+
+double time_lookups(HashTable<int> &table, const std::vector<int> &keys, size_t &found) {
+    auto start = Clock::now();
+    for (int key : keys) {
+        found += table.contains(key);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start);
+    return elapsed.count() / (double) keys.size();
+}
+
+bool churn(const char *name, size_t cells, size_t live_keys, size_t number_of_rounds) {
+    const size_t OPERATIONS_PER_ROUND = 500000;
+    const size_t LOOKUPS_PER_ROUND = 200000;
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<size_t> pick(0, live_keys - 1);
+
+    HashTable<int> table(cells);
+    std::vector<int> live;
+    live.reserve(live_keys);
+
+    // Even keys are inserted, odd keys are only used for misses
+    int next_key = 0;
+    while (live.size() < live_keys) {
+        table.insert(next_key);
+        live.push_back(next_key);
+        next_key += 2;
+    }
+
+    size_t found = 0;
+    for (size_t round = 0; round <= number_of_rounds; round++) {
+        double op_ns = 0;
+        if (round > 0) {
+            auto start = Clock::now();
+            for (size_t op = 0; op < OPERATIONS_PER_ROUND; op += 2) {
+                size_t victim = pick(generator);
+                table.remove(live[victim]);
+                table.insert(next_key);
+                live[victim] = next_key;
+                next_key += 2;
+            }
+            op_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                    (double) OPERATIONS_PER_ROUND;
+        }
+
+        std::vector<int> hits, misses;
+        hits.reserve(LOOKUPS_PER_ROUND);
+        misses.reserve(LOOKUPS_PER_ROUND);
+        for (size_t i = 0; i < LOOKUPS_PER_ROUND; i++) {
+            hits.push_back(live[pick(generator)]);
+            misses.push_back(live[pick(generator)] + 1);
+        }
+
+        double hit_ns = time_lookups(table, hits, found);
+        double miss_ns = time_lookups(table, misses, found);
+        std::cout << name << "," << round << "," << round * OPERATIONS_PER_ROUND << "," << table.table_size() << ","
+                  << op_ns << "," << hit_ns << "," << miss_ns << std::endl;
+    }
+
+    if (found != (number_of_rounds + 1) * LOOKUPS_PER_ROUND || table.size() != live_keys) {
+        std::cout << "churn benchmark lost values" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t LIVE_KEYS = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t NUMBER_OF_ROUNDS = argc > 2 ? std::stoul(argv[2]) : 20;
+    const float FULL_LOAD = 0.48f;
+
+    std::cout << "table,round,operations,table_size,op_ns,hit_ns,miss_ns" << std::endl;
+    bool sparse = churn("sparse", 4 * LIVE_KEYS + 1, LIVE_KEYS, NUMBER_OF_ROUNDS);
+    bool full = churn("full", (size_t) ((float) LIVE_KEYS / FULL_LOAD), LIVE_KEYS, NUMBER_OF_ROUNDS);
+    return sparse && full ? 0 : 1;
+}
@@ -1,6 +1,8 @@
 #include <iostream>
 #include "hashtable_open_addressing.h"
 
+using open_addressing::HashTable;
+
 class Hashable {
     std::string str;
     int i;
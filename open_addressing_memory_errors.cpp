@@ -1,6 +1,8 @@
 #include <iostream>
 #include "hashtable_open_addressing.h"
 
+using open_addressing::HashTable;
+
 int main() {
     std::cout << "make a hash table" << std::endl;
     HashTable<int> table;
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef SEPARATE_CHAINING
+#include "hashtable_separate_chaining.h"
+using separate_chaining::HashTable;
+#else
+#include "hashtable_open_addressing.h"
+using open_addressing::HashTable;
+#endif
+
+// Compares filling a table with insert() in a loop against build() from the
+// same keys with 1, 2, 4, ... threads, up to one per hardware thread. Pass
+// the number of keys as the first argument, e.g. 100000000 for the large
+// run. Compile with -DSEPARATE_CHAINING to measure the separate chaining
+// table.
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 4000000;
+#ifdef SEPARATE_CHAINING
+    const char *name = "separate_chaining";
+#else
+    const char *name = "open_addressing";
+#endif
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+    const size_t MAX_THREADS = thread_count(0);
+
+    std::vector<long> keys(NUMBER_OF_KEYS);
+    std::mt19937_64 random(1);
+    for (auto &key : keys) {
+        key = (long) (random() >> 1);
+    }
+
+    auto seconds = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double>(to - from).count();
+    };
+
+    double insert_seconds;
+    size_t expected;
+    {
+        HashTable<long> table;
+        auto start = Clock::now();
+        for (long key : keys) {
+            table.insert(key);
+        }
+        insert_seconds = seconds(start, Clock::now());
+        expected = table.size();
+    }
+
+    std::cout << "table,keys,threads,seconds,million_keys_per_s,speedup_over_insert" << std::endl;
+    std::cout << name << "," << NUMBER_OF_KEYS << ",insert," << insert_seconds << ","
+              << (double) NUMBER_OF_KEYS / insert_seconds / 1e6 << ",1" << std::endl;
+    for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        HashTable<long> table;
+        auto start = Clock::now();
+        table.build(keys.begin(), keys.end(), threads);
+        double build_seconds = seconds(start, Clock::now());
+        std::cout << name << "," << NUMBER_OF_KEYS << "," << threads << "," << build_seconds << ","
+                  << (double) NUMBER_OF_KEYS / build_seconds / 1e6 << "," << insert_seconds / build_seconds
+                  << std::endl;
+        if (table.size() != expected) {
+            std::cout << name << " built the wrong number of keys" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+#ifdef SEPARATE_CHAINING
+#include "hashtable_separate_chaining.h"
+using separate_chaining::HashTable;
+#else
+#include "hashtable_open_addressing.h"
+using open_addressing::HashTable;
+#endif
+
+// Times rehash(count, num_threads) doubling a full table with 1, 2, 4, ...
+// threads, up to one per hardware thread, and reports the memory moved per
+// second: the old and new cells for open addressing, the old and new bucket
+// arrays and every node for separate chaining. Pass the number of keys as
+// the first argument. Compile with -DSEPARATE_CHAINING to measure the
+// separate chaining table.
+
+using Clock = std::chrono::steady_clock;
+using Table = HashTable<long>;
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 4000000;
+#ifdef SEPARATE_CHAINING
+    const char *name = "separate_chaining";
+    // A list node holds the value and two links
+    const size_t BYTES_PER_KEY = sizeof(long) + 2 * sizeof(void *);
+    const size_t BYTES_PER_SLOT = sizeof(Table::bucket_type);
+#else
+    const char *name = "open_addressing";
+    const size_t BYTES_PER_KEY = 0;
+    const size_t BYTES_PER_SLOT = sizeof(Table::cell_type);
+#endif
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+    const size_t MAX_THREADS = thread_count(0);
+
+    std::vector<long> keys(NUMBER_OF_KEYS);
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        keys[i] = (long) i * 7;
+    }
+
+    std::cout << "table,keys,threads,old_slots,new_slots,seconds,gb_per_s" << std::endl;
+    for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        Table table;
+        table.build(keys.begin(), keys.end(), threads);
+#ifdef SEPARATE_CHAINING
+        size_t old_slots = table.bucket_count();
+#else
+        size_t old_slots = table.table_size();
+#endif
+        auto start = Clock::now();
+        table.rehash(2 * old_slots, threads);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+#ifdef SEPARATE_CHAINING
+        size_t new_slots = table.bucket_count();
+#else
+        size_t new_slots = table.table_size();
+#endif
+
+        double bytes = (double) ((old_slots + new_slots) * BYTES_PER_SLOT + NUMBER_OF_KEYS * BYTES_PER_KEY);
+        std::cout << name << "," << NUMBER_OF_KEYS << "," << threads << "," << old_slots << "," << new_slots << ","
+                  << seconds << "," << bytes / seconds / 1e9 << std::endl;
+        if (table.size() != NUMBER_OF_KEYS) {
+            std::cout << name << " lost values in the rehash" << std::endl;
+        }
+    }
+    return 0;
+}
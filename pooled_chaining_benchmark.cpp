@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "hashtable_pooled_chaining.h"
+
+// Compares chaining with one heap allocation per node, as std::unordered_set
+// does, against the pooled nodes of PooledHashTable: inserts, lookups, a
+// round of removes and inserts, and freeing the whole table, together with
+// the number of heap allocations made.
+
+static size_t allocations = 0;
+
+void *operator new(std::size_t size) {
+    allocations++;
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+using Clock = std::chrono::steady_clock;
+
+template<class Table, class Remove, class Clear>
+void run(const char *name, const std::vector<uint64_t> &keys, Remove remove, Clear clear) {
+    size_t before = allocations;
+    size_t found = 0;
+    Clock::time_point start, inserted, looked_up, churned;
+    {
+        start = Clock::now();
+        Table table(keys.size());
+        for (size_t i = 0; i < keys.size() / 2; i++) {
+            table.insert(keys[i]);
+        }
+        inserted = Clock::now();
+
+        for (size_t i = 0; i < keys.size() / 2; i++) {
+            found += table.count(keys[i]);
+        }
+        looked_up = Clock::now();
+
+        // Churn: every removed node can be reused by the next insert
+        for (size_t i = 0; i < keys.size() / 2; i++) {
+            remove(table, keys[i]);
+            table.insert(keys[i + keys.size() / 2]);
+        }
+        churned = Clock::now();
+
+        clear(table);
+    }
+    auto cleared = Clock::now();
+
+    double n = (double) (keys.size() / 2);
+    auto per_key = [&](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::nano>(to - from).count() / n;
+    };
+    std::cout << name << "," << keys.size() / 2 << "," << per_key(start, inserted) << ","
+              << per_key(inserted, looked_up) << "," << per_key(looked_up, churned) << ","
+              << per_key(churned, cleared) << "," << (double) (allocations - before) / n << std::endl;
+
+    if (found != keys.size() / 2) {
+        std::cout << name << " returned wrong lookups" << std::endl;
+    }
+}
+
+// The pooled table under the names std::unordered_set uses
+template<class Key>
+struct PooledSet : PooledHashTable<Key> {
+    explicit PooledSet(size_t buckets) : PooledHashTable<Key>(buckets) {}
+
+    size_t count(const Key &key) {
+        return this->contains(key);
+    }
+};
+
+int main(int argc, char *argv[]) {
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : 2000000;
+
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < 2 * NUMBER_OF_KEYS; i++) {
+        keys.push_back(i * 0x9E3779B97F4A7C15ULL);
+    }
+
+    std::cout << "table,keys,insert_ns,hit_ns,churn_ns,free_ns,allocations_per_key" << std::endl;
+    run<std::unordered_set<uint64_t>>("node_per_allocation", keys,
+                                      [](std::unordered_set<uint64_t> &table, uint64_t key) { table.erase(key); },
+                                      [](std::unordered_set<uint64_t> &table) { table.clear(); });
+    run<PooledSet<uint64_t>>("pooled", keys,
+                             [](PooledSet<uint64_t> &table, uint64_t key) { table.remove(key); },
+                             [](PooledSet<uint64_t> &table) { table.make_empty(); });
+    return 0;
+}
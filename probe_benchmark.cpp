@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "hashtable_open_addressing.h"
+
+using open_addressing::HashTable;
+
+// Compares the probe policies of the open addressing table on integer and
+// string keys, with both capacity policies, at load factors up to 0.5, the
+// highest every policy supports. Quadratic probing reaches too few cells
+// of a power of two table to be used with one, so it runs on prime tables
+// only. Integers are sequential, the keys the
+// identity std::hash lines up into long runs; strings are hashed well.
+// Each table is given its cells up front and filled without growing.
+
+using Clock = std::chrono::steady_clock;
+
+template<class Table, class Key>
+void run(const char *probe, const char *capacity, const char *key_name, float load, const std::vector<Key> &present,
+         const std::vector<Key> &missing) {
+    size_t keys = (size_t) ((float) present.size() * load);
+    Table table(present.size() + 1);
+    size_t found = 0;
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < keys; i++) {
+        table.insert(present[i]);
+    }
+    auto inserted = Clock::now();
+    for (size_t i = 0; i < keys; i++) {
+        found += table.contains(present[i]);
+    }
+    auto hit = Clock::now();
+    for (size_t i = 0; i < keys; i++) {
+        found += table.contains(missing[i]);
+    }
+    auto miss = Clock::now();
+
+    auto per_key = [&](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::nano>(to - from).count() / (double) keys;
+    };
+    std::cout << probe << "," << capacity << "," << key_name << "," << keys << "," << table.load_factor() << ","
+              << per_key(start, inserted) << "," << per_key(inserted, hit) << "," << per_key(hit, miss) << std::endl;
+
+    if (found != keys) {
+        std::cout << probe << " returned wrong lookups" << std::endl;
+    }
+}
+
+template<class Probe, class Key>
+void run_probe(const char *probe, const char *key_name, const std::vector<Key> &present,
+               const std::vector<Key> &missing) {
+    for (float load : {0.25f, 0.4f, 0.5f}) {
+        run<HashTable<Key, std::hash<Key>, PrimeCapacity, false, Probe>>(probe, "prime", key_name, load, present,
+                                                                         missing);
+        if constexpr (Probe::template max_load_factor<PowerOfTwoCapacity>() > 0.0f) {
+            run<HashTable<Key, std::hash<Key>, PowerOfTwoCapacity, false, Probe>>(probe, "power_of_two", key_name,
+                                                                                  load, present, missing);
+        }
+    }
+}
+
+template<class Key>
+void run_all(const char *key_name, const std::vector<Key> &present, const std::vector<Key> &missing) {
+    run_probe<LinearProbe>("linear", key_name, present, missing);
+    run_probe<QuadraticProbe>("quadratic", key_name, present, missing);
+    run_probe<TriangularProbe>("triangular", key_name, present, missing);
+    run_probe<DoubleHashProbe>("double_hash", key_name, present, missing);
+}
+
+int main(int argc, char *argv[]) {
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : 200000;
+
+    // Missing integers are drawn at random, so that they land inside the
+    // runs of sequential keys as well as outside them
+    std::mt19937_64 random(1);
+    std::vector<std::int64_t> integers, missing_integers;
+    std::vector<std::string> strings, missing_strings;
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        integers.push_back((std::int64_t) i);
+        missing_integers.push_back((std::int64_t) (NUMBER_OF_KEYS + random() % (1ULL << 40)));
+        strings.push_back("/api/v1/session/" + std::to_string(i * 2));
+        missing_strings.push_back("/api/v1/session/" + std::to_string(i * 2 + 1));
+    }
+
+    std::cout << "probe,capacity,key,keys,load_factor,insert_ns,hit_ns,miss_ns" << std::endl;
+    run_all("sequential_int", integers, missing_integers);
+    run_all("string", strings, missing_strings);
+    return 0;
+}
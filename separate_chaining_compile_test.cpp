@@ -1,6 +1,8 @@
 #include <iostream>
 #include "hashtable_separate_chaining.h"
 
+using separate_chaining::HashTable;
+
 class Hashable {
     std::string str;
     int i;
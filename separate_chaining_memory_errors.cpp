@@ -1,6 +1,8 @@
 #include <iostream>
 #include "hashtable_separate_chaining.h"
 
+using separate_chaining::HashTable;
+
 int main() {
     std::cout << "make a hash table" << std::endl;
     HashTable<int> table;
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "hashtable_open_addressing.h"
+
+using open_addressing::HashTable;
+
+// Compares the two ways of getting a table back at startup: building it
+// again from its keys, and opening a snapshot written by save with
+// open_mapped. Reports the seconds to a table that answers lookups, and
+// then the time of the first lookups on each, which for the mapped table
+// includes reading in the pages they touch. Pass the number of keys as the
+// first argument and the snapshot path as the second.
+
+using Clock = std::chrono::steady_clock;
+using Table = HashTable<long>;
+
+template<class Lookup>
+void time_lookups(const char *name, size_t n, const std::vector<long> &probes, Lookup lookup) {
+    auto start = Clock::now();
+    size_t found = 0;
+    for (long key : probes) {
+        found += lookup(key);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    std::cout << name << "," << n << ",lookup_ns," << ns / (double) probes.size() << "," << found << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 4000000;
+    const size_t NUMBER_OF_LOOKUPS = 1000000;
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+    const std::string PATH = argc > 2 ? argv[2] : "snapshot_benchmark.tmp";
+
+    std::vector<long> keys(NUMBER_OF_KEYS);
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        keys[i] = (long) i * 7;
+    }
+    std::mt19937_64 random(1);
+    std::vector<long> probes(NUMBER_OF_LOOKUPS);
+    for (long &key : probes) {
+        key = (long) (random() % (NUMBER_OF_KEYS * 7));
+    }
+
+    std::cout << "table,keys,measure,value,result" << std::endl;
+    auto start = Clock::now();
+    Table table;
+    for (long key : keys) {
+        table.insert(key);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "rebuilt," << NUMBER_OF_KEYS << ",open_seconds," << seconds << "," << table.size() << std::endl;
+
+    start = Clock::now();
+    table.save(PATH);
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "saved," << NUMBER_OF_KEYS << ",save_seconds," << seconds << "," << table.table_size() << std::endl;
+
+    start = Clock::now();
+    auto mapped = Table::open_mapped(PATH);
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "mapped," << NUMBER_OF_KEYS << ",open_seconds," << seconds << "," << mapped.size() << std::endl;
+
+    time_lookups("mapped", NUMBER_OF_KEYS, probes, [&](long key) { return mapped.contains(key); });
+    time_lookups("mapped", NUMBER_OF_KEYS, probes, [&](long key) { return mapped.contains(key); });
+    time_lookups("rebuilt", NUMBER_OF_KEYS, probes, [&](long key) { return table.contains(key); });
+
+    std::remove(PATH.c_str());
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef SEPARATE_CHAINING
+#include "hashtable_separate_chaining.h"
+using separate_chaining::HashTable;
+#else
+#include "hashtable_open_addressing.h"
+using open_addressing::HashTable;
+#endif
+
+// Compares a table that stores the hash code of every key with one that
+// does not, on long string keys sharing a common prefix so that every key
+// comparison walks most of both strings. Times inserts, lookups that hit,
+// lookups that miss and a rehash to four times the size.
+// Compile with -DSEPARATE_CHAINING to measure the separate chaining table.
+
+using Clock = std::chrono::steady_clock;
+
+template<class Table>
+void run(const char *name, bool stored, size_t buckets, const std::vector<std::string> &present,
+         const std::vector<std::string> &missing) {
+    Table table(buckets);
+    size_t found = 0;
+
+    auto start = Clock::now();
+    for (const auto &key : present) {
+        table.insert(key);
+    }
+    auto inserted = Clock::now();
+    for (const auto &key : present) {
+        found += table.contains(key);
+    }
+    auto hit = Clock::now();
+    for (const auto &key : missing) {
+        found += table.contains(key);
+    }
+    auto miss = Clock::now();
+    table.rehash(4 * buckets);
+    auto rehashed = Clock::now();
+
+    auto per_key = [&](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::nano>(to - from).count() / (double) present.size();
+    };
+    std::cout << name << "," << stored << "," << present.size() << "," << per_key(start, inserted) << ","
+              << per_key(inserted, hit) << "," << per_key(hit, miss) << "," << per_key(miss, rehashed) << std::endl;
+
+    if (found != present.size()) {
+        std::cout << name << " returned wrong lookups" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t DEFAULT_KEYS = 500000;
+#ifdef SEPARATE_CHAINING
+    const char *name = "separate_chaining";
+#else
+    const char *name = "open_addressing";
+#endif
+    const size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+    const std::string PREFIX = "https://example.com/api/v1/organizations/default/projects/main/sessions/";
+
+    std::vector<std::string> present, missing;
+    for (size_t i = 0; i < NUMBER_OF_KEYS; i++) {
+        present.push_back(PREFIX + std::to_string(i * 2));
+        missing.push_back(PREFIX + std::to_string(i * 2 + 1));
+    }
+
+    // Both tables are sized up front so that the rehash is the only one
+    std::cout << "table,stored_hash,keys,insert_ns,hit_ns,miss_ns,rehash_ns" << std::endl;
+    run<HashTable<std::string>>(name, false, 2 * NUMBER_OF_KEYS + 1, present, missing);
+    run<HashTable<std::string, std::hash<std::string>, PrimeCapacity, true>>(name, true, 2 * NUMBER_OF_KEYS + 1,
+                                                                           present, missing);
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "hashtable_open_addressing.h"
+#include "hashtable_separate_chaining.h"
+
+// Runs the open addressing and separate chaining tables side by side with
+// std::unordered_set, all with their default hash and sizing. Every table
+// is filled from empty and then measured on lookups that hit, lookups that
+// miss, a mixed workload and removing every key, for int, string and
+// struct keys. The keys the lookups and the mixed workload touch are drawn
+// in sequence, uniformly or from a Zipfian distribution over the inserted
+// keys. Prints one CSV line per measurement. Pass the number of keys as the
+// first argument.
+//
+//   table,key,distribution,operation,keys,operations,ns_per_op,result
+//
+// result counts the successful operations, so the runs can be checked
+// against each other.
+
+using Clock = std::chrono::steady_clock;
+
+// A small record hashed by all of its fields
+struct Record {
+    std::int32_t id;
+    std::int32_t group;
+    std::int64_t stamp;
+
+    bool operator==(const Record &other) const {
+        return id == other.id && group == other.group && stamp == other.stamp;
+    }
+};
+
+template<>
+struct std::hash<Record> {
+    std::size_t operator()(const Record &record) const noexcept {
+        std::size_t h = std::hash<std::int64_t>{}(record.stamp);
+        h ^= std::hash<std::int32_t>{}(record.id) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h ^= std::hash<std::int32_t>{}(record.group) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+// Key number i, distinct for distinct i
+template<class Key>
+Key make_key(std::size_t i);
+
+template<>
+int make_key<int>(std::size_t i) {
+    return (int) i;
+}
+
+template<>
+std::string make_key<std::string>(std::size_t i) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "user:%012zu", i);
+    return buffer;
+}
+
+template<>
+Record make_key<Record>(std::size_t i) {
+    return Record{(std::int32_t) i, (std::int32_t) (i % 97), (std::int64_t) i * 1000003};
+}
+
+// The tables spell lookups and removes differently from std::unordered_set
+template<class Table, class Key>
+bool lookup(Table &table, const Key &key) {
+    return table.contains(key);
+}
+
+template<class Key>
+bool lookup(std::unordered_set<Key> &table, const Key &key) {
+    return table.count(key) != 0;
+}
+
+template<class Table, class Key>
+bool add(Table &table, const Key &key) {
+    return table.insert(key);
+}
+
+template<class Key>
+bool add(std::unordered_set<Key> &table, const Key &key) {
+    return table.insert(key).second;
+}
+
+template<class Table, class Key>
+bool erase(Table &table, const Key &key) {
+    return table.remove(key) != 0;
+}
+
+template<class Key>
+bool erase(std::unordered_set<Key> &table, const Key &key) {
+    return table.erase(key) != 0;
+}
+
+//-------------------------------------------------------
+// Name: draws
+// PreCondition:  n is greater than zero
+// PostCondition: returns count numbers in [0, n): 0, 1, 2, ... for
+// sequential, uniformly random for uniform, and Zipfian
+// with exponent 0.99 for zipfian, where the most
+// frequent numbers are scattered over [0, n).
+//---------------------------------------------------------
+std::vector<std::size_t> draws(const std::string &distribution, std::size_t n, std::size_t count,
+                               std::mt19937_64 &random) {
+    std::vector<std::size_t> result(count);
+    if (distribution == "sequential") {
+        for (std::size_t i = 0; i < count; i++) {
+            result[i] = i % n;
+        }
+    } else if (distribution == "uniform") {
+        std::uniform_int_distribution<std::size_t> uniform(0, n - 1);
+        for (auto &x : result) {
+            x = uniform(random);
+        }
+    } else {
+        const double EXPONENT = 0.99;
+        std::vector<double> cumulative(n);
+        double total = 0;
+        for (std::size_t rank = 0; rank < n; rank++) {
+            total += 1.0 / std::pow((double) (rank + 1), EXPONENT);
+            cumulative[rank] = total;
+        }
+        std::vector<std::size_t> scatter(n);
+        for (std::size_t i = 0; i < n; i++) {
+            scatter[i] = i;
+        }
+        std::shuffle(scatter.begin(), scatter.end(), random);
+
+        std::uniform_real_distribution<double> uniform(0, total);
+        for (auto &x : result) {
+            auto rank = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(random)) - cumulative.begin();
+            x = scatter[std::min((std::size_t) rank, n - 1)];
+        }
+    }
+    return result;
+}
+
+template<class Key>
+struct Workload {
+    const char *key_name;
+    std::string distribution;
+    // keys[i] for i < n are inserted, the rest never are
+    std::vector<Key> keys;
+    std::size_t n;
+    // Order of the inserts, a permutation of [0, n)
+    std::vector<std::size_t> insert_order;
+    // Keys touched by the lookups and the mixed operations, in [0, n)
+    std::vector<std::size_t> accesses;
+};
+
+template<class Table, class Key>
+void run(const char *table_name, const Workload<Key> &work) {
+    const std::size_t n = work.n;
+    Table table;
+
+    auto report = [&](const char *operation, Clock::time_point start, std::size_t operations, std::size_t result) {
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::cout << table_name << "," << work.key_name << "," << work.distribution << "," << operation << "," << n
+                  << "," << operations << "," << ns / (double) operations << "," << result << std::endl;
+    };
+
+    auto start = Clock::now();
+    std::size_t result = 0;
+    for (std::size_t i : work.insert_order) {
+        result += add(table, work.keys[i]);
+    }
+    report("insert", start, n, result);
+
+    start = Clock::now();
+    result = 0;
+    for (std::size_t i : work.accesses) {
+        result += lookup(table, work.keys[i]);
+    }
+    report("lookup_hit", start, work.accesses.size(), result);
+
+    start = Clock::now();
+    result = 0;
+    for (std::size_t i : work.accesses) {
+        result += lookup(table, work.keys[i + n]);
+    }
+    report("lookup_miss", start, work.accesses.size(), result);
+
+    // Half lookups, a quarter inserts of new keys and a quarter removes of
+    // the same new keys, so the size stays about the same
+    start = Clock::now();
+    result = 0;
+    for (std::size_t k = 0; k < work.accesses.size(); k++) {
+        std::size_t i = work.accesses[k];
+        switch (k % 4) {
+            case 0:
+            case 2:
+                result += lookup(table, work.keys[i]);
+                break;
+            case 1:
+                result += add(table, work.keys[i + n]);
+                break;
+            default:
+                result += erase(table, work.keys[work.accesses[k - 2] + n]);
+                break;
+        }
+    }
+    report("mixed", start, work.accesses.size(), result);
+
+    // Every key is removed once, in the order it was inserted. Removing
+    // keys that are already gone would mostly time the probes over the
+    // deleted cells, which lookup_miss measures already
+    start = Clock::now();
+    result = 0;
+    for (std::size_t i : work.insert_order) {
+        result += erase(table, work.keys[i]);
+    }
+    report("remove", start, n, result);
+}
+
+template<class Key>
+void run_key(const char *key_name, std::size_t n, std::mt19937_64 &random) {
+    Workload<Key> work;
+    work.key_name = key_name;
+    work.n = n;
+    for (std::size_t i = 0; i < 2 * n; i++) {
+        work.keys.push_back(make_key<Key>(i));
+    }
+
+    for (const char *distribution : {"sequential", "uniform", "zipfian"}) {
+        work.distribution = distribution;
+        work.insert_order = draws("sequential", n, n, random);
+        if (work.distribution != "sequential") {
+            std::shuffle(work.insert_order.begin(), work.insert_order.end(), random);
+        }
+        work.accesses = draws(work.distribution, n, n, random);
+
+        run<open_addressing::HashTable<Key>>("open_addressing", work);
+        run<separate_chaining::HashTable<Key>>("separate_chaining", work);
+        run<std::unordered_set<Key>>("unordered_set", work);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const std::size_t DEFAULT_KEYS = 1000000;
+    const std::size_t NUMBER_OF_KEYS = argc > 1 ? std::stoul(argv[1]) : DEFAULT_KEYS;
+    std::mt19937_64 random(1);
+
+    std::cout << "table,key,distribution,operation,keys,operations,ns_per_op,result" << std::endl;
+    run_key<int>("int", NUMBER_OF_KEYS, random);
+    run_key<std::string>("string", NUMBER_OF_KEYS, random);
+    run_key<Record>("record", NUMBER_OF_KEYS, random);
+    return 0;
+}